@@ -7,12 +7,33 @@
 #include <SpaceVecAlg/SpaceVecAlg>
 
 #include <ForceColl/Constants.h>
+#include <ForceColl/PolyhedralCone.h>
 
 namespace ForceColl
 {
+struct SurfaceShape;
+struct GraspShape;
+
 /** \brief Friction pyramid. */
 class FrictionPyramid
 {
+public:
+  /** \brief Make shared pointer of friction pyramid interned by the friction coefficient and the number of ridges.
+      \param fricCoeff friction coefficient
+      \param ridgeNum number of ridges of friction pyramid
+
+      The same instance is returned for the same arguments while it is alive, so the returned pyramid is immutable.
+      Entries of destroyed pyramids are removed from the registry. This function is thread-safe.
+   */
+  static std::shared_ptr<const FrictionPyramid> makeShared(double fricCoeff, int ridgeNum = 4);
+
+  /** \brief Whether a friction pyramid can be made with the number of ridges, i.e., it is at least 3.
+
+      The exact unit circle table is used for 3, 4, 6, 8, 12, and 16 ridges, and the trigonometric functions otherwise.
+      \param ridgeNum number of ridges of friction pyramid
+   */
+  static bool isSupportedRidgeNum(int ridgeNum);
+
 public:
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 
@@ -32,6 +53,9 @@ public:
   }
 
 public:
+  //! Friction coefficient
+  double fricCoeff_;
+
   //! Local ridge list
   std::vector<Eigen::Vector3d> localRidgeList_;
 };
@@ -79,6 +103,9 @@ public:
   /** \brief Get type of contact. */
   virtual std::string type() const = 0;
 
+  /** \brief Make a copy of this contact. */
+  virtual std::shared_ptr<Contact> clone() const = 0;
+
   /** \brief Get the number of ridges. */
   inline int ridgeNum() const
   {
@@ -88,6 +115,26 @@ public:
   /** \brief Update graspMat_ and vertexWithRidgeList_ according to the input pose. */
   virtual void updateGlobalVertices(const sva::PTransformd & pose) = 0;
 
+  /** \brief Update friction pyramid and the grasp matrices.
+      \param fricPyramid friction pyramid
+   */
+  virtual void updateFricPyramid(const std::shared_ptr<const FrictionPyramid> & fricPyramid);
+
+  /** \brief Calculate grasp matrix of vertex forces.
+
+      Each vertex has three columns corresponding to the unit forces along the x, y, and z axes of the friction pyramid
+      frame at the vertex. The wrenches are around the world origin as in graspMat_.
+   */
+  virtual Eigen::Matrix<double, 6, Eigen::Dynamic> calcVertexForceGraspMat() const;
+
+  /** \brief Calculate friction usage.
+      \param wrenchRatio wrench ratio of each ridge
+      \returns maximum ratio of the tangential force to the normal force times friction coefficient over the vertices
+
+      The friction usage is 1 on the friction cone and 0 for the force in the normal direction.
+   */
+  double calcFricUsage(const Eigen::VectorXd & wrenchRatio) const;
+
   /** \brief Calculate wrench.
       \param wrenchRatio wrench ratio of each ridge
       \param momentOrigin moment origin
@@ -102,6 +149,32 @@ public:
    */
   sva::ForceVecd calcLocalWrench(const Eigen::VectorXd & wrenchRatio) const;
 
+  /** \brief Get contact wrench cone in local frame.
+
+      The cone is the H-representation of the cone spanned by the columns of localGraspMat_. It is computed on the first
+      call after the local vertices are updated.
+   */
+  const PolyhedralCone & localWrenchCone() const;
+
+  /** \brief Get contact wrench cone in global frame.
+
+      The cone is obtained by transforming localWrenchCone() with pose_.
+   */
+  const PolyhedralCone & wrenchCone() const;
+
+  /** \brief Get the revision of localGraspMat_.
+
+      The revision is unique over all contacts and is updated whenever localGraspMat_ is updated by the member
+      functions, so that the users of localGraspMat_ (e.g., WrenchDistribution) can refresh only the changed contacts.
+   */
+  inline size_t localGraspMatRevision() const noexcept
+  {
+    return localGraspMatRevision_;
+  }
+
+  /** \brief Update the revision of localGraspMat_. Call this after modifying localGraspMat_ directly. */
+  void markLocalGraspMatChanged();
+
   /** \brief Add markers to GUI.
       \param gui GUI
       \param category category of GUI entries
@@ -126,13 +199,32 @@ public:
   Eigen::Matrix<double, 6, Eigen::Dynamic> localGraspMat_;
 
   //! Friction pyramid
-  std::shared_ptr<FrictionPyramid> fricPyramid_;
+  std::shared_ptr<const FrictionPyramid> fricPyramid_;
 
   //! List of global vertex with ridges
   std::vector<VertexWithRidge> vertexWithRidgeList_;
 
   //! Maximum wrench in local frame that can be accepted by this contact
   std::optional<sva::ForceVecd> maxWrench_;
+
+  //! Pose of contact
+  sva::PTransformd pose_ = sva::PTransformd::Identity();
+
+protected:
+  /** \brief Clear the cache of contact wrench cones.
+      \param local whether to clear the cone in local frame in addition to the cone in global frame
+   */
+  void clearWrenchCone(bool local);
+
+protected:
+  //! Cache of contact wrench cone in local frame
+  mutable std::optional<PolyhedralCone> localWrenchCone_;
+
+  //! Cache of contact wrench cone in global frame
+  mutable std::optional<PolyhedralCone> wrenchCone_;
+
+  //! Revision of localGraspMat_
+  size_t localGraspMatRevision_ = 0;
 };
 
 /** \brief Empty contact. */
@@ -157,6 +249,12 @@ public:
     return "Empty";
   }
 
+  /** \brief Make a copy of this contact. */
+  inline virtual std::shared_ptr<Contact> clone() const override
+  {
+    return std::make_shared<EmptyContact>(*this);
+  }
+
   /** \brief Update graspMat_ and vertexWithRidgeList_ according to the input pose.
 
       Do nothing because EmptyContact does not have any vertices.
@@ -170,6 +268,8 @@ class SurfaceContact : public Contact
 public:
   /** \brief Load map of surface vertices in local coordinates
       \param mcRtcConfig mc_rtc configuration
+
+      verticesMap is not thread-safe. Use ShapeRegistry to construct contacts concurrently with loading.
   */
   static void loadVerticesMap(const mc_rtc::Configuration & mcRtcConfig);
 
@@ -179,6 +279,13 @@ public:
   //! List of local verticies
   std::vector<Eigen::Vector3d> localVertices_;
 
+  /** \brief Tolerance of vertex pruning (no pruning if std::nullopt)
+
+      If set, updateLocalVertices() reduces the input vertices to the minimal support polygon by
+      calcSupportPolygonVertices() with this tolerance before building localGraspMat_.
+  */
+  std::optional<double> vertexPruningTolerance_ = std::nullopt;
+
 public:
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 
@@ -200,18 +307,59 @@ public:
   */
   SurfaceContact(const mc_rtc::Configuration & mcRtcConfig);
 
+  /** \brief Constructor.
+      \param name name of contact
+      \param shape surface shape in ShapeRegistry
+      \param pose pose of contact
+      \param maxWrench maximum wrench in local frame (absolute value) that can be accepted by this contact
+
+      The local vertices and the local grasp matrix are copied from the shape without recomputation. They are copied
+      rather than shared because the contact owns them as plain members that updateLocalVertices() and
+      updateLocalVerticesInPlace() modify, and the solvers read them without indirection. The copy is a plain memory
+      copy of the 6 x (number of ridges of all vertices) matrix, which is negligible compared to computing it.
+   */
+  SurfaceContact(const std::string & name,
+                 const std::shared_ptr<const SurfaceShape> & shape,
+                 const sva::PTransformd & pose,
+                 std::optional<sva::ForceVecd> maxWrench = std::nullopt);
+
   /** \brief Get type of contact. */
   inline virtual std::string type() const override
   {
     return "Surface";
   }
 
+  /** \brief Make a copy of this contact. */
+  inline virtual std::shared_ptr<Contact> clone() const override
+  {
+    return std::make_shared<SurfaceContact>(*this);
+  }
+
   /** \brief Update localVertices_ and localGraspMat_ according to the input pose. */
   void updateLocalVertices(const std::vector<Eigen::Vector3d> & localVertices);
 
+  /** \brief Update localVertices_ and localGraspMat_ in place for the vertices of the same number.
+      \param localVertices surface vertices in local coordinates
+      \returns whether localGraspMat_ is changed
+
+      Only the columns of localGraspMat_ corresponding to the changed vertices are recomputed without reallocation, and
+      localGraspMatRevision() is updated only if any vertex is changed. This is intended for the contact region updated
+      in every control cycle (e.g., by tactile sensing). If vertexPruningTolerance_ is set or the number of vertices is
+      changed, this is the same as updateLocalVertices(). Call updateGlobalVertices() afterwards to update graspMat_.
+   */
+  bool updateLocalVerticesInPlace(const std::vector<Eigen::Vector3d> & localVertices);
+
   /** \brief Update graspMat_ and vertexWithRidgeList_ according to the input pose. */
   virtual void updateGlobalVertices(const sva::PTransformd & pose) override;
 
+  /** \brief Update friction pyramid, localGraspMat_, and graspMat_.
+      \param fricPyramid friction pyramid
+   */
+  virtual void updateFricPyramid(const std::shared_ptr<const FrictionPyramid> & fricPyramid) override;
+
+  /** \brief Calculate grasp matrix of vertex forces. */
+  virtual Eigen::Matrix<double, 6, Eigen::Dynamic> calcVertexForceGraspMat() const override;
+
   /** \brief Add markers to GUI.
       \param gui GUI
       \param category category of GUI entries
@@ -224,6 +372,12 @@ public:
                         double forceScale = constants::defaultForceScale,
                         double fricPyramidScale = constants::defaultFricPyramidScale,
                         const Eigen::VectorXd & wrenchRatio = Eigen::VectorXd::Zero(0)) override;
+
+protected:
+  /** \brief Update the columns of localGraspMat_ corresponding to a vertex.
+      \param vertexIdx index of vertex in localVertices_
+   */
+  void updateLocalGraspMatCols(size_t vertexIdx);
 };
 
 /** \brief Grasp contact. */
@@ -232,6 +386,8 @@ class GraspContact : public Contact
 public:
   /** \brief Load map of grasp vertices in local coordinates
       \param mcRtcConfig mc_rtc configuration
+
+      verticesMap is not thread-safe. Use ShapeRegistry to construct contacts concurrently with loading.
   */
   static void loadVerticesMap(const mc_rtc::Configuration & mcRtcConfig);
 
@@ -262,18 +418,58 @@ public:
   */
   GraspContact(const mc_rtc::Configuration & mcRtcConfig);
 
+  /** \brief Constructor.
+      \param name name of contact
+      \param shape grasp shape in ShapeRegistry
+      \param pose pose of contact
+      \param maxWrench maximum wrench in local frame (absolute value) that can be accepted by this contact
+
+      The local vertices and the local grasp matrix are copied from the shape without recomputation. They are copied
+      rather than shared because the contact owns them as plain members that updateLocalVertices() and
+      updateLocalVerticesInPlace() modify, and the solvers read them without indirection. The copy is a plain memory
+      copy of the 6 x (number of ridges of all vertices) matrix, which is negligible compared to computing it.
+   */
+  GraspContact(const std::string & name,
+               const std::shared_ptr<const GraspShape> & shape,
+               const sva::PTransformd & pose,
+               std::optional<sva::ForceVecd> maxWrench = std::nullopt);
+
   /** \brief Get type of contact. */
   inline virtual std::string type() const override
   {
     return "Grasp";
   }
 
+  /** \brief Make a copy of this contact. */
+  inline virtual std::shared_ptr<Contact> clone() const override
+  {
+    return std::make_shared<GraspContact>(*this);
+  }
+
   /** \brief Update localVertices_ and localGraspMat_ according to the input pose. */
   void updateLocalVertices(const std::vector<sva::PTransformd> & localVertices);
 
+  /** \brief Update localVertices_ and localGraspMat_ in place for the vertices of the same number.
+      \param localVertices grasp vertices in local coordinates
+      \returns whether localGraspMat_ is changed
+
+      Only the columns of localGraspMat_ corresponding to the changed vertices are recomputed without reallocation, and
+      localGraspMatRevision() is updated only if any vertex is changed. If the number of vertices is changed, this is
+      the same as updateLocalVertices(). Call updateGlobalVertices() afterwards to update graspMat_.
+   */
+  bool updateLocalVerticesInPlace(const std::vector<sva::PTransformd> & localVertices);
+
   /** \brief Update graspMat_ and vertexWithRidgeList_ according to the input pose. */
   virtual void updateGlobalVertices(const sva::PTransformd & pose) override;
 
+  /** \brief Update friction pyramid, localGraspMat_, and graspMat_.
+      \param fricPyramid friction pyramid
+   */
+  virtual void updateFricPyramid(const std::shared_ptr<const FrictionPyramid> & fricPyramid) override;
+
+  /** \brief Calculate grasp matrix of vertex forces. */
+  virtual Eigen::Matrix<double, 6, Eigen::Dynamic> calcVertexForceGraspMat() const override;
+
   /** \brief Add markers to GUI.
       \param gui GUI
       \param category category of GUI entries
@@ -286,6 +482,12 @@ public:
                         double forceScale = constants::defaultForceScale,
                         double fricPyramidScale = constants::defaultFricPyramidScale,
                         const Eigen::VectorXd & wrenchRatio = Eigen::VectorXd::Zero(0)) override;
+
+protected:
+  /** \brief Update the columns of localGraspMat_ corresponding to a vertex.
+      \param vertexIdx index of vertex in localVertices_
+   */
+  void updateLocalGraspMatCols(size_t vertexIdx);
 };
 
 /** \brief Calculate total wrench.
@@ -316,6 +518,18 @@ std::vector<sva::ForceVecd> calcWrenchList(const std::vector<std::shared_ptr<Con
 std::vector<sva::ForceVecd> calcLocalWrenchList(const std::vector<std::shared_ptr<Contact>> & contactList,
                                                 const Eigen::VectorXd & wrenchRatio);
 
+/** \brief Calculate the minimal support polygon of surface vertices.
+    \param localVertices surface vertices in local coordinates
+    \param simplifyTolerance vertices closer than this to the segment between their neighbors are removed
+    \returns vertices of the convex support polygon in counterclockwise order
+
+    Among the vertices with the same z coordinate, those in the interior or on the edges of the convex hull are removed
+    because the contact wrench cone is unchanged without them. Removing a vertex by the simplification shrinks the
+    polygon, so the simplified contact wrench cone is an inner approximation.
+*/
+std::vector<Eigen::Vector3d> calcSupportPolygonVertices(const std::vector<Eigen::Vector3d> & localVertices,
+                                                        double simplifyTolerance = 0.0);
+
 /** \brief Calculate contact wrench list.
     \tparam MapType type of map container
     \tparam KeyType key type
@@ -0,0 +1,131 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include <SpaceVecAlg/SpaceVecAlg>
+
+namespace ForceColl
+{
+class Contact;
+
+/** \brief Contact geometry and wrench evaluation templated on the scalar type.
+
+    \tparam Scalar scalar type (double by default, float for batch evaluation in single precision)
+
+    The grasp matrices of multiple contacts are concatenated in one matrix, whose columns are [moment; force] of the
+    unit forces along the ridges as Contact::graspMat_. Only the local grasp matrices are taken from the contacts, so
+    the stances can be evaluated by updateGlobalVertices() and calcTotalWrench() without modifying the contacts. The
+    static functions are the kernels used also by Contact with Scalar = double.
+
+    \code{.cpp}
+    ContactGeometry<float> contactGeom(contactList);
+    contactGeom.updateGlobalVertices(poseList); // std::vector<sva::PTransform<float>>
+    Eigen::Matrix<float, 6, 1> totalWrench = contactGeom.calcTotalWrench(wrenchRatio);
+    \endcode
+ */
+template<class Scalar = double>
+class ContactGeometry
+{
+public:
+  //! 3D vector
+  using Vector3 = Eigen::Matrix<Scalar, 3, 1>;
+
+  //! 6D vector
+  using Vector6 = Eigen::Matrix<Scalar, 6, 1>;
+
+  //! Dynamic size vector
+  using VectorX = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+
+  //! Grasp matrix
+  using Matrix6X = Eigen::Matrix<Scalar, 6, Eigen::Dynamic>;
+
+  //! Pose
+  using PTransform = sva::PTransform<Scalar>;
+
+public:
+  /** \brief Transform grasp matrix from local frame to global frame.
+      \param localGraspMat grasp matrix in local frame
+      \param pose pose of local frame
+      \param graspMat grasp matrix in global frame (output, must have the same size as localGraspMat)
+   */
+  static void transformGraspMat(const Eigen::Ref<const Matrix6X> & localGraspMat,
+                                const PTransform & pose,
+                                Eigen::Ref<Matrix6X> graspMat);
+
+  /** \brief Shift the moment origin of grasp matrix in place.
+      \param graspMat grasp matrix around the world origin (input) and around momentOrigin (output)
+      \param momentOrigin moment origin
+   */
+  static void shiftMomentOrigin(Eigen::Ref<Matrix6X> graspMat, const Vector3 & momentOrigin);
+
+  /** \brief Calculate wrench.
+      \param graspMat grasp matrix around the world origin
+      \param wrenchRatio wrench ratio of each ridge
+      \param momentOrigin moment origin
+      \returns wrench [moment; force]
+   */
+  static Vector6 calcWrench(const Eigen::Ref<const Matrix6X> & graspMat,
+                            const Eigen::Ref<const VectorX> & wrenchRatio,
+                            const Vector3 & momentOrigin = Vector3::Zero());
+
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  /** \brief Constructor.
+      \param contactList list of contact constraint
+
+      The local grasp matrices are copied from the contacts and the global grasp matrices are initialized with the
+      current poses of the contacts.
+   */
+  ContactGeometry(const std::vector<std::shared_ptr<Contact>> & contactList);
+
+  /** \brief Get the number of contacts. */
+  inline size_t contactNum() const
+  {
+    return ridgeIdxList_.size() - 1;
+  }
+
+  /** \brief Get the number of ridges of all contacts. */
+  inline int ridgeNum() const
+  {
+    return static_cast<int>(graspMat_.cols());
+  }
+
+  /** \brief Update graspMat_ according to the input poses.
+      \param poseList list of contact poses (same size as the contact list)
+   */
+  void updateGlobalVertices(const std::vector<PTransform> & poseList);
+
+  /** \brief Calculate total wrench.
+      \param wrenchRatio wrench ratio of all contacts
+      \param momentOrigin moment origin
+      \returns total wrench [moment; force]
+   */
+  Vector6 calcTotalWrench(const Eigen::Ref<const VectorX> & wrenchRatio,
+                          const Vector3 & momentOrigin = Vector3::Zero()) const;
+
+  /** \brief Calculate contact wrench list.
+      \param wrenchRatio wrench ratio of all contacts
+      \param momentOrigin moment origin
+      \returns list of contact wrench [moment; force]
+   */
+  std::vector<Vector6> calcWrenchList(const Eigen::Ref<const VectorX> & wrenchRatio,
+                                      const Vector3 & momentOrigin = Vector3::Zero()) const;
+
+public:
+  //! Local grasp matrices of all contacts
+  Matrix6X localGraspMat_;
+
+  //! Grasp matrices of all contacts around the world origin
+  Matrix6X graspMat_;
+
+  //! Start column of each contact in the grasp matrices (the last element is the number of ridges)
+  std::vector<Eigen::DenseIndex> ridgeIdxList_;
+};
+
+extern template class ContactGeometry<double>;
+extern template class ContactGeometry<float>;
+} // namespace ForceColl
+
+#include <ForceColl/ContactGeometry.hpp>
@@ -0,0 +1,101 @@
+#include <mc_rtc/logging.h>
+
+#include <ForceColl/Contact.h>
+
+namespace ForceColl
+{
+template<class Scalar>
+void ContactGeometry<Scalar>::transformGraspMat(const Eigen::Ref<const Matrix6X> & localGraspMat,
+                                                const PTransform & pose,
+                                                Eigen::Ref<Matrix6X> graspMat)
+{
+  // The force is rotated and the moment is rotated and shifted by the position of the local frame
+  Eigen::Matrix<Scalar, 3, 3> rot = pose.rotation().transpose();
+  graspMat.template bottomRows<3>().noalias() = rot * localGraspMat.template bottomRows<3>();
+  graspMat.template topRows<3>().noalias() = rot * localGraspMat.template topRows<3>();
+  graspMat.template topRows<3>().noalias() +=
+      sva::vector3ToCrossMatrix<Scalar>(pose.translation()) * graspMat.template bottomRows<3>();
+}
+
+template<class Scalar>
+void ContactGeometry<Scalar>::shiftMomentOrigin(Eigen::Ref<Matrix6X> graspMat, const Vector3 & momentOrigin)
+{
+  graspMat.template topRows<3>().noalias() -=
+      sva::vector3ToCrossMatrix<Scalar>(momentOrigin) * graspMat.template bottomRows<3>();
+}
+
+template<class Scalar>
+typename ContactGeometry<Scalar>::Vector6 ContactGeometry<Scalar>::calcWrench(
+    const Eigen::Ref<const Matrix6X> & graspMat,
+    const Eigen::Ref<const VectorX> & wrenchRatio,
+    const Vector3 & momentOrigin)
+{
+  assert(wrenchRatio.size() == graspMat.cols());
+  Vector6 wrench = graspMat * wrenchRatio;
+  wrench.template head<3>() -= momentOrigin.cross(wrench.template tail<3>());
+  return wrench;
+}
+
+template<class Scalar>
+ContactGeometry<Scalar>::ContactGeometry(const std::vector<std::shared_ptr<Contact>> & contactList)
+{
+  ridgeIdxList_.push_back(0);
+  for(const auto & contact : contactList)
+  {
+    ridgeIdxList_.push_back(ridgeIdxList_.back() + contact->localGraspMat_.cols());
+  }
+
+  localGraspMat_.resize(6, ridgeIdxList_.back());
+  graspMat_.resize(6, ridgeIdxList_.back());
+  for(size_t contactIdx = 0; contactIdx < contactList.size(); contactIdx++)
+  {
+    const auto & contact = contactList[contactIdx];
+    auto cols = ridgeIdxList_[contactIdx + 1] - ridgeIdxList_[contactIdx];
+    localGraspMat_.middleCols(ridgeIdxList_[contactIdx], cols) = contact->localGraspMat_.template cast<Scalar>();
+    transformGraspMat(localGraspMat_.middleCols(ridgeIdxList_[contactIdx], cols),
+                      contact->pose_.template cast<Scalar>(), graspMat_.middleCols(ridgeIdxList_[contactIdx], cols));
+  }
+}
+
+template<class Scalar>
+void ContactGeometry<Scalar>::updateGlobalVertices(const std::vector<PTransform> & poseList)
+{
+  if(poseList.size() != contactNum())
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>(
+        "[ContactGeometry::updateGlobalVertices] Size of poseList must be {} but is {}.", contactNum(),
+        poseList.size());
+  }
+
+  for(size_t contactIdx = 0; contactIdx < poseList.size(); contactIdx++)
+  {
+    auto cols = ridgeIdxList_[contactIdx + 1] - ridgeIdxList_[contactIdx];
+    transformGraspMat(localGraspMat_.middleCols(ridgeIdxList_[contactIdx], cols), poseList[contactIdx],
+                      graspMat_.middleCols(ridgeIdxList_[contactIdx], cols));
+  }
+}
+
+template<class Scalar>
+typename ContactGeometry<Scalar>::Vector6 ContactGeometry<Scalar>::calcTotalWrench(
+    const Eigen::Ref<const VectorX> & wrenchRatio,
+    const Vector3 & momentOrigin) const
+{
+  return calcWrench(graspMat_, wrenchRatio, momentOrigin);
+}
+
+template<class Scalar>
+std::vector<typename ContactGeometry<Scalar>::Vector6> ContactGeometry<Scalar>::calcWrenchList(
+    const Eigen::Ref<const VectorX> & wrenchRatio,
+    const Vector3 & momentOrigin) const
+{
+  std::vector<Vector6> wrenchList;
+  wrenchList.reserve(contactNum());
+  for(size_t contactIdx = 0; contactIdx < contactNum(); contactIdx++)
+  {
+    auto cols = ridgeIdxList_[contactIdx + 1] - ridgeIdxList_[contactIdx];
+    wrenchList.push_back(calcWrench(graspMat_.middleCols(ridgeIdxList_[contactIdx], cols),
+                                    wrenchRatio.segment(ridgeIdxList_[contactIdx], cols), momentOrigin));
+  }
+  return wrenchList;
+}
+} // namespace ForceColl
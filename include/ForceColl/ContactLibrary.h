@@ -0,0 +1,270 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <ForceColl/Contact.h>
+
+namespace ForceColl
+{
+/** \brief Contact library in a compact binary format that is memory-mapped on loading.
+
+    The library stores the surface vertices map, the grasp vertices map, and the contact definitions. The file is
+    mapped into memory as is, so that loading is almost instant and the vertices are accessed without copying. The
+    binary file is made from the mc_rtc configuration by convertFromConfig() (or the ConvertContactLibrary executable).
+
+    The mc_rtc configuration to be converted has the following entries, all of which are optional:
+      - surfaceVerticesMap: same format as the argument of SurfaceContact::loadVerticesMap()
+      - graspVerticesMap: same format as the argument of GraspContact::loadVerticesMap()
+      - contactList: list of the arguments of Contact::makeSharedFromConfig()
+
+    The file is in the native byte order and is not portable between machines with different byte orders.
+ */
+class ContactLibrary
+{
+public:
+  /** \brief Type of contact in the binary format. */
+  enum class ContactType : std::uint32_t
+  {
+    Empty = 0,
+    Surface,
+    Grasp
+  };
+
+  /** \brief File header. */
+  struct Header
+  {
+    //! Magic string
+    char magic[8];
+
+    //! Format version
+    std::uint32_t version;
+
+    //! Value to check the byte order
+    std::uint32_t byteOrderMark;
+
+    //! Number of entries in surface vertices map
+    std::uint64_t surfaceVerticesNum;
+
+    //! Number of entries in grasp vertices map
+    std::uint64_t graspVerticesNum;
+
+    //! Number of contacts
+    std::uint64_t contactNum;
+
+    //! Byte offset of surface vertices table
+    std::uint64_t surfaceVerticesTableOffset;
+
+    //! Byte offset of grasp vertices table
+    std::uint64_t graspVerticesTableOffset;
+
+    //! Byte offset of contact table
+    std::uint64_t contactTableOffset;
+
+    //! Byte offset of string pool
+    std::uint64_t stringPoolOffset;
+
+    //! Byte size of string pool
+    std::uint64_t stringPoolSize;
+
+    //! Byte size of file
+    std::uint64_t fileSize;
+  };
+
+  /** \brief Entry of vertices map.
+
+      Entries are sorted by name. The data of surface vertices is three doubles (position) per vertex. The data of
+      grasp vertices is twelve doubles (column-major rotation matrix followed by translation) per vertex.
+   */
+  struct VerticesEntry
+  {
+    //! Offset of name in string pool
+    std::uint64_t nameOffset;
+
+    //! Length of name
+    std::uint64_t nameSize;
+
+    //! Byte offset of vertex data
+    std::uint64_t dataOffset;
+
+    //! Number of vertices
+    std::uint64_t vertexNum;
+  };
+
+  /** \brief Entry of contact definition. */
+  struct ContactEntry
+  {
+    //! Offset of name in string pool
+    std::uint64_t nameOffset;
+
+    //! Length of name
+    std::uint64_t nameSize;
+
+    //! Type of contact
+    ContactType type;
+
+    //! Index of entry in the vertices map of the contact type
+    std::uint32_t verticesIdx;
+
+    //! Whether maxWrench is valid
+    std::uint32_t hasMaxWrench;
+
+    //! Whether vertexPruningTolerance is valid
+    std::uint32_t hasVertexPruningTolerance;
+
+    //! Friction coefficient
+    double fricCoeff;
+
+    //! Pose (column-major rotation matrix followed by translation)
+    double pose[12];
+
+    //! Maximum wrench in local frame (moment followed by force)
+    double maxWrench[6];
+
+    //! Tolerance of vertex pruning
+    double vertexPruningTolerance;
+  };
+
+  //! Magic string of file
+  static constexpr char magic[8] = "FCCLIB1";
+
+  //! Format version
+  static constexpr std::uint32_t version = 1;
+
+  /** \brief Convert mc_rtc configuration to binary contact library file.
+      \param mcRtcConfig mc_rtc configuration
+      \param path path of output file
+   */
+  static void convertFromConfig(const mc_rtc::Configuration & mcRtcConfig, const std::string & path);
+
+public:
+  /** \brief Constructor.
+      \param path path of binary contact library file
+   */
+  ContactLibrary(const std::string & path);
+
+  ContactLibrary(const ContactLibrary &) = delete;
+  ContactLibrary & operator=(const ContactLibrary &) = delete;
+
+  /** \brief Destructor. */
+  ~ContactLibrary();
+
+  /** \brief Get the number of entries in surface vertices map. */
+  inline size_t surfaceVerticesNum() const
+  {
+    return static_cast<size_t>(header().surfaceVerticesNum);
+  }
+
+  /** \brief Get the number of entries in grasp vertices map. */
+  inline size_t graspVerticesNum() const
+  {
+    return static_cast<size_t>(header().graspVerticesNum);
+  }
+
+  /** \brief Get the number of contacts. */
+  inline size_t contactNum() const
+  {
+    return static_cast<size_t>(header().contactNum);
+  }
+
+  /** \brief Get name of surface vertices.
+      \param idx index of entry
+   */
+  std::string_view surfaceVerticesName(size_t idx) const;
+
+  /** \brief Get surface vertices without copy.
+      \param idx index of entry
+      \returns matrix whose columns are the vertices in local coordinates
+   */
+  Eigen::Map<const Eigen::Matrix3Xd> surfaceVertices(size_t idx) const;
+
+  /** \brief Get name of grasp vertices.
+      \param idx index of entry
+   */
+  std::string_view graspVerticesName(size_t idx) const;
+
+  /** \brief Get grasp vertices.
+      \param idx index of entry
+   */
+  std::vector<sva::PTransformd> graspVertices(size_t idx) const;
+
+  /** \brief Find index of surface vertices by name (binary search).
+      \param name name of surface vertices
+      \returns index of entry (-1 if not found)
+   */
+  int findSurfaceVertices(std::string_view name) const;
+
+  /** \brief Find index of grasp vertices by name (binary search).
+      \param name name of grasp vertices
+      \returns index of entry (-1 if not found)
+   */
+  int findGraspVertices(std::string_view name) const;
+
+  /** \brief Get name of contact.
+      \param idx index of contact
+   */
+  std::string_view contactName(size_t idx) const;
+
+  /** \brief Make contact.
+      \param idx index of contact
+   */
+  std::shared_ptr<Contact> makeSharedContact(size_t idx) const;
+
+  /** \brief Make all contacts in the library. */
+  std::vector<std::shared_ptr<Contact>> makeSharedContactList() const;
+
+  /** \brief Insert vertices into SurfaceContact::verticesMap and GraspContact::verticesMap.
+
+      This is for compatibility with the constructors from mc_rtc configuration.
+   */
+  void loadVerticesMaps() const;
+
+protected:
+  /** \brief Get header. */
+  inline const Header & header() const
+  {
+    return *reinterpret_cast<const Header *>(data_);
+  }
+
+  /** \brief Get vertices entry.
+      \param tableOffset byte offset of table
+      \param tableSize number of entries in table
+      \param idx index of entry
+   */
+  const VerticesEntry & verticesEntry(std::uint64_t tableOffset, std::uint64_t tableSize, size_t idx) const;
+
+  /** \brief Get contact entry.
+      \param idx index of contact
+   */
+  const ContactEntry & contactEntry(size_t idx) const;
+
+  /** \brief Get string in string pool.
+      \param offset offset in string pool
+      \param size length of string
+   */
+  std::string_view poolString(std::uint64_t offset, std::uint64_t size) const;
+
+  /** \brief Find index of vertices by name.
+      \param tableOffset byte offset of table
+      \param tableSize number of entries in table
+      \param name name of vertices
+   */
+  int findVertices(std::uint64_t tableOffset, std::uint64_t tableSize, std::string_view name) const;
+
+  /** \brief Validate the mapped data. */
+  void validate() const;
+
+protected:
+  //! Path of file
+  std::string path_;
+
+  //! Mapped data
+  const std::uint8_t * data_ = nullptr;
+
+  //! Byte size of mapped data
+  size_t size_ = 0;
+};
+} // namespace ForceColl
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <variant>
+
+#include <ForceColl/Contact.h>
+
+namespace ForceColl
+{
+//! Contact stored by value
+using ContactVariant = std::variant<EmptyContact, SurfaceContact, GraspContact>;
+
+/** \brief Set of contacts stored contiguously by value.
+
+    The contacts are held in one array of ContactVariant, and the batch update and evaluation dispatch on the variant
+    index with std::visit instead of the virtual functions, so the hot loops neither chase pointers nor call virtual
+    functions. The contacts can also be accessed through the existing shared pointer API by contactPtrList(), whose
+    pointers refer to the contiguous elements and keep the storage alive.
+
+    The number and types of contacts are fixed after construction. Copying the set deep-copies the contacts, so the
+    pointers of contactPtrList() of a copy refer to its own contacts.
+ */
+class ContactSet
+{
+public:
+  /** \brief Type of contact (same order as the alternatives of ContactVariant). */
+  enum class Type
+  {
+    //! EmptyContact
+    Empty = 0,
+
+    //! SurfaceContact
+    Surface,
+
+    //! GraspContact
+    Grasp
+  };
+
+public:
+  /** \brief Constructor.
+      \param contactList list of contacts
+   */
+  ContactSet(std::vector<ContactVariant> contactList);
+
+  /** \brief Constructor.
+      \param contactList list of contact constraint (copied)
+
+      Throw if a contact is not EmptyContact, SurfaceContact, or GraspContact.
+   */
+  ContactSet(const std::vector<std::shared_ptr<Contact>> & contactList);
+
+  /** \brief Copy constructor.
+      \param other contact set to copy
+
+      The contacts are deep-copied, so that the copy and other do not share the contacts.
+   */
+  ContactSet(const ContactSet & other);
+
+  /** \brief Move constructor. */
+  ContactSet(ContactSet && other) = default;
+
+  /** \brief Copy assignment operator (deep copy of the contacts). */
+  ContactSet & operator=(const ContactSet & other);
+
+  /** \brief Move assignment operator. */
+  ContactSet & operator=(ContactSet && other) = default;
+
+  /** \brief Get the number of contacts. */
+  inline size_t size() const noexcept
+  {
+    return contactList_->size();
+  }
+
+  /** \brief Get the number of ridges of all contacts. */
+  int ridgeNum() const;
+
+  /** \brief Get type of contact.
+      \param contactIdx index of contact
+   */
+  inline Type type(size_t contactIdx) const
+  {
+    return static_cast<Type>((*contactList_)[contactIdx].index());
+  }
+
+  /** \brief Access contact as the base class.
+      \param contactIdx index of contact
+   */
+  const Contact & contact(size_t contactIdx) const;
+
+  /** \brief Access contact as the base class.
+      \param contactIdx index of contact
+   */
+  Contact & contact(size_t contactIdx);
+
+  /** \brief Get contiguous list of contacts. */
+  inline const std::vector<ContactVariant> & contactList() const noexcept
+  {
+    return *contactList_;
+  }
+
+  /** \brief Get list of shared pointers to the contacts.
+
+      The pointers refer to the elements of contactList() (not copies), so that the contacts updated by
+      updateGlobalVertices() can be passed to WrenchDistribution and the other functions taking the shared pointers.
+   */
+  inline const std::vector<std::shared_ptr<Contact>> & contactPtrList() const noexcept
+  {
+    return contactPtrList_;
+  }
+
+  /** \brief Update the global vertices of all contacts.
+      \param poseList list of contact poses (same size as the contacts)
+   */
+  void updateGlobalVertices(const std::vector<sva::PTransformd> & poseList);
+
+  /** \brief Calculate total wrench.
+      \param wrenchRatio wrench ratio of all contacts
+      \param momentOrigin moment origin
+      \returns total wrench
+   */
+  sva::ForceVecd calcTotalWrench(const Eigen::VectorXd & wrenchRatio,
+                                 const Eigen::Vector3d & momentOrigin = Eigen::Vector3d::Zero()) const;
+
+  /** \brief Calculate contact wrench list.
+      \param wrenchRatio wrench ratio of all contacts
+      \param momentOrigin moment origin
+      \returns contact wrench list
+   */
+  std::vector<sva::ForceVecd> calcWrenchList(const Eigen::VectorXd & wrenchRatio,
+                                             const Eigen::Vector3d & momentOrigin = Eigen::Vector3d::Zero()) const;
+
+  /** \brief Calculate total grasp matrix.
+      \param momentOrigin moment origin
+      \returns grasp matrices of all contacts concatenated horizontally
+   */
+  Eigen::Matrix<double, 6, Eigen::Dynamic> calcTotalGraspMat(
+      const Eigen::Vector3d & momentOrigin = Eigen::Vector3d::Zero()) const;
+
+protected:
+  /** \brief Make contactPtrList_ referring to the elements of contactList_. */
+  void makeContactPtrList();
+
+protected:
+  //! Contiguous list of contacts (shared with the pointers in contactPtrList_)
+  std::shared_ptr<std::vector<ContactVariant>> contactList_;
+
+  //! List of shared pointers to the elements of contactList_
+  std::vector<std::shared_ptr<Contact>> contactPtrList_;
+};
+} // namespace ForceColl
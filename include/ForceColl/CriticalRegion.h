@@ -0,0 +1,69 @@
+#pragma once
+
+#include <qp_solver_collection/QpSolverCollection.h>
+
+#include <optional>
+#include <vector>
+
+namespace ForceColl
+{
+/** \brief Critical region of parametric QP.
+
+    Consider the QP whose objective linear vector is \f$\boldsymbol{P} \boldsymbol{\theta}\f$ for the parameter
+    \f$\boldsymbol{\theta}\f$ and whose other coefficients are fixed. Within the critical region, i.e., the
+    polyhedral set of parameters for which the active set of the optimal solution does not change, the optimal solution
+    is an affine function of the parameter.
+
+    See A. Bemporad et al. The explicit linear quadratic regulator for constrained systems. Automatica, 2002.
+ */
+class CriticalRegion
+{
+public:
+  /** \brief Make critical region from the optimal solution of QP.
+      \param qpCoeff QP coefficients
+      \param objParamMat matrix \f$\boldsymbol{P}\f$ mapping the parameter to the objective linear vector
+      \param solution solution of QP from which the active set is identified
+      \param param parameter for which the QP is solved
+      \param eps tolerance of the active constraint judgement
+      \returns critical region (std::nullopt if the region cannot be constructed from the active set)
+
+      The constraints are indexed in the order of the inequality constraints, the lower bounds, and the upper bounds.
+   */
+  static std::optional<CriticalRegion> makeFromSolution(const QpSolverCollection::QpCoeff & qpCoeff,
+                                                        const Eigen::MatrixXd & objParamMat,
+                                                        const Eigen::VectorXd & solution,
+                                                        const Eigen::VectorXd & param,
+                                                        double eps = 1e-6);
+
+public:
+  /** \brief Whether the parameter is in the region.
+      \param param parameter
+      \param eps tolerance
+   */
+  bool contains(const Eigen::VectorXd & param, double eps = 1e-6) const;
+
+  /** \brief Calculate the optimal solution.
+      \param param parameter in the region
+   */
+  inline Eigen::VectorXd calcSolution(const Eigen::VectorXd & param) const
+  {
+    return gainMat_ * param + offsetVec_;
+  }
+
+public:
+  //! Indices of active inequality constraints
+  std::vector<int> activeIdxs_;
+
+  //! Gain matrix of the affine solution
+  Eigen::MatrixXd gainMat_;
+
+  //! Offset vector of the affine solution
+  Eigen::VectorXd offsetVec_;
+
+  //! Inequality matrix of the region (each row is a unit vector)
+  Eigen::MatrixXd ineqMat_;
+
+  //! Inequality vector of the region
+  Eigen::VectorXd ineqVec_;
+};
+} // namespace ForceColl
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <ForceColl/WorkerThreads.h>
+#include <ForceColl/WrenchDistribution.h>
+
+#include <memory>
+
+namespace ForceColl
+{
+/** \brief Wrench distribution of multiple bodies with independent contacts.
+
+    The wrench distribution QP of each body is solved by its own WrenchDistribution instance, and the instances are
+    run concurrently by multiple threads instead of solving one larger QP of all the contacts. Each instance is run by
+    only one thread at a time, so the instances keep their internal states (e.g., critical regions) across run(). The
+    worker threads are created in the constructor and reused in every run().
+ */
+class MultiBodyWrenchDistribution
+{
+public:
+  /** \brief Result of multi-body wrench distribution. */
+  struct Result
+  {
+    //! Total wrench of distributed result wrenches of each body
+    std::vector<sva::ForceVecd> resultTotalWrenchList;
+
+    //! Result wrench ratio of each body
+    std::vector<Eigen::VectorXd> resultWrenchRatioList;
+
+    //! Result contact wrenches of each body (moment around the moment origin of the body)
+    std::vector<std::vector<sva::ForceVecd>> resultWrenchListList;
+  };
+
+public:
+  /** \brief Constructor.
+      \param contactListList list of contact constraints of each body
+      \param mcRtcConfig mc_rtc configuration
+
+      mcRtcConfig is passed to the wrench distribution of each body. In addition to the entries of WrenchDistribution,
+      mcRtcConfig can contain the following entries:
+        - threadNum: number of threads (hardware concurrency if non-positive)
+   */
+  MultiBodyWrenchDistribution(const std::vector<std::vector<std::shared_ptr<Contact>>> & contactListList,
+                              const mc_rtc::Configuration & mcRtcConfig = {});
+
+  /** \brief Get the number of bodies. */
+  inline size_t bodyNum() const noexcept
+  {
+    return wrenchDistList_.size();
+  }
+
+  /** \brief Run wrench distribution of all bodies.
+      \param desiredTotalWrenchList desired total wrench of each body
+      \param momentOriginList moment origin of each body (world origin for all bodies if empty)
+      \returns result of all bodies
+
+      If the wrench distribution of any body throws an exception, the exception is rethrown after all threads finish.
+   */
+  const Result & run(const std::vector<sva::ForceVecd> & desiredTotalWrenchList,
+                     const std::vector<Eigen::Vector3d> & momentOriginList = {});
+
+  /** \brief Const accessor to the result of the last run(). */
+  inline const Result & result() const noexcept
+  {
+    return result_;
+  }
+
+public:
+  //! Wrench distribution of each body
+  std::vector<std::shared_ptr<WrenchDistribution>> wrenchDistList_;
+
+  //! Number of threads (the worker threads are recreated in run() if it is changed)
+  int threadNum_ = 0;
+
+protected:
+  //! Result of the last run()
+  Result result_;
+
+  //! Worker threads
+  std::unique_ptr<WorkerThreads> workerThreads_;
+};
+} // namespace ForceColl
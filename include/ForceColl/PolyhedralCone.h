@@ -0,0 +1,70 @@
+#pragma once
+
+#include <Eigen/Core>
+
+namespace ForceColl
+{
+/** \brief Polyhedral convex cone in H-representation.
+
+    A vector \f$\boldsymbol{x}\f$ belongs to the cone if \f$\boldsymbol{A} \boldsymbol{x} \leq \boldsymbol{0}\f$ and
+    \f$\boldsymbol{E} \boldsymbol{x} = \boldsymbol{0}\f$, where \f$\boldsymbol{A}\f$ is ineqMat_ and
+    \f$\boldsymbol{E}\f$ is eqMat_.
+ */
+class PolyhedralCone
+{
+public:
+  /** \brief Make polyhedral cone from its span (V-representation).
+      \param spanMat matrix whose columns are the generators of the cone
+      \param eps tolerance of the rank and sign judgement
+
+      The faces are enumerated by the double description method applied to the polar cone.
+   */
+  static PolyhedralCone makeFromSpan(const Eigen::MatrixXd & spanMat, double eps = 1e-9);
+
+public:
+  /** \brief Constructor. */
+  PolyhedralCone() = default;
+
+  /** \brief Constructor.
+      \param ineqMat inequality matrix
+      \param eqMat equality matrix
+   */
+  PolyhedralCone(const Eigen::MatrixXd & ineqMat, const Eigen::MatrixXd & eqMat);
+
+  /** \brief Dimension of the ambient space. */
+  inline int dim() const
+  {
+    return static_cast<int>(ineqMat_.cols());
+  }
+
+  /** \brief Calculate the margin of the vector to the cone boundary.
+      \param x vector
+
+      The margin is the minimum distance to the face hyperplanes (positive inside the cone). If the cone has equality
+      constraints, the margin is the negative residual of the equality constraints at most.
+   */
+  double calcMargin(const Eigen::VectorXd & x) const;
+
+  /** \brief Whether the cone contains the vector.
+      \param x vector
+      \param eps tolerance
+   */
+  inline bool contains(const Eigen::VectorXd & x, double eps = 1e-8) const
+  {
+    return calcMargin(x) >= -eps;
+  }
+
+  /** \brief Make the cone expressed in the coordinates \f$\boldsymbol{y}\f$ such that \f$\boldsymbol{x} =
+      \boldsymbol{T} \boldsymbol{y}\f$.
+      \param transMat coordinate transformation matrix \f$\boldsymbol{T}\f$
+   */
+  PolyhedralCone transform(const Eigen::MatrixXd & transMat) const;
+
+public:
+  //! Inequality matrix (each row is a unit outward normal of a face)
+  Eigen::MatrixXd ineqMat_;
+
+  //! Equality matrix (rows are orthonormal)
+  Eigen::MatrixXd eqMat_;
+};
+} // namespace ForceColl
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <qp_solver_collection/QpSolverCollection.h>
+
+#include <string>
+
+namespace ForceColl
+{
+/** \brief Write QP coefficients to file in QPS format.
+    \param qpCoeff QP coefficients
+    \param path path of output file
+    \param name name of QP problem
+
+    QPS is the extension of MPS format for QP used by the Maros-Meszaros test set. The objective is
+    \f$\frac{1}{2} \boldsymbol{x}^T \boldsymbol{H} \boldsymbol{x} + \boldsymbol{g}^T \boldsymbol{x}\f$ where the lower
+    triangular part of \f$\boldsymbol{H}\f$ is written in QUADOBJ section. The bounds whose absolute value is not less
+    than 1e20 are regarded as infinite.
+*/
+void writeQps(const QpSolverCollection::QpCoeff & qpCoeff,
+              const std::string & path,
+              const std::string & name = "ForceColl");
+
+/** \brief Read QP coefficients from file in QPS format.
+    \param path path of input file
+    \returns QP coefficients
+
+    Only the free-format QPS files with N, E, L, and G rows, RHS, BOUNDS (LO, UP, FX, FR, MI, PL), and QUADOBJ sections
+    are supported. RANGES section and integer variables are not supported.
+*/
+QpSolverCollection::QpCoeff readQps(const std::string & path);
+} // namespace ForceColl
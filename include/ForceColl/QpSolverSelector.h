@@ -0,0 +1,75 @@
+#pragma once
+
+#include <qp_solver_collection/QpSolverCollection.h>
+
+#include <array>
+#include <optional>
+#include <vector>
+
+namespace ForceColl
+{
+/** \brief Selector of QP solver by the measured performance.
+
+    The available QP solvers are benchmarked on the actual QP, and the fastest one whose solution is accurate enough
+    is selected. The selection is cached per problem shape (process-wide and thread-safe), so that the benchmark is run
+    only once for each shape.
+ */
+class QpSolverSelector
+{
+public:
+  //! Problem shape (user-defined tag, variable dimension, equality dimension, and inequality dimension)
+  using ShapeKey = std::array<int, 4>;
+
+  //! Tolerance of constraint violation for accepting solution
+  static constexpr double violationThre = 1e-6;
+
+  //! Tolerance of relative objective gap to the best solver for accepting solution
+  static constexpr double objGapThre = 1e-4;
+
+  /** \brief Get the list of QP solvers available in the build. */
+  static std::vector<QpSolverCollection::QpSolverType> availableQpSolverTypes();
+
+  /** \brief Calculate the maximum constraint violation of solution.
+      \param qpCoeff QP coefficients
+      \param x solution
+   */
+  static double calcViolation(const QpSolverCollection::QpCoeff & qpCoeff, const Eigen::VectorXd & x);
+
+  /** \brief Calculate the objective value of solution.
+      \param qpCoeff QP coefficients
+      \param x solution
+   */
+  static double calcObjective(const QpSolverCollection::QpCoeff & qpCoeff, const Eigen::VectorXd & x);
+
+  /** \brief Make problem shape.
+      \param tag user-defined tag to distinguish the problem structures with the same dimensions
+      \param qpCoeff QP coefficients
+   */
+  static inline ShapeKey makeShapeKey(int tag, const QpSolverCollection::QpCoeff & qpCoeff)
+  {
+    return {tag, qpCoeff.dim_var_, qpCoeff.dim_eq_, qpCoeff.dim_ineq_};
+  }
+
+  /** \brief Select QP solver.
+      \param shapeKey problem shape
+      \param qpCoeff QP coefficients used for benchmark if the selection for the shape is not cached
+      \param trialNum number of solves per solver in benchmark (the minimum computation time is used)
+      \returns selected QP solver type (QpSolverType::Any if no solver succeeds)
+
+      The selection is not cached if no solver succeeds, so that the shape is benchmarked again in the next call
+      (e.g., with the QP coefficients of another problem of the same shape).
+   */
+  static QpSolverCollection::QpSolverType select(const ShapeKey & shapeKey,
+                                                 const QpSolverCollection::QpCoeff & qpCoeff,
+                                                 int trialNum = 3);
+
+  /** \brief Get the cached selection without benchmark.
+      \param shapeKey problem shape
+      \returns selected QP solver type (std::nullopt if select() has not been called for the shape)
+   */
+  static std::optional<QpSolverCollection::QpSolverType> findCached(const ShapeKey & shapeKey);
+
+  /** \brief Clear the cache of selection. */
+  static void clearCache();
+};
+} // namespace ForceColl
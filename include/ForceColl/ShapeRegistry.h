@@ -0,0 +1,170 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include <ForceColl/Contact.h>
+
+namespace ForceColl
+{
+/** \brief Immutable shape of surface contact with precomputed local grasp matrix. */
+struct SurfaceShape
+{
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  //! Name of vertices
+  std::string name;
+
+  //! List of local vertices
+  std::vector<Eigen::Vector3d> localVertices;
+
+  //! Friction pyramid
+  std::shared_ptr<const FrictionPyramid> fricPyramid;
+
+  //! Local grasp matrix
+  Eigen::Matrix<double, 6, Eigen::Dynamic> localGraspMat;
+};
+
+/** \brief Immutable shape of grasp contact with precomputed local grasp matrix. */
+struct GraspShape
+{
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  //! Name of vertices
+  std::string name;
+
+  //! List of local vertices
+  std::vector<sva::PTransformd> localVertices;
+
+  //! Friction pyramid
+  std::shared_ptr<const FrictionPyramid> fricPyramid;
+
+  //! Local grasp matrix
+  Eigen::Matrix<double, 6, Eigen::Dynamic> localGraspMat;
+};
+
+//! Handle of surface shape
+using SurfaceShapeHandle = std::shared_ptr<const SurfaceShape>;
+
+//! Handle of grasp shape
+using GraspShapeHandle = std::shared_ptr<const GraspShape>;
+
+/** \brief Registry of contact shapes that is frozen after loading.
+
+    Unlike SurfaceContact::verticesMap and GraspContact::verticesMap, the registry is immutable once built, so it can be
+    shared by threads that construct contacts without synchronization. A shape is registered for each combination of
+    vertices and friction pyramid, and its local grasp matrix is computed when the registry is built. Constructing a
+    contact from a shape handle does not look up any map nor recompute the local grasp matrix.
+
+    \code{.cpp}
+    ShapeRegistry::Builder builder;
+    builder.loadSurfaceVerticesMap(surfaceVerticesConfig);
+    builder.addFricCoeff(0.5);
+    std::shared_ptr<const ShapeRegistry> registry = builder.build();
+    SurfaceShapeHandle shape = registry->surfaceShape("LeftFoot", 0.5); // look up once
+    auto contact = std::make_shared<SurfaceContact>("LeftFootContact", shape, pose); // O(1) afterwards
+    \endcode
+ */
+class ShapeRegistry
+{
+public:
+  /** \brief Tolerance of friction coefficient to regard two friction pyramids as the same.
+
+      The friction coefficient given to surfaceShape() and graspShape() may be computed differently from the one given
+      to Builder::addFricCoeff() (e.g., loaded from another configuration), so it is not compared exactly.
+   */
+  static constexpr double fricCoeffTolerance = 1e-10;
+
+  /** \brief Builder of registry. */
+  class Builder
+  {
+  public:
+    /** \brief Add surface vertices.
+        \param name name of vertices
+        \param localVertices surface vertices in local coordinates
+     */
+    Builder & addSurfaceVertices(const std::string & name, const std::vector<Eigen::Vector3d> & localVertices);
+
+    /** \brief Add grasp vertices.
+        \param name name of vertices
+        \param localVertices grasp vertices in local coordinates
+     */
+    Builder & addGraspVertices(const std::string & name, const std::vector<sva::PTransformd> & localVertices);
+
+    /** \brief Load surface vertices from mc_rtc configuration in the format of SurfaceContact::loadVerticesMap().
+        \param mcRtcConfig mc_rtc configuration
+     */
+    Builder & loadSurfaceVerticesMap(const mc_rtc::Configuration & mcRtcConfig);
+
+    /** \brief Load grasp vertices from mc_rtc configuration in the format of GraspContact::loadVerticesMap().
+        \param mcRtcConfig mc_rtc configuration
+     */
+    Builder & loadGraspVerticesMap(const mc_rtc::Configuration & mcRtcConfig);
+
+    /** \brief Add friction pyramid for which shapes are made.
+        \param fricCoeff friction coefficient
+        \param ridgeNum number of ridges of friction pyramid
+
+        The friction pyramid is ignored if the same one within fricCoeffTolerance has already been added.
+     */
+    Builder & addFricCoeff(double fricCoeff, int ridgeNum = 4);
+
+    /** \brief Build registry. */
+    std::shared_ptr<const ShapeRegistry> build() const;
+
+  protected:
+    //! Map of surface vertices
+    std::unordered_map<std::string, std::vector<Eigen::Vector3d>> surfaceVerticesMap_;
+
+    //! Map of grasp vertices
+    std::unordered_map<std::string, std::vector<sva::PTransformd>> graspVerticesMap_;
+
+    //! List of friction pyramids
+    std::vector<std::shared_ptr<const FrictionPyramid>> fricPyramidList_;
+  };
+
+public:
+  /** \brief Get surface shape.
+      \param name name of vertices
+      \param fricCoeff friction coefficient
+      \param ridgeNum number of ridges of friction pyramid
+
+      The friction coefficient is matched within fricCoeffTolerance.
+   */
+  SurfaceShapeHandle surfaceShape(const std::string & name, double fricCoeff, int ridgeNum = 4) const;
+
+  /** \brief Get grasp shape.
+      \param name name of vertices
+      \param fricCoeff friction coefficient
+      \param ridgeNum number of ridges of friction pyramid
+
+      The friction coefficient is matched within fricCoeffTolerance.
+   */
+  GraspShapeHandle graspShape(const std::string & name, double fricCoeff, int ridgeNum = 4) const;
+
+  /** \brief Whether the registry has surface vertices.
+      \param name name of vertices
+   */
+  inline bool hasSurfaceVertices(const std::string & name) const
+  {
+    return surfaceShapeMap_.count(name) > 0;
+  }
+
+  /** \brief Whether the registry has grasp vertices.
+      \param name name of vertices
+   */
+  inline bool hasGraspVertices(const std::string & name) const
+  {
+    return graspShapeMap_.count(name) > 0;
+  }
+
+protected:
+  //! Map of surface shapes (one for each friction pyramid)
+  std::unordered_map<std::string, std::vector<SurfaceShapeHandle>> surfaceShapeMap_;
+
+  //! Map of grasp shapes (one for each friction pyramid)
+  std::unordered_map<std::string, std::vector<GraspShapeHandle>> graspShapeMap_;
+};
+} // namespace ForceColl
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <Eigen/Core>
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace ForceColl
+{
+/** \brief Cache of solutions with bounded size and least recently used (LRU) eviction.
+
+    The key is an integer vector, typically obtained by quantizing the problem parameters so that close parameters
+    share the same key. The numbers of hits and misses are counted for tuning the quantization and the size.
+ */
+class SolutionCache
+{
+public:
+  //! Key of cache
+  using Key = std::vector<int64_t>;
+
+public:
+  /** \brief Constructor.
+      \param capacity maximum number of entries (zero for no caching)
+   */
+  SolutionCache(size_t capacity = 0);
+
+  /** \brief Find solution and mark it as the most recently used.
+      \param key key
+      \returns pointer to the cached solution (nullptr if not found), which is valid until the next insert() or clear()
+   */
+  const Eigen::VectorXd * find(const Key & key);
+
+  /** \brief Insert solution. The least recently used entry is evicted if the cache is full.
+      \param key key
+      \param solution solution
+   */
+  void insert(const Key & key, const Eigen::VectorXd & solution);
+
+  /** \brief Remove all entries (the statistics are kept). */
+  void clear();
+
+  /** \brief Reset the numbers of hits and misses. */
+  void resetStats();
+
+  /** \brief Get the maximum number of entries. */
+  inline size_t capacity() const noexcept
+  {
+    return capacity_;
+  }
+
+  /** \brief Get the number of entries. */
+  inline size_t size() const noexcept
+  {
+    return entryList_.size();
+  }
+
+  /** \brief Get the number of hits. */
+  inline size_t hitNum() const noexcept
+  {
+    return hitNum_;
+  }
+
+  /** \brief Get the number of misses. */
+  inline size_t missNum() const noexcept
+  {
+    return missNum_;
+  }
+
+  /** \brief Get the hit rate (zero if never looked up). */
+  inline double hitRate() const noexcept
+  {
+    size_t lookupNum = hitNum_ + missNum_;
+    return lookupNum == 0 ? 0.0 : static_cast<double>(hitNum_) / static_cast<double>(lookupNum);
+  }
+
+protected:
+  /** \brief Hash of key. */
+  struct KeyHash
+  {
+    size_t operator()(const Key & key) const noexcept;
+  };
+
+  //! Entry of cache
+  using Entry = std::pair<Key, Eigen::VectorXd>;
+
+protected:
+  //! Maximum number of entries
+  size_t capacity_;
+
+  //! List of entries in the most recently used order
+  std::list<Entry> entryList_;
+
+  //! Map from key to entry
+  std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> entryMap_;
+
+  //! Number of hits
+  size_t hitNum_ = 0;
+
+  //! Number of misses
+  size_t missNum_ = 0;
+};
+} // namespace ForceColl
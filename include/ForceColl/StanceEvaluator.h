@@ -0,0 +1,102 @@
+#pragma once
+
+#include <ForceColl/WorkerThreads.h>
+#include <ForceColl/WrenchDistribution.h>
+
+#include <memory>
+
+namespace ForceColl
+{
+/** \brief Batch evaluation of candidate stances.
+
+    The contacts given to the constructor are used only as shapes (local vertices, friction pyramid, maximum wrench)
+    and are never modified. For each candidate set of contact poses, the wrench distribution QP is solved for the
+    contacts placed at the poses. The candidates are distributed to multiple threads, each of which owns copies of the
+    contacts and a wrench distribution instance. The threads and their copies are kept across run() and are made again
+    only if the number of threads or contactList_ (the contact pointers or their local vertices) is changed.
+ */
+class StanceEvaluator
+{
+public:
+  /** \brief Evaluation result of a candidate stance. */
+  struct Result
+  {
+    //! Whether the desired total wrench is achieved
+    bool feasible = false;
+
+    //! Weighted squared error of total wrench
+    double cost = 0.0;
+
+    //! Wrench ratio
+    Eigen::VectorXd wrenchRatio;
+
+    //! Total wrench of distributed result wrenches
+    sva::ForceVecd resultTotalWrench = sva::ForceVecd::Zero();
+  };
+
+public:
+  /** \brief Constructor.
+      \param contactList list of contact constraint used as shapes
+      \param mcRtcConfig mc_rtc configuration
+
+      In addition to the entries of WrenchDistribution, mcRtcConfig can contain the following entries:
+        - threadNum: number of threads (hardware concurrency if non-positive)
+        - feasibleErrorThre: threshold of total wrench error to judge feasibility
+   */
+  StanceEvaluator(const std::vector<std::shared_ptr<Contact>> & contactList,
+                  const mc_rtc::Configuration & mcRtcConfig = {});
+
+  /** \brief Evaluate candidate stances.
+      \param poseSetList list of candidate contact poses (each element has the same size as contactList_)
+      \param desiredTotalWrench total wrench
+      \param momentOrigin moment origin
+      \returns list of evaluation results in the same order as poseSetList
+
+      If the evaluation of any candidate throws an exception, the exception is rethrown after all threads finish.
+   */
+  std::vector<Result> run(const std::vector<std::vector<sva::PTransformd>> & poseSetList,
+                          const sva::ForceVecd & desiredTotalWrench,
+                          const Eigen::Vector3d & momentOrigin = Eigen::Vector3d::Zero());
+
+public:
+  //! List of contact constraint used as shapes
+  std::vector<std::shared_ptr<Contact>> contactList_;
+
+  //! Number of threads
+  int threadNum_ = 0;
+
+  //! Threshold of total wrench error to judge feasibility
+  double feasibleErrorThre_ = 1e-2;
+
+protected:
+  /** \brief Copies of contacts and wrench distribution owned by a thread. */
+  struct Worker
+  {
+    //! Copies of contactList_ whose global vertices are updated for each candidate
+    std::vector<std::shared_ptr<Contact>> contactList;
+
+    //! Wrench distribution of contactList
+    std::shared_ptr<WrenchDistribution> wrenchDist;
+  };
+
+protected:
+  /** \brief Make the worker threads and their copies of contacts if they are not made or are outdated. */
+  void updateWorkers();
+
+protected:
+  //! mc_rtc configuration of wrench distribution
+  mc_rtc::Configuration mcRtcConfig_;
+
+  //! Worker threads
+  std::unique_ptr<WorkerThreads> workerThreads_;
+
+  //! Copies of contacts and wrench distribution of each thread
+  std::vector<Worker> workerList_;
+
+  //! Contacts from which the copies in workerList_ are made
+  std::vector<std::shared_ptr<Contact>> sourceContactList_;
+
+  //! Revisions of the local grasp matrices of sourceContactList_ when the copies are made
+  std::vector<size_t> sourceRevisionList_;
+};
+} // namespace ForceColl
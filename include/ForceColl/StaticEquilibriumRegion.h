@@ -0,0 +1,118 @@
+#pragma once
+
+#include <qp_solver_collection/QpSolverCollection.h>
+
+#include <ForceColl/Contact.h>
+
+namespace ForceColl
+{
+/** \brief Static equilibrium region of CoM.
+
+    The region is the set of horizontal CoM positions for which the gravity can be supported by the contacts with the
+    ridge forces within ridgeForceMinMax and the contact wrenches within the maximum wrenches. It is a convex polygon
+    obtained by projecting the feasible set of ridge forces onto the CoM plane. The polygon is computed by the
+    iterative projection method, where the support point in each direction is given by an LP solved with the QP solver.
+
+    After the contacts move, update() recomputes the polygon starting from the directions of the previous polygon edges.
+    This is a full recomputation with a warm start of the directions, not an incremental update of the moved contacts:
+    every support point is the optimum of an LP over the ridge forces of all contacts, so all LPs are solved again.
+    The warm start reduces the number of LPs when the region changes only slightly. Once computed, checking whether a
+    CoM position is statically feasible is a point-in-polygon test.
+
+    See T. Bretl and S. Lall. Testing static equilibrium for legged robots. IEEE Transactions on Robotics, 2008.
+ */
+class StaticEquilibriumRegion
+{
+public:
+  /** \brief Configuration. */
+  struct Configuration
+  {
+    //! Min/max ridge force
+    std::pair<double, double> ridgeForceMinMax = std::make_pair(3, 1000); // [N]
+
+    //! Weight of QP regularization
+    double regularWeight = 1e-8;
+
+    //! Tolerance of polygon edges
+    double tolerance = 1e-3; // [m]
+
+    //! Maximum number of LPs in one update
+    int maxLpNum = 100;
+
+    /** \brief Load mc_rtc configuration.
+        \param mcRtcConfig mc_rtc configuration
+    */
+    void load(const mc_rtc::Configuration & mcRtcConfig);
+  };
+
+public:
+  EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+  /** \brief Constructor.
+      \param contactList list of contact constraint
+      \param mass robot mass
+      \param mcRtcConfig mc_rtc configuration
+   */
+  StaticEquilibriumRegion(const std::vector<std::shared_ptr<Contact>> & contactList,
+                          double mass,
+                          const mc_rtc::Configuration & mcRtcConfig = {});
+
+  /** \brief Update the region according to the current grasp matrices of the contacts.
+      \param warmStart whether to start from the edge directions of the previous region
+
+      All the support points are recomputed even if only one contact moves.
+   */
+  void update(bool warmStart = true);
+
+  /** \brief Whether the horizontal CoM position is in the region.
+      \param comXY horizontal CoM position
+      \param eps tolerance
+   */
+  bool contains(const Eigen::Vector2d & comXY, double eps = 0.0) const;
+
+  /** \brief Const accessor to the configuration. */
+  inline const Configuration & config() const noexcept
+  {
+    return config_;
+  }
+
+public:
+  //! List of contact constraint
+  std::vector<std::shared_ptr<Contact>> contactList_;
+
+  //! Robot mass
+  double mass_;
+
+  //! Vertices of the region in counterclockwise order (empty if there is no static equilibrium)
+  std::vector<Eigen::Vector2d> vertexList_;
+
+  //! Number of LPs solved in the last update
+  int lpNum_ = 0;
+
+  //! QP solver
+  std::shared_ptr<QpSolverCollection::QpSolver> qpSolver_;
+
+  //! QP coefficients
+  QpSolverCollection::QpCoeff qpCoeff_;
+
+protected:
+  /** \brief Setup QP coefficients except for the objective. */
+  void setupQp();
+
+  /** \brief Calculate the support point of the region.
+      \param dir direction
+      \returns support point (std::nullopt if there is no static equilibrium)
+   */
+  std::optional<Eigen::Vector2d> calcSupportPoint(const Eigen::Vector2d & dir);
+
+protected:
+  //! Configuration
+  Configuration config_;
+
+  //! Map from ridge forces to the CoM moment around the world origin (i.e., gravity force times horizontal CoM)
+  Eigen::Matrix<double, 2, Eigen::Dynamic> comMomentMat_;
+
+  //! Edge directions of the region
+  std::vector<Eigen::Vector2d> dirList_;
+};
+} // namespace ForceColl
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ForceColl
+{
+/** \brief Persistent worker threads running the same function.
+
+    The worker threads are created in the constructor and wait on a condition variable until run() is called, so that
+    repeated parallel evaluation does not create and join threads every time. The calling thread of run() also works as
+    the first thread. The threads are stopped and joined in the destructor.
+ */
+class WorkerThreads
+{
+public:
+  /** \brief Constructor.
+      \param threadNum number of threads including the calling thread of run() (one for no worker thread)
+   */
+  WorkerThreads(int threadNum);
+
+  //! Copy constructor (deleted because the threads refer to this instance)
+  WorkerThreads(const WorkerThreads &) = delete;
+
+  //! Copy assignment (deleted because the threads refer to this instance)
+  WorkerThreads & operator=(const WorkerThreads &) = delete;
+
+  /** \brief Destructor. */
+  ~WorkerThreads();
+
+  /** \brief Get the number of threads including the calling thread of run(). */
+  inline int threadNum() const noexcept
+  {
+    return static_cast<int>(threadList_.size()) + 1;
+  }
+
+  /** \brief Run the function on all threads and wait until all of them finish.
+      \param func function called with the thread index (zero for the calling thread)
+
+      If the function throws an exception on any thread, the exception of the smallest thread index is rethrown after
+      all threads finish. run() must not be called concurrently.
+   */
+  void run(const std::function<void(int)> & func);
+
+protected:
+  /** \brief Loop of worker thread.
+      \param threadIdx thread index (from one)
+   */
+  void workerLoop(int threadIdx);
+
+protected:
+  //! Worker threads
+  std::vector<std::thread> threadList_;
+
+  //! Mutex for the following states
+  std::mutex mutex_;
+
+  //! Condition variable to wake the worker threads
+  std::condition_variable startCond_;
+
+  //! Condition variable to notify that the worker threads finish
+  std::condition_variable finishCond_;
+
+  //! Function of the current run()
+  const std::function<void(int)> * func_ = nullptr;
+
+  //! Number of run() calls (the worker threads start when it is incremented)
+  size_t runCount_ = 0;
+
+  //! Number of worker threads running the function
+  int runningNum_ = 0;
+
+  //! Whether to stop the worker threads
+  bool stop_ = false;
+
+  //! Exception thrown on each thread in the current run()
+  std::vector<std::exception_ptr> exceptionList_;
+};
+} // namespace ForceColl
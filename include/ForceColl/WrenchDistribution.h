@@ -4,6 +4,11 @@
 
 #include <ForceColl/Constants.h>
 #include <ForceColl/Contact.h>
+#include <ForceColl/CriticalRegion.h>
+#include <ForceColl/QpSolverSelector.h>
+#include <ForceColl/SolutionCache.h>
+
+#include <map>
 
 namespace ForceColl
 {
@@ -11,6 +16,22 @@ namespace ForceColl
 class WrenchDistribution
 {
 public:
+  /** \brief Formulation of wrench distribution QP. */
+  enum class Formulation
+  {
+    //! Decision variables are the forces along the friction pyramid ridges
+    Ridge = 0,
+
+    //! Decision variables are the contact wrenches constrained by the contact wrench cones
+    Wrench,
+
+    //! Decision variables are the vertex forces constrained by the circular friction cones
+    Cone,
+
+    //! Decision variables are the ridge forces and the local contact wrenches linked by equality constraints
+    Lifted
+  };
+
   /** \brief Configuration. */
   struct Configuration
   {
@@ -23,10 +44,251 @@ public:
     //! Min/max ridge force
     std::pair<double, double> ridgeForceMinMax = std::make_pair(3, 1000); // [N]
 
+    /** \brief QP formulation
+
+        In the Wrench formulation, the QP has six variables per contact and the maximum ridge force is not imposed.
+
+        In the Cone formulation, the QP has three variables per vertex and the normal force of each vertex is bounded
+        by ridgeForceMinMax. The circular friction cone is imposed by the tangent planes added iteratively at the
+        vertices violating the cone (outer approximation), until the violation is below coneTolerance. Since the
+        vertex forces in the friction cones cannot be represented exactly by the ridges of the friction pyramids, the
+        result is given by resultWrenchList_ and resultWrenchRatio_ is empty. The solution cache and the adaptive
+        friction pyramids are not used in this formulation.
+
+        In the Lifted formulation, the QP has the ridge forces, six local wrench variables per contact, and six total
+        wrench variables. The local wrenches are linked to the ridge forces by block-diagonal equality constraints and
+        to the total wrench by one equality constraint of six rows, and the wrench weight is applied only to the total
+        wrench, so the Hessian is diagonal. The maximum wrench is imposed as the bounds of the local wrench variables
+        instead of the dense inequality constraints, so that the sparse QP solvers can exploit the block structure for
+        the large contact sets. Unlike the Ridge formulation, regularWeight is also applied to the local and total
+        wrench variables to keep the Hessian positive definite. Therefore, the resulting total wrench matches the Ridge
+        formulation up to the order of regularWeight, but the distribution among the contacts (and the ridge forces)
+        may differ when it is redundant.
+    */
+    Formulation formulation = Formulation::Ridge;
+
+    /** \brief Maximum number of stored critical regions (zero for no explicit distribution)
+
+        If positive, the QP solution is stored as an affine function of the desired total wrench together with its
+        critical region. While the grasp matrices and the moment origin are fixed, run() looks up the region containing
+        the desired total wrench and evaluates the affine function instead of solving QP.
+    */
+    int criticalRegionNumMax = 0;
+
+    /** \brief Number of representative vertices per contact in the coarse stage (zero for no coarse-to-fine solve)
+
+        If positive, the Ridge formulation is solved in two stages. In the coarse stage, only the ridges of the
+        representative vertices of each contact are optimized and the other ridge forces are fixed to the minimum. In
+        the fine stage, all ridges of the contacts whose coarse solution is near the bounds are optimized while the
+        ridge forces of the other contacts are fixed to the coarse solution. Critical regions are not used in this
+        mode.
+    */
+    int coarseVertexNum = 0;
+
+    //! Margin to the bounds for judging that a contact needs refinement in the coarse-to-fine solve
+    double refineMargin = 1.0; // [N]
+
+    /** \brief Numbers of ridges of coarse and fine friction pyramids (no adaptation if the fine one is zero)
+
+        If enabled, a contact is solved with the fine friction pyramid (and QP is solved again) when the friction usage
+        of the result exceeds the second element of adaptiveFricUsageThre. It is solved with its own friction pyramid
+        again at the next run() when the friction usage falls below the first element. The contacts in contactList_
+        are not modified: the fine pyramid is held by a private copy of the contact in solverContactList(). The coarse
+        pyramid is the own one of each contact, so the first element only bounds the fine one from below. If enabled,
+        the coarse one must be at least 3 and not larger than the fine one.
+    */
+    std::pair<int, int> adaptiveRidgeNum = std::make_pair(0, 0);
+
+    //! Tolerance of friction usage violation in the Cone formulation
+    double coneTolerance = 1e-3;
+
+    //! Maximum number of QP solves in one run() in the Cone formulation
+    int coneIterMax = 10;
+
+    /** \brief Maximum number of tangent planes per vertex in the Cone formulation (at least 5)
+
+        The initial four planes of the square circumscribing the friction cone are always kept, and the oldest of the
+        other planes is removed when a new plane is added at the maximum number.
+    */
+    int coneCutNumMax = 32;
+
+    //! Thresholds of friction usage (see Contact::calcFricUsage) for coarsening and refining friction pyramids
+    std::pair<double, double> adaptiveFricUsageThre = std::make_pair(0.4, 0.6);
+
+    /** \brief Directory to export QP coefficients (empty for no export)
+
+        If not empty, the coefficients of every QP solved in run() are written to this directory in QPS format (see
+        writeQps()) with the file name wrench_distribution_<index>.qps. This is for benchmarking QP solvers with the
+        BenchmarkQpSolvers executable and is too slow for real-time control.
+    */
+    std::string qpExportDir = "";
+
+    /** \brief Number of run() calls per QP solve (one for solving QP in every run())
+
+        If greater than one, QP is solved only once in qpDecimation calls of run(). In the other calls, the QP solution
+        is projected from the last one by the linear map of its active set (i.e., the gain matrix of the critical
+        region) applied to the change in the desired total wrench. In the Ridge and Lifted formulations, the projected
+        wrench ratio is clipped to ridgeForceMinMax. In the Wrench formulation, the projected contact wrenches are
+        decomposed into the ridges in the same way as after QP. The maximum wrench constraints of the contacts are not
+        imposed in the projection. QP is solved regardless of the count if the number of ridges or the moment origin is
+        changed. Not supported in the Cone formulation.
+    */
+    int qpDecimation = 1;
+
+    /** \brief Maximum number of cached solutions (zero for no solution cache)
+
+        If positive, the result wrench ratio of run() is cached with the key of the contact poses, the desired total
+        wrench, and the moment origin quantized by the following resolutions. If the quantized key of run() matches a
+        cached one, the cached wrench ratio is returned without solving QP. The least recently used solution is evicted
+        when the cache is full. The key also contains the revision of the local grasp matrix (see
+        Contact::localGraspMatRevision()), the friction coefficient, and the maximum wrench of each contact, so the
+        solutions cached before changing them are not returned.
+    */
+    int solutionCacheSize = 0;
+
+    //! Resolution of contact positions and moment origin in the key of solution cache
+    double solutionCachePosResolution = 1e-3; // [m]
+
+    //! Resolution of contact rotation matrix elements in the key of solution cache
+    double solutionCacheRotResolution = 1e-3;
+
+    //! Resolution of desired total wrench in the key of solution cache
+    double solutionCacheWrenchResolution = 1e-1; // [N], [Nm]
+
     /** \brief Load mc_rtc configuration.
         \param mcRtcConfig mc_rtc configuration
     */
     void load(const mc_rtc::Configuration & mcRtcConfig);
+
+    /** \brief Save mc_rtc configuration.
+        \param mcRtcConfig mc_rtc configuration from which load() restores this configuration
+    */
+    void save(mc_rtc::Configuration & mcRtcConfig) const;
+  };
+
+  /** \brief Snapshot of the state of wrench distribution.
+
+      The snapshot stores the contact states, the last result, and the data for the next run() (the QP coefficients,
+      the QP solution, and the projection of Configuration::qpDecimation). The caches keyed by the inputs (the critical
+      regions, the solution cache, and the QP solver) are not stored because they remain valid after restore().
+
+      The snapshot is immutable and shared by std::shared_ptr, so it can be restored any number of times without copying
+      it. The contacts are stored as copies, and the copy of a contact is shared with the previous snapshot if the
+      contact is not changed since then. Likewise, the QP coefficients and the critical region are shared with the
+      previous snapshot if run() does not change them since then, and they are copied back in restore() only if they
+      are changed since the snapshot.
+   */
+  struct Snapshot
+  {
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    //! ID of wrench distribution that took the snapshot (see WrenchDistribution::id())
+    size_t ownerId = 0;
+
+    //! Contacts of wrench distribution, which are restored in place
+    std::vector<std::shared_ptr<Contact>> contactPtrList;
+
+    //! Copies of contacts at the snapshot
+    std::vector<std::shared_ptr<const Contact>> contactList;
+
+    //! Result wrench ratio
+    Eigen::VectorXd resultWrenchRatio;
+
+    //! Desired total wrench
+    sva::ForceVecd desiredTotalWrench = sva::ForceVecd::Zero();
+
+    //! Result total wrench
+    sva::ForceVecd resultTotalWrench = sva::ForceVecd::Zero();
+
+    //! QP coefficients
+    std::shared_ptr<const QpSolverCollection::QpCoeff> qpCoeff;
+
+    //! Matrix mapping the desired total wrench to the QP objective linear vector
+    std::shared_ptr<const Eigen::MatrixXd> objParamMat;
+
+    //! Revision of qpCoeff and objParamMat
+    size_t qpCoeffRevision = 0;
+
+    //! Total grasp matrix with respect to the moment origin
+    Eigen::Matrix<double, 6, Eigen::Dynamic> totalGraspMat;
+
+    //! QP solution
+    Eigen::VectorXd qpSolution;
+
+    //! Result contact wrenches (only in the Cone formulation)
+    std::vector<sva::ForceVecd> resultWrenchList;
+
+    //! Whether the last result is obtained from the critical region
+    bool criticalRegionHit = false;
+
+    //! Whether the last result is projected from the last QP solution
+    bool projectionUsed = false;
+
+    //! Whether the last result is obtained from the solution cache
+    bool solutionCacheHit = false;
+
+    //! Whether the friction cones are satisfied in the last solve of the Cone formulation
+    bool coneConverged = true;
+
+    //! Whether qpCoeff is the full QP of the last run()
+    bool fullQpSetup = false;
+
+    //! Angles of the tangent planes of the friction cone at each vertex
+    std::vector<std::vector<double>> coneCutAngleList;
+
+    //! Critical region of the last run() (nullptr if not calculated)
+    std::shared_ptr<const CriticalRegion> lastCriticalRegion;
+
+    //! Revision of lastCriticalRegion
+    size_t lastCriticalRegionRevision = 0;
+
+    //! Number of run() calls since the last QP solve
+    int qpDecimationCount = 0;
+
+    //! Gain matrix of the critical region of the last QP solve for projection
+    Eigen::MatrixXd projectionGainMat;
+
+    //! QP solution of the last QP solve for projection
+    Eigen::VectorXd projectionSolution;
+
+    //! Desired total wrench of the last QP solve
+    Eigen::Vector6d projectionDesiredTotalWrench = Eigen::Vector6d::Zero();
+
+    //! Moment origin of the last QP solve
+    Eigen::Vector3d projectionMomentOrigin = Eigen::Vector3d::Zero();
+
+    //! Number of ridges of the adapted friction pyramid of each contact (zero for the own one of the contact)
+    std::vector<int> adaptedRidgeNumList;
+  };
+
+protected:
+  /** \brief Key of the inequality rows of a contact in the Ridge QP. */
+  struct RidgeQpIneqKey
+  {
+    //! Number of ridges
+    int ridgeNum = 0;
+
+    //! Whether the contact has the maximum wrench
+    bool hasMaxWrench = false;
+
+    //! Revision of the local grasp matrix written in the rows
+    size_t localGraspMatRevision = 0;
+  };
+
+  /** \brief Private copy of a contact with the adapted friction pyramid. */
+  struct AdaptedContact
+  {
+    //! Contact in contactList_ from which the copy is made
+    std::shared_ptr<Contact> source;
+
+    //! Copy with the adapted friction pyramid (nullptr if the contact is not adapted)
+    std::shared_ptr<Contact> contact;
+
+    //! Revision of the local grasp matrix of the source when the copy is made
+    size_t sourceRevision = 0;
+
+    //! Friction pyramid of the source when the copy is made
+    std::shared_ptr<const FrictionPyramid> sourceFricPyramid;
   };
 
 public:
@@ -35,6 +297,15 @@ public:
   /** \brief Constructor.
       \param contactList list of contact constraint
       \param mcRtcConfig mc_rtc configuration
+
+      In addition to Configuration, the QP solver type is loaded from "qpSolverType" of mcRtcConfig. If it is "Auto",
+      the fastest accurate QP solver selected by benchmarking the available solvers on the actual QP (see
+      QpSolverSelector) is used. Since the benchmark takes much longer than a QP solve, run() never benchmarks: it uses
+      the default solver until the selection for the QP shape is available from warmUpQpSolverSelection() (of this or
+      another instance, as the selection is process-wide). The QP shape is the dimensions of the full problem of the
+      formulation (see qpSolverShapeKey()), so the intermediate QPs (e.g., of the coarse-to-fine method and the
+      iterations of the Cone formulation) use the same solver. All the available QP solvers are allocated here, so
+      run() does not allocate them when switching the solver.
    */
   WrenchDistribution(const std::vector<std::shared_ptr<Contact>> & contactList,
                      const mc_rtc::Configuration & mcRtcConfig = {});
@@ -47,17 +318,117 @@ public:
   sva::ForceVecd run(const sva::ForceVecd & desiredTotalWrench,
                      const Eigen::Vector3d & momentOrigin = Eigen::Vector3d::Zero());
 
+  /** \brief Calculate the Jacobian of the result wrench ratio with respect to the desired total wrench.
+
+      The Jacobian is obtained by differentiating the KKT conditions of the last run() with the active set fixed.
+   */
+  Eigen::MatrixXd calcWrenchRatioJacobian();
+
+  /** \brief Calculate the Jacobians of the contact wrenches with respect to the desired total wrench.
+      \returns list of Jacobian, where the contact wrenches are around the moment origin of the last run()
+   */
+  std::vector<Eigen::Matrix6d> calcWrenchJacobianList();
+
+  /** \brief Precompute critical regions by running the distribution for the sample total wrenches.
+      \param desiredTotalWrenchList list of sample total wrench
+      \param momentOrigin moment origin
+
+      The critical regions are stored only if criticalRegionNumMax is positive.
+   */
+  void precomputeCriticalRegions(const std::vector<sva::ForceVecd> & desiredTotalWrenchList,
+                                 const Eigen::Vector3d & momentOrigin = Eigen::Vector3d::Zero());
+
+  /** \brief Select the QP solver by benchmark for the QP shapes of the sample total wrench if the QP solver type is
+      "Auto".
+      \param desiredTotalWrench sample total wrench
+      \param momentOrigin moment origin
+
+      Call this outside the control loop (e.g., at initialization or from a background thread owning another instance
+      with the same contacts). The distribution is run as in run() while the unseen QP shapes are benchmarked. Nothing
+      is benchmarked if run() does not solve the QP (i.e., if it is served by the solution cache, the critical regions,
+      or the QP decimation).
+   */
+  void warmUpQpSolverSelection(const sva::ForceVecd & desiredTotalWrench,
+                               const Eigen::Vector3d & momentOrigin = Eigen::Vector3d::Zero());
+
+  /** \brief Take a snapshot of the current state (e.g., before a rollout of planner).
+
+      Only the contacts changed since the last snapshot taken or restored are copied. This is not const because the
+      snapshot is kept for sharing the contact copies with the next snapshot.
+   */
+  std::shared_ptr<const Snapshot> snapshot();
+
+  /** \brief Restore the state from a snapshot.
+      \param snapshot snapshot taken by this instance
+
+      contactList_ is set to the contacts at the snapshot, and the states of the contacts changed since the snapshot are
+      assigned in place from the snapshot. The contacts are shared with the caller, so they are also restored for the
+      caller. The QP solver is not allocated again, and the buffers are not allocated again if their sizes are the
+      same. contactList_ may differ from the one at the snapshot (e.g., contacts added in a rollout).
+
+      Throw if the snapshot is taken by another instance, or if its contacts do not match their copies in type and
+      name.
+   */
+  void restore(const std::shared_ptr<const Snapshot> & snapshot);
+
+  /** \brief Get the ID of this instance.
+
+      The ID is unique among the instances constructed in the process (unlike the address, which may be reused after
+      an instance is destroyed), and is used to check the owner of a snapshot. Copies of an instance have the same ID.
+   */
+  inline size_t id() const noexcept
+  {
+    return id_;
+  }
+
   /** \brief Const accessor to the configuration. */
   inline const Configuration & config() const noexcept
   {
     return config_;
   }
 
+  /** \brief Const accessor to the solution cache (e.g., for the hit rate). */
+  inline const SolutionCache & solutionCache() const noexcept
+  {
+    return solutionCache_;
+  }
+
+  /** \brief Clear the solution cache. */
+  void clearSolutionCache();
+
+  /** \brief Get the contacts whose ridges correspond to resultWrenchRatio_.
+
+      This is the same as contactList_ unless Configuration::adaptiveRidgeNum is enabled, in which case the contacts
+      with the fine friction pyramids are replaced with the private copies. The copies follow the poses and maximum
+      wrenches of contactList_ at every run(). Use this instead of contactList_ to interpret resultWrenchRatio_.
+   */
+  inline const std::vector<std::shared_ptr<Contact>> & solverContactList() const noexcept
+  {
+    return solverContactList_;
+  }
+
+  /** \brief Get the type of the QP solver in use (for logging the automatic selection). */
+  inline QpSolverCollection::QpSolverType qpSolverType() const
+  {
+    return qpSolver_->type();
+  }
+
+  /** \brief Make the QP shape for the automatic selection of QP solver.
+
+      The shape is made from the dimensions of the full problem of the formulation with the current contacts, not from
+      the current QP coefficients. In the Cone formulation, the number of inequality constraints is the maximum one
+      with coneCutNumMax tangent planes per vertex.
+   */
+  QpSolverSelector::ShapeKey qpSolverShapeKey() const;
+
   /** \brief Add markers to GUI.
       \param gui GUI
       \param category category of GUI entries
       \param forceScale scale of force markers (set non-positive for no visualization)
       \param fricPyramidScale scale of friction pyramid markers (set non-positive for no visualization)
+
+      The markers show the current result and are not updated. Use WrenchDistributionGUI to show the result of every
+      control cycle.
    */
   void addToGUI(mc_rtc::gui::StateBuilder & gui,
                 const std::vector<std::string> & category,
@@ -68,7 +439,7 @@ public:
   //! List of contact constraint
   std::vector<std::shared_ptr<Contact>> contactList_;
 
-  //! Result wrench ratio
+  //! Result wrench ratio (empty in the Cone formulation, see resultWrenchList_)
   Eigen::VectorXd resultWrenchRatio_;
 
   //! Desired total wrench
@@ -83,8 +454,217 @@ public:
   //! QP coefficients
   QpSolverCollection::QpCoeff qpCoeff_;
 
+  //! Total grasp matrix with respect to the moment origin
+  Eigen::Matrix<double, 6, Eigen::Dynamic> totalGraspMat_;
+
+  //! QP solution of the last run() (the vertex forces in the friction pyramid frames in the Cone formulation)
+  Eigen::VectorXd qpSolution_;
+
+  //! Result contact wrenches around the world origin (only in the Cone formulation)
+  std::vector<sva::ForceVecd> resultWrenchList_;
+
+  //! List of critical regions in the most recently used order
+  std::vector<CriticalRegion> criticalRegionList_;
+
+  //! Whether the last result is obtained from the critical region without solving QP
+  bool criticalRegionHit_ = false;
+
+  //! Whether the last result is projected from the last QP solution without solving QP
+  bool projectionUsed_ = false;
+
+  //! Whether the last result is obtained from the solution cache without solving QP
+  bool solutionCacheHit_ = false;
+
+  /** \brief Whether the friction cones are satisfied within coneTolerance in the last solve of the Cone formulation
+
+      If false, the result is the last QP solution when coneIterMax is reached and the forces may be outside the
+      friction cones. Always true in the other formulations.
+  */
+  bool coneConverged_ = true;
+
+protected:
+  /** \brief Calculate the result wrench ratio by solving QP.
+      \param momentOrigin moment origin
+   */
+  void calcWrenchRatio(const Eigen::Vector3d & momentOrigin);
+
+  /** \brief Update totalGraspMat_ from the grasp matrices of the contacts.
+      \param momentOrigin moment origin
+   */
+  void updateTotalGraspMat(const Eigen::Vector3d & momentOrigin);
+
+  /** \brief Make the key of solution cache from the current contacts and the desired total wrench.
+      \param momentOrigin moment origin
+   */
+  SolutionCache::Key makeSolutionCacheKey(const Eigen::Vector3d & momentOrigin) const;
+
+  /** \brief Project the wrench ratio from the last QP solution if Configuration::qpDecimation allows.
+      \param momentOrigin moment origin
+      \returns whether the wrench ratio is projected
+   */
+  bool projectWrenchRatio(const Eigen::Vector3d & momentOrigin);
+
+  /** \brief Store the gain matrix of the critical region of the last QP solution for projectWrenchRatio().
+      \param momentOrigin moment origin
+   */
+  void storeProjection(const Eigen::Vector3d & momentOrigin);
+
+  /** \brief Adapt friction pyramids of contacts according to the friction usage of the result.
+      \param refine whether to refine (true) or coarsen (false) friction pyramids
+      \returns whether any friction pyramid is updated
+
+      Only solverContactList_ is updated, and the contacts in contactList_ are not modified.
+   */
+  bool adaptFricPyramids(bool refine);
+
+  /** \brief Make a private copy of contact with the friction pyramid of the number of ridges.
+      \param contact contact in contactList_
+      \param ridgeNum number of ridges of friction pyramid
+   */
+  AdaptedContact makeAdaptedContact(const std::shared_ptr<Contact> & contact, int ridgeNum) const;
+
+  /** \brief Update solverContactList_ from contactList_ and synchronize the adapted copies with their sources. */
+  void updateSolverContactList();
+
+  /** \brief Setup QP coefficients of Ridge formulation. */
+  void setupRidgeQp();
+
+  /** \brief Setup QP coefficients of Wrench formulation.
+      \param momentOrigin moment origin
+   */
+  void setupWrenchQp(const Eigen::Vector3d & momentOrigin);
+
+  /** \brief Setup QP coefficients of Lifted formulation.
+      \param momentOrigin moment origin
+   */
+  void setupLiftedQp(const Eigen::Vector3d & momentOrigin);
+
+  /** \brief Setup QP coefficients of Cone formulation.
+      \param vertexForceGraspMatList list of vertex force grasp matrix of each contact with respect to the moment
+      origin
+   */
+  void setupConeQp(const std::vector<Eigen::Matrix<double, 6, Eigen::Dynamic>> & vertexForceGraspMatList);
+
+  /** \brief Solve Cone formulation by adding the tangent planes of friction cones.
+      \param momentOrigin moment origin
+   */
+  void runCone(const Eigen::Vector3d & momentOrigin);
+
+  /** \brief Solve QP of Ridge formulation with some wrench ratios fixed.
+      \param freeList list of whether each wrench ratio is optimized
+      \param fixedWrenchRatio wrench ratio whose elements not optimized are fixed
+      \returns wrench ratio where the optimized elements are replaced with the QP solution
+   */
+  Eigen::VectorXd solvePartialRidgeQp(const std::vector<bool> & freeList, const Eigen::VectorXd & fixedWrenchRatio);
+
+  /** \brief Solve Ridge formulation by the coarse-to-fine method. */
+  void runCoarseToFine();
+
+  /** \brief Calculate wrench ratio from the solution of Wrench formulation.
+      \param wrenchList list of contact wrenches around the world origin
+   */
+  void calcWrenchRatioFromWrench(const Eigen::VectorXd & wrenchList);
+
+  /** \brief Get the critical region of the last run(). */
+  const CriticalRegion & lastCriticalRegion();
+
+  /** \brief Clear the critical regions if the QP coefficients except for the desired total wrench are changed. */
+  void checkCriticalRegionKey();
+
+  /** \brief Solve QP with qpCoeff_ after exporting it if Configuration::qpExportDir is set.
+
+      If the QP solver type is "Auto", the QP solver selected by QpSolverSelector for the QP shape is used if it is
+      cached. The unseen QP shapes are benchmarked only in warmUpQpSolverSelection().
+      \returns QP solution
+   */
+  Eigen::VectorXd solveQp();
+
 protected:
   //! Configuration
   Configuration config_;
+
+  //! Contacts whose ridges correspond to resultWrenchRatio_ (see solverContactList())
+  std::vector<std::shared_ptr<Contact>> solverContactList_;
+
+  //! Adapted copy of each contact in contactList_
+  std::vector<AdaptedContact> adaptedContactList_;
+
+  //! Matrix mapping the desired total wrench to the QP objective linear vector
+  Eigen::MatrixXd objParamMat_;
+
+  //! Grasp matrices and maximum wrenches for which the critical regions are stored
+  Eigen::VectorXd criticalRegionKey_;
+
+  //! Whether qpCoeff_ is the full QP of the last run()
+  bool fullQpSetup_ = false;
+
+  //! Angles of the tangent planes of the friction cone at each vertex in the Cone formulation
+  std::vector<std::vector<double>> coneCutAngleList_;
+
+  //! Critical region of the last run() (calculated on demand)
+  std::optional<CriticalRegion> lastCriticalRegion_;
+
+  //! Number of exported QP coefficients
+  int qpExportCount_ = 0;
+
+  //! Whether to select the QP solver automatically
+  bool autoQpSolver_ = false;
+
+  //! Whether to benchmark the unseen QP shapes (only in warmUpQpSolverSelection())
+  bool qpSolverBenchmarkEnabled_ = false;
+
+  //! QP shape for which the QP solver is selected
+  QpSolverSelector::ShapeKey qpSolverShapeKey_ = {-1, -1, -1, -1};
+
+  //! QP solvers allocated for the automatic selection
+  std::map<QpSolverCollection::QpSolverType, std::shared_ptr<QpSolverCollection::QpSolver>> qpSolverMap_;
+
+  //! Number of run() calls since the last QP solve
+  int qpDecimationCount_ = 0;
+
+  //! Gain matrix of the critical region of the last QP solve for projection (empty if invalid)
+  Eigen::MatrixXd projectionGainMat_;
+
+  //! QP solution (wrench ratio in the Ridge formulation) of the last QP solve for projection
+  Eigen::VectorXd projectionSolution_;
+
+  //! Desired total wrench of the last QP solve
+  Eigen::Vector6d projectionDesiredTotalWrench_ = Eigen::Vector6d::Zero();
+
+  //! Moment origin of the last QP solve
+  Eigen::Vector3d projectionMomentOrigin_ = Eigen::Vector3d::Zero();
+
+  //! Cache of result wrench ratios
+  SolutionCache solutionCache_;
+
+  //! ID of this instance
+  size_t id_ = 0;
+
+  //! Last snapshot taken or restored, whose contact copies and QP data are shared with the next snapshot if unchanged
+  std::shared_ptr<const Snapshot> lastSnapshot_;
+
+  //! Revision of qpCoeff_ and objParamMat_ (unique over all instances, updated when they may be changed)
+  size_t qpCoeffRevision_ = 0;
+
+  //! Revision of lastCriticalRegion_ (unique over all instances, updated when it may be changed)
+  size_t lastCriticalRegionRevision_ = 0;
+
+  /** \brief Keys of the inequality rows of the contacts in qpCoeff_ (empty if qpCoeff_ is not the Ridge QP)
+
+      Only the inequality rows of the maximum wrench are written selectively, for the contacts whose local grasp
+      matrices are changed since the last setupRidgeQp(). The objective and totalGraspMat_ are rebuilt for all contacts
+      in every setup because they depend on the global contact poses and the moment origin.
+  */
+  std::vector<RidgeQpIneqKey> ridgeQpIneqKeyList_;
 };
+
+/** \brief Convert string to formulation of wrench distribution QP.
+    \param formulationStr formulation name ("Ridge", "Wrench", "Cone", or "Lifted")
+*/
+WrenchDistribution::Formulation strToFormulation(const std::string & formulationStr);
+
+/** \brief Convert formulation of wrench distribution QP to string.
+    \param formulation formulation
+*/
+std::string formulationToStr(WrenchDistribution::Formulation formulation);
 } // namespace ForceColl
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <ForceColl/WrenchDistribution.h>
+
+namespace ForceColl
+{
+/** \brief Persistent GUI binding of wrench distribution.
+
+    Unlike WrenchDistribution::addToGUI(), the GUI elements are registered once and read the markers from the buffers
+    owned by this class, which are refreshed from the result of wrench distribution by update() at a decimated rate.
+    The element names are built only when the elements are registered. The elements are registered again only when
+    the contacts, their vertices, or their ridges are changed.
+
+    The wrench distribution must not be modified while the GUI elements are evaluated.
+ */
+class WrenchDistributionGUI
+{
+public:
+  /** \brief Configuration. */
+  struct Configuration
+  {
+    //! Scale of force markers (set non-positive for no visualization)
+    double forceScale = constants::defaultForceScale;
+
+    //! Scale of friction pyramid markers (set non-positive for no visualization)
+    double fricPyramidScale = constants::defaultFricPyramidScale;
+
+    //! Number of update() calls per refresh of the markers
+    int updateDecimation = 1;
+
+    /** \brief Load mc_rtc configuration.
+        \param mcRtcConfig mc_rtc configuration
+    */
+    void load(const mc_rtc::Configuration & mcRtcConfig);
+  };
+
+protected:
+  /** \brief Markers of vertex. */
+  struct VertexMarker
+  {
+    //! Start of force arrow
+    Eigen::Vector3d arrowStart = Eigen::Vector3d::Zero();
+
+    //! End of force arrow
+    Eigen::Vector3d arrowEnd = Eigen::Vector3d::Zero();
+
+    //! Vertices of friction pyramid
+    std::vector<Eigen::Vector3d> fricPyramidVertices;
+
+    //! Triangle indices of friction pyramid
+    std::vector<std::array<size_t, 3>> fricPyramidIndices;
+  };
+
+  /** \brief Markers of contact. */
+  struct ContactMarker
+  {
+    //! Contact
+    std::shared_ptr<const Contact> contact;
+
+    //! Number of ridges at registration
+    int ridgeNum = 0;
+
+    //! Markers of vertices
+    std::vector<VertexMarker> vertexMarkerList;
+
+    //! Vertices of contact region
+    std::vector<Eigen::Vector3d> regionVertices;
+  };
+
+public:
+  /** \brief Constructor.
+      \param wrenchDist wrench distribution
+      \param gui GUI
+      \param category category of GUI entries
+      \param mcRtcConfig mc_rtc configuration
+   */
+  WrenchDistributionGUI(const std::shared_ptr<const WrenchDistribution> & wrenchDist,
+                        mc_rtc::gui::StateBuilder & gui,
+                        const std::vector<std::string> & category,
+                        const mc_rtc::Configuration & mcRtcConfig = {});
+
+  WrenchDistributionGUI(const WrenchDistributionGUI &) = delete;
+  WrenchDistributionGUI & operator=(const WrenchDistributionGUI &) = delete;
+
+  /** \brief Destructor. Remove the GUI elements. */
+  ~WrenchDistributionGUI();
+
+  /** \brief Update the markers.
+
+      Call this once per control cycle. The markers are refreshed only once in Configuration::updateDecimation calls.
+   */
+  void update();
+
+  /** \brief Refresh the markers immediately. */
+  void refresh();
+
+  /** \brief Const accessor to the configuration. */
+  inline const Configuration & config() const noexcept
+  {
+    return config_;
+  }
+
+protected:
+  /** \brief Whether the contacts, their vertices, or their ridges are changed since the registration. */
+  bool isStructureChanged() const;
+
+  /** \brief Register the GUI elements. */
+  void registerElements();
+
+  /** \brief Remove the GUI elements. */
+  void removeElements();
+
+protected:
+  //! Configuration
+  Configuration config_;
+
+  //! Wrench distribution
+  std::shared_ptr<const WrenchDistribution> wrenchDist_;
+
+  //! GUI
+  mc_rtc::gui::StateBuilder & gui_;
+
+  //! Category of GUI entries
+  std::vector<std::string> category_;
+
+  //! Markers of contacts
+  std::vector<ContactMarker> contactMarkerList_;
+
+  //! Names of registered GUI elements
+  std::vector<std::string> elementNameList_;
+
+  //! Number of update() calls since the last refresh
+  int updateCount_ = 0;
+};
+} // namespace ForceColl
@@ -0,0 +1,159 @@
+#pragma once
+
+#include <chrono>
+#include <fstream>
+#include <optional>
+
+#include <ForceColl/WrenchDistribution.h>
+
+namespace ForceColl
+{
+/** \brief Recorder of the inputs and results of WrenchDistribution::run() into a streaming binary log.
+
+    The log is a sequence of records. A setup record stores the configuration and the QP solver type of wrench
+    distribution and the local definitions of the contacts (type, name, friction pyramid, local vertices, and maximum
+    wrench), and is written only when the contacts or the QP solver are changed. A run record stores the contact poses,
+    the desired total wrench, the moment origin, the result wrench ratio, and the computation time. The log can be read
+    by WrenchDistributionLogReader and replayed by the ReplayWrenchDistribution executable.
+
+    \code{.cpp}
+    auto wrenchDist = std::make_shared<WrenchDistribution>(contactList, wrenchDistConfig);
+    WrenchDistributionRecorder recorder("/tmp/wrench_distribution.log");
+    recorder.runAndRecord(*wrenchDist, desiredTotalWrench, momentOrigin); // instead of wrenchDist->run()
+    \endcode
+ */
+class WrenchDistributionRecorder
+{
+public:
+  /** \brief Constructor.
+      \param path path of log file
+   */
+  WrenchDistributionRecorder(const std::string & path);
+
+  /** \brief Run wrench distribution and record it.
+      \param wrenchDist wrench distribution
+      \param desiredTotalWrench total wrench
+      \param momentOrigin moment origin
+      \returns total wrench of distributed result wrenches
+   */
+  sva::ForceVecd runAndRecord(WrenchDistribution & wrenchDist,
+                              const sva::ForceVecd & desiredTotalWrench,
+                              const Eigen::Vector3d & momentOrigin = Eigen::Vector3d::Zero());
+
+  /** \brief Record the last run of wrench distribution.
+      \param wrenchDist wrench distribution after WrenchDistribution::run()
+      \param momentOrigin moment origin passed to WrenchDistribution::run()
+      \param computationTime computation time of WrenchDistribution::run() [s]
+   */
+  void record(const WrenchDistribution & wrenchDist, const Eigen::Vector3d & momentOrigin, double computationTime);
+
+  /** \brief Flush the log file. */
+  void flush();
+
+  /** \brief Get the number of recorded runs. */
+  inline size_t runNum() const noexcept
+  {
+    return runNum_;
+  }
+
+protected:
+  /** \brief Whether the contacts or the QP solver are changed since the last setup record. */
+  bool isSetupChanged(const WrenchDistribution & wrenchDist) const;
+
+  /** \brief Write setup record. */
+  void writeSetup(const WrenchDistribution & wrenchDist);
+
+protected:
+  //! Log file
+  std::ofstream ofs_;
+
+  //! Contacts in the last setup record
+  std::vector<std::shared_ptr<Contact>> contactList_;
+
+  //! Local grasp matrices of contacts in the last setup record
+  std::vector<Eigen::Matrix<double, 6, Eigen::Dynamic>> localGraspMatList_;
+
+  //! Maximum wrenches of contacts in the last setup record
+  std::vector<std::optional<sva::ForceVecd>> maxWrenchList_;
+
+  //! QP solver type in the last setup record
+  QpSolverCollection::QpSolverType qpSolverType_ = QpSolverCollection::QpSolverType::Any;
+
+  //! Number of recorded runs
+  size_t runNum_ = 0;
+};
+
+/** \brief Reader of the log written by WrenchDistributionRecorder. */
+class WrenchDistributionLogReader
+{
+public:
+  /** \brief Frame of log corresponding to one run. */
+  struct Frame
+  {
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    //! Configuration of wrench distribution
+    std::shared_ptr<const mc_rtc::Configuration> config;
+
+    /** \brief List of contacts in the local definition
+
+        The list is shared by the frames until the contacts are changed. The global vertices are not updated.
+    */
+    std::shared_ptr<const std::vector<std::shared_ptr<Contact>>> contactList;
+
+    //! Index of the setup record (incremented when the contacts are changed)
+    size_t setupIdx = 0;
+
+    //! List of contact poses
+    std::vector<sva::PTransformd> poseList;
+
+    //! Desired total wrench
+    sva::ForceVecd desiredTotalWrench = sva::ForceVecd::Zero();
+
+    //! Moment origin
+    Eigen::Vector3d momentOrigin = Eigen::Vector3d::Zero();
+
+    //! Result wrench ratio
+    Eigen::VectorXd resultWrenchRatio;
+
+    //! Computation time [s]
+    double computationTime = 0;
+
+    /** \brief Make the contacts at the recorded poses.
+        \returns copies of contacts whose global vertices are updated
+     */
+    std::vector<std::shared_ptr<Contact>> makeContactList() const;
+  };
+
+public:
+  /** \brief Constructor.
+      \param path path of log file
+   */
+  WrenchDistributionLogReader(const std::string & path);
+
+  /** \brief Read next frame.
+      \returns frame (std::nullopt at the end of log)
+   */
+  std::optional<Frame> next();
+
+protected:
+  /** \brief Read setup record. */
+  void readSetup();
+
+protected:
+  //! Path of log file
+  std::string path_;
+
+  //! Log file
+  std::ifstream ifs_;
+
+  //! Configuration of wrench distribution
+  std::shared_ptr<const mc_rtc::Configuration> config_;
+
+  //! Contacts of the last setup record
+  std::shared_ptr<const std::vector<std::shared_ptr<Contact>>> contactList_;
+
+  //! Number of read setup records
+  size_t setupNum_ = 0;
+};
+} // namespace ForceColl
@@ -0,0 +1,64 @@
+#pragma once
+
+#include <ForceColl/Contact.h>
+#include <ForceColl/PolyhedralCone.h>
+
+namespace ForceColl
+{
+/** \brief Feasibility check of total wrench.
+
+    The total contact wrench cone, i.e., the set of total wrenches that can be generated by the contacts, is
+    precomputed from the grasp matrices of the contacts. The feasibility and margin of a desired total wrench are then
+    evaluated by a matrix-vector product without solving QP.
+
+    The maximum ridge force and the maximum wrench of contacts are not considered. Therefore, the feasibility is a
+    necessary condition for the existence of the contact wrenches if these limits are active.
+ */
+class WrenchFeasibility
+{
+public:
+  /** \brief Constructor.
+      \param contactList list of contact constraint
+      \param ridgeForceMin minimum ridge force
+   */
+  WrenchFeasibility(const std::vector<std::shared_ptr<Contact>> & contactList, double ridgeForceMin = 0.0);
+
+  /** \brief Update the total contact wrench cone according to the current grasp matrices of the contacts. */
+  void update();
+
+  /** \brief Calculate the margin of total wrench.
+      \param desiredTotalWrench total wrench
+      \param momentOrigin moment origin
+      \returns minimum distance to the faces of the total contact wrench cone (positive if feasible)
+
+      The distance is measured in the wrench space without scaling between moment and force.
+   */
+  double calcMargin(const sva::ForceVecd & desiredTotalWrench,
+                    const Eigen::Vector3d & momentOrigin = Eigen::Vector3d::Zero()) const;
+
+  /** \brief Whether total wrench can be generated by the contacts.
+      \param desiredTotalWrench total wrench
+      \param momentOrigin moment origin
+      \param eps tolerance
+   */
+  inline bool isFeasible(const sva::ForceVecd & desiredTotalWrench,
+                         const Eigen::Vector3d & momentOrigin = Eigen::Vector3d::Zero(),
+                         double eps = 1e-8) const
+  {
+    return calcMargin(desiredTotalWrench, momentOrigin) >= -eps;
+  }
+
+public:
+  //! List of contact constraint
+  std::vector<std::shared_ptr<Contact>> contactList_;
+
+  //! Minimum ridge force
+  double ridgeForceMin_;
+
+  //! Total contact wrench cone around the world origin
+  PolyhedralCone totalWrenchCone_;
+
+  //! Total wrench around the world origin when all ridge forces are minimum
+  sva::ForceVecd minTotalWrench_ = sva::ForceVecd::Zero();
+};
+} // namespace ForceColl
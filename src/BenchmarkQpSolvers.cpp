@@ -0,0 +1,164 @@
+#include <mc_rtc/logging.h>
+
+#include <ForceColl/QpFile.h>
+#include <ForceColl/QpSolverSelector.h>
+
+#include <chrono>
+#include <filesystem>
+#include <limits>
+#include <map>
+
+namespace
+{
+/** \brief Result of one QP solver. */
+struct SolverStats
+{
+  int solvedNum = 0;
+  int failedNum = 0;
+  double timeSum = 0;
+  double timeMax = 0;
+  double violationMax = 0;
+  double objGapMax = 0;
+};
+} // namespace
+
+/** \brief Solve the QP problems in QPS format with all QP solvers available in the build and report the computation
+    time, accuracy, and failures.
+
+    Usage: BenchmarkQpSolvers [-n <repetition number>] <QPS file or directory> ...
+
+    The QPS files can be exported by WrenchDistribution with the qpExportDir configuration.
+ */
+int main(int argc, char ** argv)
+{
+  int repeatNum = 10;
+  std::vector<std::filesystem::path> pathList;
+  for(int i = 1; i < argc; i++)
+  {
+    std::string arg = argv[i];
+    if(arg == "-n" && i + 1 < argc)
+    {
+      repeatNum = std::max(std::stoi(argv[++i]), 1);
+    }
+    else if(std::filesystem::is_directory(arg))
+    {
+      for(const auto & entry : std::filesystem::directory_iterator(arg))
+      {
+        if(entry.path().extension() == ".qps")
+        {
+          pathList.push_back(entry.path());
+        }
+      }
+    }
+    else
+    {
+      pathList.push_back(arg);
+    }
+  }
+  std::sort(pathList.begin(), pathList.end());
+  if(pathList.empty())
+  {
+    mc_rtc::log::error("Usage: {} [-n <repetition number>] <QPS file or directory> ...", argv[0]);
+    return 1;
+  }
+
+  std::vector<QpSolverCollection::QpSolverType> qpSolverTypeList =
+      ForceColl::QpSolverSelector::availableQpSolverTypes();
+  if(qpSolverTypeList.empty())
+  {
+    mc_rtc::log::error("[BenchmarkQpSolvers] No QP solver is available.");
+    return 1;
+  }
+
+  std::map<QpSolverCollection::QpSolverType, std::shared_ptr<QpSolverCollection::QpSolver>> qpSolverMap;
+  std::map<QpSolverCollection::QpSolverType, SolverStats> statsMap;
+  for(const auto & qpSolverType : qpSolverTypeList)
+  {
+    qpSolverMap[qpSolverType] = QpSolverCollection::allocateQpSolver(qpSolverType);
+    statsMap[qpSolverType] = SolverStats();
+  }
+
+  for(const auto & path : pathList)
+  {
+    QpSolverCollection::QpCoeff qpCoeff;
+    try
+    {
+      qpCoeff = ForceColl::readQps(path.string());
+    }
+    catch(const std::exception & e)
+    {
+      mc_rtc::log::warning("[BenchmarkQpSolvers] Skip {}: {}", path.string(), e.what());
+      continue;
+    }
+
+    // Solve with all QP solvers
+    std::map<QpSolverCollection::QpSolverType, double> objMap;
+    double objMin = std::numeric_limits<double>::infinity();
+    for(const auto & qpSolverType : qpSolverTypeList)
+    {
+      auto & stats = statsMap[qpSolverType];
+      auto & qpSolver = qpSolverMap[qpSolverType];
+      bool failed = false;
+      Eigen::VectorXd x;
+      double timeMin = std::numeric_limits<double>::infinity();
+      try
+      {
+        for(int i = 0; i < repeatNum; i++)
+        {
+          QpSolverCollection::QpCoeff qpCoeffCopy = qpCoeff;
+          auto startTime = std::chrono::steady_clock::now();
+          x = qpSolver->solve(qpCoeffCopy);
+          timeMin = std::min(timeMin,
+                             std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count());
+          failed = failed || qpSolver->solveFailed();
+        }
+      }
+      catch(const std::exception & e)
+      {
+        mc_rtc::log::warning("[BenchmarkQpSolvers] {} threw exception for {}: {}", std::to_string(qpSolverType),
+                             path.string(), e.what());
+        failed = true;
+      }
+      double violation = std::numeric_limits<double>::infinity();
+      if(!failed && x.size() == qpCoeff.dim_var_ && x.allFinite())
+      {
+        violation = ForceColl::QpSolverSelector::calcViolation(qpCoeff, x);
+      }
+      if(failed || !(violation <= ForceColl::QpSolverSelector::violationThre))
+      {
+        stats.failedNum++;
+        continue;
+      }
+
+      double obj = ForceColl::QpSolverSelector::calcObjective(qpCoeff, x);
+      objMap[qpSolverType] = obj;
+      objMin = std::min(objMin, obj);
+      stats.solvedNum++;
+      stats.timeSum += timeMin;
+      stats.timeMax = std::max(stats.timeMax, timeMin);
+      stats.violationMax = std::max(stats.violationMax, violation);
+    }
+
+    // The objective gap is relative to the best solver
+    for(const auto & [qpSolverType, obj] : objMap)
+    {
+      auto & stats = statsMap[qpSolverType];
+      stats.objGapMax = std::max(stats.objGapMax, (obj - objMin) / std::max(1.0, std::abs(objMin)));
+    }
+  }
+
+  mc_rtc::log::info("[BenchmarkQpSolvers] {} problems, {} repetitions (minimum time is used)", pathList.size(),
+                    repeatNum);
+  mc_rtc::log::info("{:>10} {:>8} {:>8} {:>14} {:>14} {:>14} {:>14}", "solver", "solved", "failed", "mean time [ms]",
+                    "max time [ms]", "max violation", "max obj gap");
+  for(const auto & qpSolverType : qpSolverTypeList)
+  {
+    const auto & stats = statsMap[qpSolverType];
+    double timeMean = (stats.solvedNum > 0 ? stats.timeSum / stats.solvedNum : 0.0);
+    mc_rtc::log::info("{:>10} {:>8} {:>8} {:>14.4f} {:>14.4f} {:>14.3e} {:>14.3e}", std::to_string(qpSolverType),
+                      stats.solvedNum, stats.failedNum, 1e3 * timeMean, 1e3 * stats.timeMax, stats.violationMax,
+                      stats.objGapMax);
+  }
+
+  return 0;
+}
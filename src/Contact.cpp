@@ -6,16 +6,146 @@
 #include <mc_rtc/logging.h>
 
 #include <ForceColl/Contact.h>
+#include <ForceColl/ContactGeometry.h>
+#include <ForceColl/ShapeRegistry.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <tuple>
 
 using namespace ForceColl;
 
-FrictionPyramid::FrictionPyramid(double fricCoeff, int ridgeNum)
+namespace
 {
+constexpr double sqrt3Half = 0.86602540378443865;
+constexpr double sqrt2Half = 0.70710678118654752;
+constexpr double cos22_5 = 0.92387953251128674;
+constexpr double sin22_5 = 0.38268343236508977;
+
+//! Unit circle tables of (cos, sin) at equally spaced angles from zero
+constexpr std::array<std::array<double, 2>, 3> unitCircle3 = {{{1, 0}, {-0.5, sqrt3Half}, {-0.5, -sqrt3Half}}};
+constexpr std::array<std::array<double, 2>, 4> unitCircle4 = {{{1, 0}, {0, 1}, {-1, 0}, {0, -1}}};
+constexpr std::array<std::array<double, 2>, 6> unitCircle6 = {
+    {{1, 0}, {0.5, sqrt3Half}, {-0.5, sqrt3Half}, {-1, 0}, {-0.5, -sqrt3Half}, {0.5, -sqrt3Half}}};
+constexpr std::array<std::array<double, 2>, 8> unitCircle8 = {{{1, 0},
+                                                              {sqrt2Half, sqrt2Half},
+                                                              {0, 1},
+                                                              {-sqrt2Half, sqrt2Half},
+                                                              {-1, 0},
+                                                              {-sqrt2Half, -sqrt2Half},
+                                                              {0, -1},
+                                                              {sqrt2Half, -sqrt2Half}}};
+constexpr std::array<std::array<double, 2>, 12> unitCircle12 = {{{1, 0},
+                                                                {sqrt3Half, 0.5},
+                                                                {0.5, sqrt3Half},
+                                                                {0, 1},
+                                                                {-0.5, sqrt3Half},
+                                                                {-sqrt3Half, 0.5},
+                                                                {-1, 0},
+                                                                {-sqrt3Half, -0.5},
+                                                                {-0.5, -sqrt3Half},
+                                                                {0, -1},
+                                                                {0.5, -sqrt3Half},
+                                                                {sqrt3Half, -0.5}}};
+constexpr std::array<std::array<double, 2>, 16> unitCircle16 = {{{1, 0},
+                                                                {cos22_5, sin22_5},
+                                                                {sqrt2Half, sqrt2Half},
+                                                                {sin22_5, cos22_5},
+                                                                {0, 1},
+                                                                {-sin22_5, cos22_5},
+                                                                {-sqrt2Half, sqrt2Half},
+                                                                {-cos22_5, sin22_5},
+                                                                {-1, 0},
+                                                                {-cos22_5, -sin22_5},
+                                                                {-sqrt2Half, -sqrt2Half},
+                                                                {-sin22_5, -cos22_5},
+                                                                {0, -1},
+                                                                {sin22_5, -cos22_5},
+                                                                {sqrt2Half, -sqrt2Half},
+                                                                {cos22_5, -sin22_5}}};
+
+/** \brief Get unit circle table.
+    \param ridgeNum number of ridges
+    \returns pointer to the table (nullptr if no table is available)
+*/
+const std::array<double, 2> * getUnitCircleTable(int ridgeNum)
+{
+  switch(ridgeNum)
+  {
+    case 3:
+      return unitCircle3.data();
+    case 4:
+      return unitCircle4.data();
+    case 6:
+      return unitCircle6.data();
+    case 8:
+      return unitCircle8.data();
+    case 12:
+      return unitCircle12.data();
+    case 16:
+      return unitCircle16.data();
+    default:
+      return nullptr;
+  }
+}
+
+//! Last revision of local grasp matrix over all contacts
+std::atomic<size_t> lastLocalGraspMatRevision(0);
+} // namespace
+
+std::shared_ptr<const FrictionPyramid> FrictionPyramid::makeShared(double fricCoeff, int ridgeNum)
+{
+  static std::mutex registryMutex;
+  static std::map<std::pair<double, int>, std::weak_ptr<const FrictionPyramid>> registry;
+
+  std::lock_guard<std::mutex> lock(registryMutex);
+
+  // Remove the entries whose pyramids have been destroyed so that the registry does not grow unboundedly
+  for(auto it = registry.begin(); it != registry.end();)
+  {
+    it = it->second.expired() ? registry.erase(it) : std::next(it);
+  }
+
+  auto & fricPyramidWeak = registry[std::make_pair(fricCoeff, ridgeNum)];
+  std::shared_ptr<const FrictionPyramid> fricPyramid = fricPyramidWeak.lock();
+  if(!fricPyramid)
+  {
+    fricPyramid = std::make_shared<FrictionPyramid>(fricCoeff, ridgeNum);
+    fricPyramidWeak = fricPyramid;
+  }
+  return fricPyramid;
+}
+
+bool FrictionPyramid::isSupportedRidgeNum(int ridgeNum)
+{
+  // The numbers without the unit circle table are supported by the trigonometric functions
+  return ridgeNum >= 3;
+}
+
+FrictionPyramid::FrictionPyramid(double fricCoeff, int ridgeNum) : fricCoeff_(fricCoeff)
+{
+  const std::array<double, 2> * unitCircleTable = getUnitCircleTable(ridgeNum);
+  localRidgeList_.reserve(static_cast<size_t>(std::max(ridgeNum, 0)));
   for(int i = 0; i < ridgeNum; i++)
   {
-    double theta = 2 * mc_rtc::constants::PI * (static_cast<double>(i) / ridgeNum);
-    localRidgeList_.push_back(
-        Eigen::Vector3d(fricCoeff * std::cos(theta), fricCoeff * std::sin(theta), 1).normalized());
+    double cosTheta, sinTheta;
+    if(unitCircleTable)
+    {
+      cosTheta = unitCircleTable[i][0];
+      sinTheta = unitCircleTable[i][1];
+    }
+    else
+    {
+      double theta = 2 * mc_rtc::constants::PI * (static_cast<double>(i) / ridgeNum);
+      cosTheta = std::cos(theta);
+      sinTheta = std::sin(theta);
+    }
+    localRidgeList_.push_back(Eigen::Vector3d(fricCoeff * cosTheta, fricCoeff * sinTheta, 1).normalized());
   }
 }
 
@@ -52,30 +182,47 @@ std::shared_ptr<Contact> Contact::makeSharedFromConfig(const mc_rtc::Configurati
 
 Contact::Contact(const std::string & name, std::optional<sva::ForceVecd> maxWrench) : name_(name), maxWrench_(maxWrench)
 {
+  markLocalGraspMatChanged();
 }
 
-sva::ForceVecd Contact::calcWrench(const Eigen::VectorXd & wrenchRatio, const Eigen::Vector3d & momentOrigin) const
+void Contact::updateFricPyramid(const std::shared_ptr<const FrictionPyramid> & fricPyramid)
 {
-  sva::ForceVecd totalWrench = sva::ForceVecd::Zero();
-  int wrenchRatioIdx = 0;
+  fricPyramid_ = fricPyramid;
+}
 
-  for(const auto & vertexWithRidge : vertexWithRidgeList_)
+Eigen::Matrix<double, 6, Eigen::Dynamic> Contact::calcVertexForceGraspMat() const
+{
+  return Eigen::Matrix<double, 6, Eigen::Dynamic>(6, 0);
+}
+
+double Contact::calcFricUsage(const Eigen::VectorXd & wrenchRatio) const
+{
+  if(!fricPyramid_ || fricPyramid_->ridgeNum() == 0 || fricPyramid_->fricCoeff_ <= 0)
   {
-    const Eigen::Vector3d & vertex = vertexWithRidge.vertex;
-    const std::vector<Eigen::Vector3d> & ridgeList = vertexWithRidge.ridgeList;
+    return 0.0;
+  }
 
-    for(const auto & ridge : ridgeList)
+  double fricUsage = 0.0;
+  const int vertexRidgeNum = fricPyramid_->ridgeNum();
+  for(Eigen::DenseIndex vertexIdx = 0; vertexIdx < wrenchRatio.size() / vertexRidgeNum; vertexIdx++)
+  {
+    // Force in the frame of friction pyramid
+    Eigen::Vector3d force = Eigen::Vector3d::Zero();
+    for(int ridgeIdx = 0; ridgeIdx < vertexRidgeNum; ridgeIdx++)
+    {
+      force += wrenchRatio(vertexIdx * vertexRidgeNum + ridgeIdx) * fricPyramid_->localRidgeList_[ridgeIdx];
+    }
+    if(force.z() > 0)
     {
-      Eigen::Vector3d force = wrenchRatio(wrenchRatioIdx) * ridge;
-      totalWrench.force() += force;
-      totalWrench.moment() += (vertex - momentOrigin).cross(force);
-      wrenchRatioIdx++;
+      fricUsage = std::max(fricUsage, force.head<2>().norm() / (fricPyramid_->fricCoeff_ * force.z()));
     }
   }
+  return fricUsage;
+}
 
-  assert(wrenchRatio.size() == wrenchRatioIdx);
-
-  return totalWrench;
+sva::ForceVecd Contact::calcWrench(const Eigen::VectorXd & wrenchRatio, const Eigen::Vector3d & momentOrigin) const
+{
+  return {ContactGeometry<double>::calcWrench(graspMat_, wrenchRatio, momentOrigin)};
 }
 
 sva::ForceVecd Contact::calcLocalWrench(const Eigen::VectorXd & wrenchRatio) const
@@ -84,6 +231,39 @@ sva::ForceVecd Contact::calcLocalWrench(const Eigen::VectorXd & wrenchRatio) con
   return {localGraspMat_ * wrenchRatio};
 }
 
+const PolyhedralCone & Contact::localWrenchCone() const
+{
+  if(!localWrenchCone_)
+  {
+    localWrenchCone_ = PolyhedralCone::makeFromSpan(localGraspMat_);
+  }
+  return *localWrenchCone_;
+}
+
+const PolyhedralCone & Contact::wrenchCone() const
+{
+  if(!wrenchCone_)
+  {
+    // The local wrench is pose_.dualMul(globalWrench)
+    wrenchCone_ = localWrenchCone().transform(pose_.dualMatrix());
+  }
+  return *wrenchCone_;
+}
+
+void Contact::markLocalGraspMatChanged()
+{
+  localGraspMatRevision_ = ++lastLocalGraspMatRevision;
+}
+
+void Contact::clearWrenchCone(bool local)
+{
+  if(local)
+  {
+    localWrenchCone_.reset();
+  }
+  wrenchCone_.reset();
+}
+
 void Contact::addToGUI(mc_rtc::gui::StateBuilder & gui,
                        const std::vector<std::string> & category,
                        double forceScale,
@@ -188,7 +368,7 @@ SurfaceContact::SurfaceContact(const std::string & name,
                                std::optional<sva::ForceVecd> maxWrench)
 : Contact(name, std::move(maxWrench))
 {
-  fricPyramid_ = std::make_shared<FrictionPyramid>(fricCoeff);
+  fricPyramid_ = FrictionPyramid::makeShared(fricCoeff);
   updateLocalVertices(localVertices);
   updateGlobalVertices(pose);
 }
@@ -200,51 +380,135 @@ SurfaceContact::SurfaceContact(const mc_rtc::Configuration & mcRtcConfig)
                  mcRtcConfig("pose"),
                  mcRtcConfig("maxWrench", std::optional<sva::ForceVecd>{}))
 {
+  if(mcRtcConfig.has("vertexPruningTolerance"))
+  {
+    vertexPruningTolerance_ = static_cast<double>(mcRtcConfig("vertexPruningTolerance"));
+    updateLocalVertices(localVertices_);
+    updateGlobalVertices(pose_);
+  }
+}
+
+SurfaceContact::SurfaceContact(const std::string & name,
+                               const std::shared_ptr<const SurfaceShape> & shape,
+                               const sva::PTransformd & pose,
+                               std::optional<sva::ForceVecd> maxWrench)
+: Contact(name, std::move(maxWrench))
+{
+  fricPyramid_ = shape->fricPyramid;
+  localVertices_ = shape->localVertices;
+  localGraspMat_ = shape->localGraspMat;
+  markLocalGraspMatChanged();
+  updateGlobalVertices(pose);
 }
 
 void SurfaceContact::updateLocalVertices(const std::vector<Eigen::Vector3d> & localVertices)
 {
-  localVertices_.resize(localVertices.size());
-  std::copy(localVertices.begin(), localVertices.end(), localVertices_.begin());
+  clearWrenchCone(true);
+
+  if(vertexPruningTolerance_)
+  {
+    localVertices_ = calcSupportPolygonVertices(localVertices, *vertexPruningTolerance_);
+  }
+  else
+  {
+    localVertices_.resize(localVertices.size());
+    std::copy(localVertices.begin(), localVertices.end(), localVertices_.begin());
+  }
 
   localGraspMat_.resize(6, static_cast<Eigen::DenseIndex>(localVertices_.size()) * fricPyramid_->ridgeNum());
   for(size_t vertexIdx = 0; vertexIdx < localVertices_.size(); vertexIdx++)
   {
-    const auto & localVertex = localVertices_[vertexIdx];
-    for(size_t ridgeIdx = 0; ridgeIdx < fricPyramid_->localRidgeList_.size(); ridgeIdx++)
+    updateLocalGraspMatCols(vertexIdx);
+  }
+  markLocalGraspMatChanged();
+}
+
+bool SurfaceContact::updateLocalVerticesInPlace(const std::vector<Eigen::Vector3d> & localVertices)
+{
+  if(vertexPruningTolerance_ || localVertices.size() != localVertices_.size())
+  {
+    updateLocalVertices(localVertices);
+    return true;
+  }
+
+  bool changed = false;
+  for(size_t vertexIdx = 0; vertexIdx < localVertices_.size(); vertexIdx++)
+  {
+    if(localVertices[vertexIdx] != localVertices_[vertexIdx])
     {
-      const auto & localRidge = fricPyramid_->localRidgeList_[ridgeIdx];
-      auto colIdx = static_cast<Eigen::DenseIndex>(vertexIdx) * fricPyramid_->ridgeNum()
-                    + static_cast<Eigen::DenseIndex>(ridgeIdx);
-      // The top 3 rows are moment, the bottom 3 rows are force.
-      localGraspMat_.col(colIdx) << localVertex.cross(localRidge), localRidge;
+      localVertices_[vertexIdx] = localVertices[vertexIdx];
+      updateLocalGraspMatCols(vertexIdx);
+      changed = true;
     }
   }
+  if(changed)
+  {
+    clearWrenchCone(true);
+    markLocalGraspMatChanged();
+  }
+  return changed;
+}
+
+void SurfaceContact::updateLocalGraspMatCols(size_t vertexIdx)
+{
+  const auto & localVertex = localVertices_[vertexIdx];
+  for(size_t ridgeIdx = 0; ridgeIdx < fricPyramid_->localRidgeList_.size(); ridgeIdx++)
+  {
+    const auto & localRidge = fricPyramid_->localRidgeList_[ridgeIdx];
+    auto colIdx =
+        static_cast<Eigen::DenseIndex>(vertexIdx) * fricPyramid_->ridgeNum() + static_cast<Eigen::DenseIndex>(ridgeIdx);
+    // The top 3 rows are moment, the bottom 3 rows are force.
+    localGraspMat_.col(colIdx) << localVertex.cross(localRidge), localRidge;
+  }
 }
 
 void SurfaceContact::updateGlobalVertices(const sva::PTransformd & pose)
 {
+  pose_ = pose;
+  clearWrenchCone(false);
+
   graspMat_.resize(6, static_cast<Eigen::DenseIndex>(localVertices_.size()) * fricPyramid_->ridgeNum());
-  vertexWithRidgeList_.clear();
+  if(vertexWithRidgeList_.size() != localVertices_.size())
+  {
+    vertexWithRidgeList_.assign(localVertices_.size(), VertexWithRidge(Eigen::Vector3d::Zero(), {}));
+  }
+
+  ContactGeometry<double>::transformGraspMat(localGraspMat_, pose, graspMat_);
 
   const auto & globalRidgeList = fricPyramid_->calcGlobalRidgeList(pose.rotation().transpose());
 
+  // The elements are assigned in place to avoid reallocation if the number of vertices is unchanged
   for(size_t vertexIdx = 0; vertexIdx < localVertices_.size(); vertexIdx++)
   {
     const auto & localVertex = localVertices_[vertexIdx];
-    Eigen::Vector3d globalVertex = (sva::PTransformd(localVertex) * pose).translation();
+    auto & vertexWithRidge = vertexWithRidgeList_[vertexIdx];
+    vertexWithRidge.vertex = (sva::PTransformd(localVertex) * pose).translation();
+    vertexWithRidge.ridgeList = globalRidgeList;
+  }
+}
 
-    for(size_t ridgeIdx = 0; ridgeIdx < globalRidgeList.size(); ridgeIdx++)
+void SurfaceContact::updateFricPyramid(const std::shared_ptr<const FrictionPyramid> & fricPyramid)
+{
+  Contact::updateFricPyramid(fricPyramid);
+  updateLocalVertices(localVertices_);
+  updateGlobalVertices(pose_);
+}
+
+Eigen::Matrix<double, 6, Eigen::Dynamic> SurfaceContact::calcVertexForceGraspMat() const
+{
+  Eigen::Matrix<double, 6, Eigen::Dynamic> vertexForceGraspMat(6, 3 * localVertices_.size());
+  Eigen::Matrix3d rot = pose_.rotation().transpose();
+  for(size_t vertexIdx = 0; vertexIdx < localVertices_.size(); vertexIdx++)
+  {
+    Eigen::Vector3d globalVertex = (sva::PTransformd(localVertices_[vertexIdx]) * pose_).translation();
+    for(int i = 0; i < 3; i++)
     {
-      const auto & globalRidge = globalRidgeList[ridgeIdx];
-      auto colIdx = static_cast<Eigen::DenseIndex>(vertexIdx) * fricPyramid_->ridgeNum()
-                    + static_cast<Eigen::DenseIndex>(ridgeIdx);
       // The top 3 rows are moment, the bottom 3 rows are force.
-      graspMat_.col(colIdx) << globalVertex.cross(globalRidge), globalRidge;
+      vertexForceGraspMat.col(3 * static_cast<Eigen::DenseIndex>(vertexIdx) + i) << globalVertex.cross(rot.col(i)),
+          rot.col(i);
     }
-
-    vertexWithRidgeList_.push_back(VertexWithRidge(globalVertex, globalRidgeList));
   }
+  return vertexForceGraspMat;
 }
 
 void SurfaceContact::addToGUI(mc_rtc::gui::StateBuilder & gui,
@@ -282,7 +546,7 @@ GraspContact::GraspContact(const std::string & name,
                            std::optional<sva::ForceVecd> maxWrench)
 : Contact(name, std::move(maxWrench))
 {
-  fricPyramid_ = std::make_shared<FrictionPyramid>(fricCoeff);
+  fricPyramid_ = FrictionPyramid::makeShared(fricCoeff);
   updateLocalVertices(localVertices);
   updateGlobalVertices(pose);
 }
@@ -296,8 +560,23 @@ GraspContact::GraspContact(const mc_rtc::Configuration & mcRtcConfig)
 {
 }
 
+GraspContact::GraspContact(const std::string & name,
+                           const std::shared_ptr<const GraspShape> & shape,
+                           const sva::PTransformd & pose,
+                           std::optional<sva::ForceVecd> maxWrench)
+: Contact(name, std::move(maxWrench))
+{
+  fricPyramid_ = shape->fricPyramid;
+  localVertices_ = shape->localVertices;
+  localGraspMat_ = shape->localGraspMat;
+  markLocalGraspMatChanged();
+  updateGlobalVertices(pose);
+}
+
 void GraspContact::updateLocalVertices(const std::vector<sva::PTransformd> & localVertices)
 {
+  clearWrenchCone(true);
+
   localVertices_.resize(localVertices.size());
   std::copy(localVertices.begin(), localVertices.end(), localVertices_.begin());
 
@@ -305,43 +584,99 @@ void GraspContact::updateLocalVertices(const std::vector<sva::PTransformd> & loc
 
   for(size_t vertexIdx = 0; vertexIdx < localVertices_.size(); vertexIdx++)
   {
-    const auto & localVertexPose = localVertices_[vertexIdx];
-    const auto & localVertex = localVertexPose.translation();
-    const auto & localRidgeList = fricPyramid_->calcGlobalRidgeList(localVertexPose.rotation().transpose());
-    for(size_t ridgeIdx = 0; ridgeIdx < localRidgeList.size(); ridgeIdx++)
+    updateLocalGraspMatCols(vertexIdx);
+  }
+  markLocalGraspMatChanged();
+}
+
+bool GraspContact::updateLocalVerticesInPlace(const std::vector<sva::PTransformd> & localVertices)
+{
+  if(localVertices.size() != localVertices_.size())
+  {
+    updateLocalVertices(localVertices);
+    return true;
+  }
+
+  bool changed = false;
+  for(size_t vertexIdx = 0; vertexIdx < localVertices_.size(); vertexIdx++)
+  {
+    if(localVertices[vertexIdx] != localVertices_[vertexIdx])
     {
-      const auto & localRidge = localRidgeList[ridgeIdx];
-      auto colIdx = static_cast<Eigen::DenseIndex>(vertexIdx) * fricPyramid_->ridgeNum()
-                    + static_cast<Eigen::DenseIndex>(ridgeIdx);
-      // The top 3 rows are moment, the bottom 3 rows are force.
-      localGraspMat_.col(colIdx) << localVertex.cross(localRidge), localRidge;
+      localVertices_[vertexIdx] = localVertices[vertexIdx];
+      updateLocalGraspMatCols(vertexIdx);
+      changed = true;
     }
   }
+  if(changed)
+  {
+    clearWrenchCone(true);
+    markLocalGraspMatChanged();
+  }
+  return changed;
+}
+
+void GraspContact::updateLocalGraspMatCols(size_t vertexIdx)
+{
+  const auto & localVertexPose = localVertices_[vertexIdx];
+  const auto & localVertex = localVertexPose.translation();
+  const auto & localRidgeList = fricPyramid_->calcGlobalRidgeList(localVertexPose.rotation().transpose());
+  for(size_t ridgeIdx = 0; ridgeIdx < localRidgeList.size(); ridgeIdx++)
+  {
+    const auto & localRidge = localRidgeList[ridgeIdx];
+    auto colIdx =
+        static_cast<Eigen::DenseIndex>(vertexIdx) * fricPyramid_->ridgeNum() + static_cast<Eigen::DenseIndex>(ridgeIdx);
+    // The top 3 rows are moment, the bottom 3 rows are force.
+    localGraspMat_.col(colIdx) << localVertex.cross(localRidge), localRidge;
+  }
 }
 
 void GraspContact::updateGlobalVertices(const sva::PTransformd & pose)
 {
+  pose_ = pose;
+  clearWrenchCone(false);
+
   graspMat_.resize(6, static_cast<Eigen::DenseIndex>(localVertices_.size()) * fricPyramid_->ridgeNum());
-  vertexWithRidgeList_.clear();
+  if(vertexWithRidgeList_.size() != localVertices_.size())
+  {
+    vertexWithRidgeList_.assign(localVertices_.size(), VertexWithRidge(Eigen::Vector3d::Zero(), {}));
+  }
 
+  ContactGeometry<double>::transformGraspMat(localGraspMat_, pose, graspMat_);
+
+  // The elements are assigned in place to avoid reallocation if the number of vertices is unchanged
   for(size_t vertexIdx = 0; vertexIdx < localVertices_.size(); vertexIdx++)
   {
     const auto & localVertexPose = localVertices_[vertexIdx];
     sva::PTransformd globalVertexPose = sva::PTransformd(localVertexPose) * pose;
-    const auto & globalVertex = globalVertexPose.translation();
-    const auto & globalRidgeList = fricPyramid_->calcGlobalRidgeList(globalVertexPose.rotation().transpose());
+    auto & vertexWithRidge = vertexWithRidgeList_[vertexIdx];
+    vertexWithRidge.vertex = globalVertexPose.translation();
+    vertexWithRidge.ridgeList = fricPyramid_->calcGlobalRidgeList(globalVertexPose.rotation().transpose());
+  }
+}
 
-    for(size_t ridgeIdx = 0; ridgeIdx < globalRidgeList.size(); ridgeIdx++)
+void GraspContact::updateFricPyramid(const std::shared_ptr<const FrictionPyramid> & fricPyramid)
+{
+  Contact::updateFricPyramid(fricPyramid);
+  updateLocalVertices(localVertices_);
+  updateGlobalVertices(pose_);
+}
+
+Eigen::Matrix<double, 6, Eigen::Dynamic> GraspContact::calcVertexForceGraspMat() const
+{
+  Eigen::Matrix<double, 6, Eigen::Dynamic> vertexForceGraspMat(6, 3 * localVertices_.size());
+  for(size_t vertexIdx = 0; vertexIdx < localVertices_.size(); vertexIdx++)
+  {
+    sva::PTransformd globalVertexPose = sva::PTransformd(localVertices_[vertexIdx]) * pose_;
+    const auto & globalVertex = globalVertexPose.translation();
+    Eigen::Matrix3d rot = globalVertexPose.rotation().transpose();
+    for(int i = 0; i < 3; i++)
     {
-      const auto & globalRidge = globalRidgeList[ridgeIdx];
-      auto colIdx = static_cast<Eigen::DenseIndex>(vertexIdx) * fricPyramid_->ridgeNum()
-                    + static_cast<Eigen::DenseIndex>(ridgeIdx);
       // The top 3 rows are moment, the bottom 3 rows are force.
-      graspMat_.col(colIdx) << globalVertex.cross(globalRidge), globalRidge;
+      vertexForceGraspMat.col(3 * static_cast<Eigen::DenseIndex>(vertexIdx) + i) << globalVertex.cross(rot.col(i)),
+          rot.col(i);
     }
-
-    vertexWithRidgeList_.push_back(VertexWithRidge(globalVertex, globalRidgeList));
   }
+  return vertexForceGraspMat;
 }
 
 void GraspContact::addToGUI(mc_rtc::gui::StateBuilder & gui,
@@ -405,3 +740,90 @@ std::vector<sva::ForceVecd> ForceColl::calcLocalWrenchList(const std::vector<std
   }
   return wrenchList;
 }
+
+std::vector<Eigen::Vector3d> ForceColl::calcSupportPolygonVertices(const std::vector<Eigen::Vector3d> & localVertices,
+                                                                   double simplifyTolerance)
+{
+  constexpr double eps = 1e-10;
+
+  // Sort the vertices by the quantized z, x, and y so that the vertices in the same plane are contiguous
+  // The z coordinate is quantized because the comparison with a tolerance is not a strict weak ordering
+  auto calcPlaneKey = [&](const Eigen::Vector3d & v) { return std::llround(v.z() / eps); };
+  std::vector<Eigen::Vector3d> sortedVertices = localVertices;
+  std::sort(sortedVertices.begin(), sortedVertices.end(), [&](const Eigen::Vector3d & v1, const Eigen::Vector3d & v2) {
+    return std::make_tuple(calcPlaneKey(v1), v1.x(), v1.y()) < std::make_tuple(calcPlaneKey(v2), v2.x(), v2.y());
+  });
+
+  auto cross = [](const Eigen::Vector3d & o, const Eigen::Vector3d & a, const Eigen::Vector3d & b) {
+    return (a.x() - o.x()) * (b.y() - o.y()) - (a.y() - o.y()) * (b.x() - o.x());
+  };
+
+  std::vector<Eigen::Vector3d> supportVertices;
+  for(auto groupBegin = sortedVertices.begin(); groupBegin != sortedVertices.end();)
+  {
+    auto groupEnd = std::find_if(groupBegin, sortedVertices.end(), [&](const Eigen::Vector3d & v) {
+      return calcPlaneKey(v) != calcPlaneKey(*groupBegin);
+    });
+
+    // Calculate the convex hull by the monotone chain algorithm, excluding the vertices on the edges
+    std::vector<Eigen::Vector3d> hullVertices;
+    for(int pass = 0; pass < 2; pass++)
+    {
+      size_t chainBegin = hullVertices.size();
+      auto addVertex = [&](const Eigen::Vector3d & v) {
+        while(hullVertices.size() >= chainBegin + 2
+              && cross(hullVertices[hullVertices.size() - 2], hullVertices.back(), v) <= eps)
+        {
+          hullVertices.pop_back();
+        }
+        hullVertices.push_back(v);
+      };
+      if(pass == 0)
+      {
+        std::for_each(groupBegin, groupEnd, addVertex);
+      }
+      else
+      {
+        std::for_each(std::make_reverse_iterator(groupEnd), std::make_reverse_iterator(groupBegin), addVertex);
+      }
+      // The last vertex of each chain is the first vertex of the other chain
+      hullVertices.pop_back();
+    }
+    if(hullVertices.empty())
+    {
+      hullVertices.push_back(*groupBegin);
+    }
+    else if(hullVertices.size() == 2 && (hullVertices[0] - hullVertices[1]).norm() < eps)
+    {
+      hullVertices.pop_back();
+    }
+
+    // Remove the vertices close to the segment between their neighbors
+    while(simplifyTolerance > 0 && hullVertices.size() > 3)
+    {
+      double minDist = simplifyTolerance;
+      size_t minDistIdx = hullVertices.size();
+      for(size_t i = 0; i < hullVertices.size(); i++)
+      {
+        const auto & prevVertex = hullVertices[(i + hullVertices.size() - 1) % hullVertices.size()];
+        const auto & nextVertex = hullVertices[(i + 1) % hullVertices.size()];
+        double dist = cross(prevVertex, nextVertex, hullVertices[i]) / (nextVertex - prevVertex).head<2>().norm();
+        if(std::abs(dist) < minDist)
+        {
+          minDist = std::abs(dist);
+          minDistIdx = i;
+        }
+      }
+      if(minDistIdx == hullVertices.size())
+      {
+        break;
+      }
+      hullVertices.erase(hullVertices.begin() + static_cast<long>(minDistIdx));
+    }
+
+    supportVertices.insert(supportVertices.end(), hullVertices.begin(), hullVertices.end());
+    groupBegin = groupEnd;
+  }
+
+  return supportVertices;
+}
@@ -0,0 +1,7 @@
+#include <ForceColl/ContactGeometry.h>
+
+namespace ForceColl
+{
+template class ContactGeometry<double>;
+template class ContactGeometry<float>;
+} // namespace ForceColl
@@ -0,0 +1,481 @@
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <mc_rtc/logging.h>
+
+#include <ForceColl/ContactLibrary.h>
+
+#include <cstring>
+#include <fstream>
+#include <map>
+
+using namespace ForceColl;
+
+namespace
+{
+constexpr std::uint32_t byteOrderMark = 0x01020304;
+
+/** \brief Append POD value to buffer and return its byte offset. */
+template<class T>
+std::uint64_t appendToBuffer(std::vector<std::uint8_t> & buffer, const T & value)
+{
+  std::uint64_t offset = buffer.size();
+  buffer.resize(buffer.size() + sizeof(T));
+  std::memcpy(buffer.data() + offset, &value, sizeof(T));
+  return offset;
+}
+
+/** \brief Store pose to array. */
+void storePose(const sva::PTransformd & pose, double * data)
+{
+  Eigen::Map<Eigen::Matrix3d> rotData(data);
+  Eigen::Map<Eigen::Vector3d> transData(data + 9);
+  rotData = pose.rotation();
+  transData = pose.translation();
+}
+
+/** \brief Load pose from array. */
+sva::PTransformd loadPose(const double * data)
+{
+  return sva::PTransformd(Eigen::Map<const Eigen::Matrix3d>(data), Eigen::Map<const Eigen::Vector3d>(data + 9));
+}
+
+/** \brief Whether the range is within the size. */
+bool isInRange(std::uint64_t offset, std::uint64_t num, std::uint64_t unitSize, std::uint64_t size)
+{
+  return offset <= size && num <= (size - offset) / unitSize;
+}
+} // namespace
+
+void ContactLibrary::convertFromConfig(const mc_rtc::Configuration & mcRtcConfig, const std::string & path)
+{
+  // Sort vertices by name for binary search
+  std::map<std::string, std::vector<Eigen::Vector3d>> surfaceVerticesMap;
+  if(mcRtcConfig.has("surfaceVerticesMap"))
+  {
+    for(const auto & verticesConfig : mcRtcConfig("surfaceVerticesMap"))
+    {
+      surfaceVerticesMap[verticesConfig("name")] = verticesConfig("vertices");
+    }
+  }
+  std::map<std::string, std::vector<sva::PTransformd>> graspVerticesMap;
+  if(mcRtcConfig.has("graspVerticesMap"))
+  {
+    for(const auto & verticesConfig : mcRtcConfig("graspVerticesMap"))
+    {
+      graspVerticesMap[verticesConfig("name")] = verticesConfig("vertices");
+    }
+  }
+  std::vector<mc_rtc::Configuration> contactConfigList;
+  if(mcRtcConfig.has("contactList"))
+  {
+    for(const auto & contactConfig : mcRtcConfig("contactList"))
+    {
+      contactConfigList.push_back(contactConfig);
+    }
+  }
+
+  std::string stringPool;
+  auto addString = [&](const std::string & str) {
+    std::uint64_t offset = stringPool.size();
+    stringPool += str;
+    return offset;
+  };
+  auto findIdx = [](const auto & verticesMap, const std::string & name) {
+    auto it = verticesMap.find(name);
+    if(it == verticesMap.end())
+    {
+      mc_rtc::log::error_and_throw<std::runtime_error>("[ContactLibrary::convertFromConfig] Vertices not found: {}.",
+                                                       name);
+    }
+    return static_cast<std::uint32_t>(std::distance(verticesMap.begin(), it));
+  };
+
+  // Layout: header, surface vertices table, grasp vertices table, contact table, vertex data, string pool
+  Header header;
+  std::memset(&header, 0, sizeof(Header));
+  std::memcpy(header.magic, magic, sizeof(header.magic));
+  header.version = version;
+  header.byteOrderMark = byteOrderMark;
+  header.surfaceVerticesNum = surfaceVerticesMap.size();
+  header.graspVerticesNum = graspVerticesMap.size();
+  header.contactNum = contactConfigList.size();
+  header.surfaceVerticesTableOffset = sizeof(Header);
+  header.graspVerticesTableOffset =
+      header.surfaceVerticesTableOffset + header.surfaceVerticesNum * sizeof(VerticesEntry);
+  header.contactTableOffset = header.graspVerticesTableOffset + header.graspVerticesNum * sizeof(VerticesEntry);
+  std::uint64_t dataOffset = header.contactTableOffset + header.contactNum * sizeof(ContactEntry);
+
+  std::vector<std::uint8_t> tableBuffer;
+  std::vector<std::uint8_t> dataBuffer;
+  for(const auto & [name, vertices] : surfaceVerticesMap)
+  {
+    VerticesEntry entry;
+    entry.nameOffset = addString(name);
+    entry.nameSize = name.size();
+    entry.dataOffset = dataOffset + dataBuffer.size();
+    entry.vertexNum = vertices.size();
+    appendToBuffer(tableBuffer, entry);
+    for(const auto & vertex : vertices)
+    {
+      for(int i = 0; i < 3; i++)
+      {
+        appendToBuffer(dataBuffer, vertex[i]);
+      }
+    }
+  }
+  for(const auto & [name, vertices] : graspVerticesMap)
+  {
+    VerticesEntry entry;
+    entry.nameOffset = addString(name);
+    entry.nameSize = name.size();
+    entry.dataOffset = dataOffset + dataBuffer.size();
+    entry.vertexNum = vertices.size();
+    appendToBuffer(tableBuffer, entry);
+    for(const auto & vertex : vertices)
+    {
+      double poseData[12];
+      storePose(vertex, poseData);
+      appendToBuffer(dataBuffer, poseData);
+    }
+  }
+  for(const auto & contactConfig : contactConfigList)
+  {
+    ContactEntry entry;
+    std::memset(&entry, 0, sizeof(ContactEntry));
+    std::string name = contactConfig("name");
+    entry.nameOffset = addString(name);
+    entry.nameSize = name.size();
+    std::string type = contactConfig("type");
+    if(type == "Empty")
+    {
+      entry.type = ContactType::Empty;
+      storePose(sva::PTransformd::Identity(), entry.pose);
+    }
+    else if(type == "Surface" || type == "Grasp")
+    {
+      if(type == "Surface")
+      {
+        entry.type = ContactType::Surface;
+        entry.verticesIdx = findIdx(surfaceVerticesMap, contactConfig("verticesName"));
+        if(contactConfig.has("vertexPruningTolerance"))
+        {
+          entry.hasVertexPruningTolerance = 1;
+          entry.vertexPruningTolerance = contactConfig("vertexPruningTolerance");
+        }
+      }
+      else
+      {
+        entry.type = ContactType::Grasp;
+        entry.verticesIdx = findIdx(graspVerticesMap, contactConfig("verticesName"));
+      }
+      entry.fricCoeff = contactConfig("fricCoeff");
+      storePose(contactConfig("pose"), entry.pose);
+      if(contactConfig.has("maxWrench"))
+      {
+        entry.hasMaxWrench = 1;
+        Eigen::Map<Eigen::Vector6d> maxWrenchData(entry.maxWrench);
+        maxWrenchData = static_cast<sva::ForceVecd>(contactConfig("maxWrench")).vector();
+      }
+    }
+    else
+    {
+      mc_rtc::log::error_and_throw<std::runtime_error>("[ContactLibrary::convertFromConfig] Invalid type: {}.", type);
+    }
+    appendToBuffer(tableBuffer, entry);
+  }
+  header.stringPoolOffset = dataOffset + dataBuffer.size();
+  header.stringPoolSize = stringPool.size();
+  header.fileSize = header.stringPoolOffset + header.stringPoolSize;
+
+  std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+  if(!ofs)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[ContactLibrary::convertFromConfig] Failed to open file: {}.",
+                                                     path);
+  }
+  ofs.write(reinterpret_cast<const char *>(&header), sizeof(Header));
+  ofs.write(reinterpret_cast<const char *>(tableBuffer.data()), static_cast<std::streamsize>(tableBuffer.size()));
+  ofs.write(reinterpret_cast<const char *>(dataBuffer.data()), static_cast<std::streamsize>(dataBuffer.size()));
+  ofs.write(stringPool.data(), static_cast<std::streamsize>(stringPool.size()));
+  if(!ofs)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[ContactLibrary::convertFromConfig] Failed to write file: {}.",
+                                                     path);
+  }
+}
+
+ContactLibrary::ContactLibrary(const std::string & path) : path_(path)
+{
+  int fd = open(path.c_str(), O_RDONLY);
+  if(fd < 0)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[ContactLibrary] Failed to open file: {}.", path);
+  }
+  struct stat fileStat;
+  if(fstat(fd, &fileStat) != 0 || fileStat.st_size < static_cast<off_t>(sizeof(Header)))
+  {
+    close(fd);
+    mc_rtc::log::error_and_throw<std::runtime_error>("[ContactLibrary] Invalid file size: {}.", path);
+  }
+  size_ = static_cast<size_t>(fileStat.st_size);
+  void * mapped = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  close(fd);
+  if(mapped == MAP_FAILED)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[ContactLibrary] Failed to map file: {}.", path);
+  }
+  data_ = static_cast<const std::uint8_t *>(mapped);
+
+  try
+  {
+    validate();
+  }
+  catch(...)
+  {
+    munmap(const_cast<std::uint8_t *>(data_), size_);
+    throw;
+  }
+}
+
+ContactLibrary::~ContactLibrary()
+{
+  if(data_)
+  {
+    munmap(const_cast<std::uint8_t *>(data_), size_);
+  }
+}
+
+std::string_view ContactLibrary::surfaceVerticesName(size_t idx) const
+{
+  const auto & entry = verticesEntry(header().surfaceVerticesTableOffset, header().surfaceVerticesNum, idx);
+  return poolString(entry.nameOffset, entry.nameSize);
+}
+
+Eigen::Map<const Eigen::Matrix3Xd> ContactLibrary::surfaceVertices(size_t idx) const
+{
+  const auto & entry = verticesEntry(header().surfaceVerticesTableOffset, header().surfaceVerticesNum, idx);
+  return Eigen::Map<const Eigen::Matrix3Xd>(reinterpret_cast<const double *>(data_ + entry.dataOffset), 3,
+                                            static_cast<Eigen::DenseIndex>(entry.vertexNum));
+}
+
+std::string_view ContactLibrary::graspVerticesName(size_t idx) const
+{
+  const auto & entry = verticesEntry(header().graspVerticesTableOffset, header().graspVerticesNum, idx);
+  return poolString(entry.nameOffset, entry.nameSize);
+}
+
+std::vector<sva::PTransformd> ContactLibrary::graspVertices(size_t idx) const
+{
+  const auto & entry = verticesEntry(header().graspVerticesTableOffset, header().graspVerticesNum, idx);
+  const double * data = reinterpret_cast<const double *>(data_ + entry.dataOffset);
+  std::vector<sva::PTransformd> vertices;
+  vertices.reserve(static_cast<size_t>(entry.vertexNum));
+  for(std::uint64_t i = 0; i < entry.vertexNum; i++)
+  {
+    vertices.push_back(loadPose(data + 12 * i));
+  }
+  return vertices;
+}
+
+int ContactLibrary::findSurfaceVertices(std::string_view name) const
+{
+  return findVertices(header().surfaceVerticesTableOffset, header().surfaceVerticesNum, name);
+}
+
+int ContactLibrary::findGraspVertices(std::string_view name) const
+{
+  return findVertices(header().graspVerticesTableOffset, header().graspVerticesNum, name);
+}
+
+std::string_view ContactLibrary::contactName(size_t idx) const
+{
+  const auto & entry = contactEntry(idx);
+  return poolString(entry.nameOffset, entry.nameSize);
+}
+
+std::shared_ptr<Contact> ContactLibrary::makeSharedContact(size_t idx) const
+{
+  const auto & entry = contactEntry(idx);
+  std::string name(contactName(idx));
+  std::optional<sva::ForceVecd> maxWrench;
+  if(entry.hasMaxWrench)
+  {
+    maxWrench = sva::ForceVecd(Eigen::Map<const Eigen::Vector6d>(entry.maxWrench));
+  }
+
+  if(entry.type == ContactType::Empty)
+  {
+    return std::make_shared<EmptyContact>(name);
+  }
+  else if(entry.type == ContactType::Surface)
+  {
+    Eigen::Map<const Eigen::Matrix3Xd> verticesMat = surfaceVertices(entry.verticesIdx);
+    std::vector<Eigen::Vector3d> vertices(static_cast<size_t>(verticesMat.cols()));
+    for(Eigen::DenseIndex i = 0; i < verticesMat.cols(); i++)
+    {
+      vertices[static_cast<size_t>(i)] = verticesMat.col(i);
+    }
+    auto contact = std::make_shared<SurfaceContact>(name, entry.fricCoeff, vertices, loadPose(entry.pose), maxWrench);
+    if(entry.hasVertexPruningTolerance)
+    {
+      contact->vertexPruningTolerance_ = entry.vertexPruningTolerance;
+      contact->updateLocalVertices(contact->localVertices_);
+      contact->updateGlobalVertices(contact->pose_);
+    }
+    return contact;
+  }
+  else
+  {
+    return std::make_shared<GraspContact>(name, entry.fricCoeff, graspVertices(entry.verticesIdx),
+                                          loadPose(entry.pose), maxWrench);
+  }
+}
+
+std::vector<std::shared_ptr<Contact>> ContactLibrary::makeSharedContactList() const
+{
+  std::vector<std::shared_ptr<Contact>> contactList;
+  contactList.reserve(contactNum());
+  for(size_t i = 0; i < contactNum(); i++)
+  {
+    contactList.push_back(makeSharedContact(i));
+  }
+  return contactList;
+}
+
+void ContactLibrary::loadVerticesMaps() const
+{
+  for(size_t i = 0; i < surfaceVerticesNum(); i++)
+  {
+    Eigen::Map<const Eigen::Matrix3Xd> verticesMat = surfaceVertices(i);
+    auto & vertices = SurfaceContact::verticesMap[std::string(surfaceVerticesName(i))];
+    vertices.resize(static_cast<size_t>(verticesMat.cols()));
+    for(Eigen::DenseIndex j = 0; j < verticesMat.cols(); j++)
+    {
+      vertices[static_cast<size_t>(j)] = verticesMat.col(j);
+    }
+  }
+  for(size_t i = 0; i < graspVerticesNum(); i++)
+  {
+    GraspContact::verticesMap[std::string(graspVerticesName(i))] = graspVertices(i);
+  }
+}
+
+const ContactLibrary::VerticesEntry & ContactLibrary::verticesEntry(std::uint64_t tableOffset,
+                                                                    std::uint64_t tableSize,
+                                                                    size_t idx) const
+{
+  if(idx >= tableSize)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[ContactLibrary::verticesEntry] Index out of range: {} >= {}.",
+                                                     idx, tableSize);
+  }
+  return reinterpret_cast<const VerticesEntry *>(data_ + tableOffset)[idx];
+}
+
+const ContactLibrary::ContactEntry & ContactLibrary::contactEntry(size_t idx) const
+{
+  if(idx >= contactNum())
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[ContactLibrary::contactEntry] Index out of range: {} >= {}.",
+                                                     idx, contactNum());
+  }
+  return reinterpret_cast<const ContactEntry *>(data_ + header().contactTableOffset)[idx];
+}
+
+std::string_view ContactLibrary::poolString(std::uint64_t offset, std::uint64_t size) const
+{
+  return std::string_view(reinterpret_cast<const char *>(data_ + header().stringPoolOffset + offset),
+                          static_cast<size_t>(size));
+}
+
+int ContactLibrary::findVertices(std::uint64_t tableOffset, std::uint64_t tableSize, std::string_view name) const
+{
+  const VerticesEntry * table = reinterpret_cast<const VerticesEntry *>(data_ + tableOffset);
+  std::uint64_t lower = 0;
+  std::uint64_t upper = tableSize;
+  while(lower < upper)
+  {
+    std::uint64_t mid = (lower + upper) / 2;
+    int cmp = poolString(table[mid].nameOffset, table[mid].nameSize).compare(name);
+    if(cmp == 0)
+    {
+      return static_cast<int>(mid);
+    }
+    else if(cmp < 0)
+    {
+      lower = mid + 1;
+    }
+    else
+    {
+      upper = mid;
+    }
+  }
+  return -1;
+}
+
+void ContactLibrary::validate() const
+{
+  const Header & header = this->header();
+  if(std::memcmp(header.magic, magic, sizeof(header.magic)) != 0)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[ContactLibrary] Invalid magic string: {}.", path_);
+  }
+  if(header.version != version)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[ContactLibrary] Unsupported version {} (expected {}): {}.",
+                                                     header.version, version, path_);
+  }
+  if(header.byteOrderMark != byteOrderMark)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[ContactLibrary] Byte order mismatch: {}.", path_);
+  }
+  if(header.fileSize != size_
+     || !isInRange(header.surfaceVerticesTableOffset, header.surfaceVerticesNum, sizeof(VerticesEntry), size_)
+     || !isInRange(header.graspVerticesTableOffset, header.graspVerticesNum, sizeof(VerticesEntry), size_)
+     || !isInRange(header.contactTableOffset, header.contactNum, sizeof(ContactEntry), size_)
+     || !isInRange(header.stringPoolOffset, header.stringPoolSize, 1, size_)
+     || header.surfaceVerticesTableOffset % alignof(double) != 0
+     || header.graspVerticesTableOffset % alignof(double) != 0 || header.contactTableOffset % alignof(double) != 0)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[ContactLibrary] Invalid layout: {}.", path_);
+  }
+
+  auto validateVerticesTable = [&](std::uint64_t tableOffset, std::uint64_t tableSize, std::uint64_t vertexSize) {
+    for(size_t i = 0; i < tableSize; i++)
+    {
+      const auto & entry = verticesEntry(tableOffset, tableSize, i);
+      if(!isInRange(entry.nameOffset, entry.nameSize, 1, header.stringPoolSize)
+         || !isInRange(entry.dataOffset, entry.vertexNum, vertexSize, size_) || entry.dataOffset % alignof(double) != 0)
+      {
+        mc_rtc::log::error_and_throw<std::runtime_error>("[ContactLibrary] Invalid vertices entry {}: {}.", i, path_);
+      }
+    }
+  };
+  validateVerticesTable(header.surfaceVerticesTableOffset, header.surfaceVerticesNum, 3 * sizeof(double));
+  validateVerticesTable(header.graspVerticesTableOffset, header.graspVerticesNum, 12 * sizeof(double));
+
+  for(size_t i = 0; i < header.contactNum; i++)
+  {
+    const auto & entry = contactEntry(i);
+    bool valid = isInRange(entry.nameOffset, entry.nameSize, 1, header.stringPoolSize);
+    if(entry.type == ContactType::Surface)
+    {
+      valid = valid && entry.verticesIdx < header.surfaceVerticesNum;
+    }
+    else if(entry.type == ContactType::Grasp)
+    {
+      valid = valid && entry.verticesIdx < header.graspVerticesNum;
+    }
+    else if(entry.type != ContactType::Empty)
+    {
+      valid = false;
+    }
+    if(!valid)
+    {
+      mc_rtc::log::error_and_throw<std::runtime_error>("[ContactLibrary] Invalid contact entry {}: {}.", i, path_);
+    }
+  }
+}
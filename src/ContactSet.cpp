@@ -0,0 +1,151 @@
+#include <mc_rtc/logging.h>
+
+#include <ForceColl/ContactGeometry.h>
+#include <ForceColl/ContactSet.h>
+
+using namespace ForceColl;
+
+ContactSet::ContactSet(std::vector<ContactVariant> contactList)
+: contactList_(std::make_shared<std::vector<ContactVariant>>(std::move(contactList)))
+{
+  makeContactPtrList();
+}
+
+ContactSet::ContactSet(const std::vector<std::shared_ptr<Contact>> & contactList)
+: contactList_(std::make_shared<std::vector<ContactVariant>>())
+{
+  contactList_->reserve(contactList.size());
+  for(const auto & contact : contactList)
+  {
+    if(auto surfaceContact = std::dynamic_pointer_cast<SurfaceContact>(contact))
+    {
+      contactList_->emplace_back(*surfaceContact);
+    }
+    else if(auto graspContact = std::dynamic_pointer_cast<GraspContact>(contact))
+    {
+      contactList_->emplace_back(*graspContact);
+    }
+    else if(auto emptyContact = std::dynamic_pointer_cast<EmptyContact>(contact))
+    {
+      contactList_->emplace_back(*emptyContact);
+    }
+    else
+    {
+      mc_rtc::log::error_and_throw<std::runtime_error>("[ContactSet] Unsupported contact type: {}.", contact->type());
+    }
+  }
+  makeContactPtrList();
+}
+
+ContactSet::ContactSet(const ContactSet & other)
+: contactList_(std::make_shared<std::vector<ContactVariant>>(*other.contactList_))
+{
+  makeContactPtrList();
+}
+
+ContactSet & ContactSet::operator=(const ContactSet & other)
+{
+  if(this != &other)
+  {
+    contactList_ = std::make_shared<std::vector<ContactVariant>>(*other.contactList_);
+    makeContactPtrList();
+  }
+  return *this;
+}
+
+int ContactSet::ridgeNum() const
+{
+  int ridgeNum = 0;
+  for(const auto & contact : contactPtrList_)
+  {
+    ridgeNum += contact->ridgeNum();
+  }
+  return ridgeNum;
+}
+
+const Contact & ContactSet::contact(size_t contactIdx) const
+{
+  return *contactPtrList_[contactIdx];
+}
+
+Contact & ContactSet::contact(size_t contactIdx)
+{
+  return *contactPtrList_[contactIdx];
+}
+
+void ContactSet::updateGlobalVertices(const std::vector<sva::PTransformd> & poseList)
+{
+  if(poseList.size() != size())
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>(
+        "[ContactSet::updateGlobalVertices] Size of poseList must be {} but is {}.", size(), poseList.size());
+  }
+
+  for(size_t contactIdx = 0; contactIdx < poseList.size(); contactIdx++)
+  {
+    std::visit(
+        [&](auto & contact) {
+          // Qualified call to bypass the virtual dispatch
+          using ContactType = std::decay_t<decltype(contact)>;
+          contact.ContactType::updateGlobalVertices(poseList[contactIdx]);
+        },
+        (*contactList_)[contactIdx]);
+  }
+}
+
+sva::ForceVecd ContactSet::calcTotalWrench(const Eigen::VectorXd & wrenchRatio,
+                                           const Eigen::Vector3d & momentOrigin) const
+{
+  Eigen::Vector6d totalWrench = Eigen::Vector6d::Zero();
+  Eigen::DenseIndex wrenchRatioIdx = 0;
+  for(const auto & contactVariant : *contactList_)
+  {
+    const Contact & contact = std::visit([](const auto & c) -> const Contact & { return c; }, contactVariant);
+    totalWrench += ContactGeometry<double>::calcWrench(
+        contact.graspMat_, wrenchRatio.segment(wrenchRatioIdx, contact.graspMat_.cols()), momentOrigin);
+    wrenchRatioIdx += contact.graspMat_.cols();
+  }
+  return sva::ForceVecd(totalWrench);
+}
+
+std::vector<sva::ForceVecd> ContactSet::calcWrenchList(const Eigen::VectorXd & wrenchRatio,
+                                                       const Eigen::Vector3d & momentOrigin) const
+{
+  std::vector<sva::ForceVecd> wrenchList;
+  wrenchList.reserve(size());
+  Eigen::DenseIndex wrenchRatioIdx = 0;
+  for(const auto & contactVariant : *contactList_)
+  {
+    const Contact & contact = std::visit([](const auto & c) -> const Contact & { return c; }, contactVariant);
+    wrenchList.emplace_back(ContactGeometry<double>::calcWrench(
+        contact.graspMat_, wrenchRatio.segment(wrenchRatioIdx, contact.graspMat_.cols()), momentOrigin));
+    wrenchRatioIdx += contact.graspMat_.cols();
+  }
+  return wrenchList;
+}
+
+Eigen::Matrix<double, 6, Eigen::Dynamic> ContactSet::calcTotalGraspMat(const Eigen::Vector3d & momentOrigin) const
+{
+  Eigen::Matrix<double, 6, Eigen::Dynamic> totalGraspMat(6, ridgeNum());
+  Eigen::DenseIndex colIdx = 0;
+  for(const auto & contactVariant : *contactList_)
+  {
+    const Contact & contact = std::visit([](const auto & c) -> const Contact & { return c; }, contactVariant);
+    totalGraspMat.middleCols(colIdx, contact.graspMat_.cols()) = contact.graspMat_;
+    colIdx += contact.graspMat_.cols();
+  }
+  ContactGeometry<double>::shiftMomentOrigin(totalGraspMat, momentOrigin);
+  return totalGraspMat;
+}
+
+void ContactSet::makeContactPtrList()
+{
+  contactPtrList_.clear();
+  contactPtrList_.reserve(contactList_->size());
+  for(auto & contactVariant : *contactList_)
+  {
+    // Aliasing constructor shares the ownership of the whole storage
+    Contact * contact = std::visit([](auto & c) -> Contact * { return &c; }, contactVariant);
+    contactPtrList_.push_back(std::shared_ptr<Contact>(contactList_, contact));
+  }
+}
@@ -0,0 +1,32 @@
+#include <mc_rtc/logging.h>
+
+#include <ForceColl/ContactLibrary.h>
+
+/** \brief Convert contact library from mc_rtc configuration (YAML/JSON) to binary format.
+
+    Usage: ConvertContactLibrary <input config file> <output binary file>
+ */
+int main(int argc, char ** argv)
+{
+  if(argc != 3)
+  {
+    mc_rtc::log::error("Usage: {} <input config file> <output binary file>", argv[0]);
+    return 1;
+  }
+
+  try
+  {
+    ForceColl::ContactLibrary::convertFromConfig(mc_rtc::Configuration(argv[1]), argv[2]);
+    ForceColl::ContactLibrary contactLibrary(argv[2]);
+    mc_rtc::log::success("[ConvertContactLibrary] Converted {} surface vertices, {} grasp vertices, and {} contacts.",
+                         contactLibrary.surfaceVerticesNum(), contactLibrary.graspVerticesNum(),
+                         contactLibrary.contactNum());
+  }
+  catch(const std::exception & e)
+  {
+    mc_rtc::log::error("[ConvertContactLibrary] {}", e.what());
+    return 1;
+  }
+
+  return 0;
+}
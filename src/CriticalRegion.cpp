@@ -0,0 +1,166 @@
+#include <Eigen/Dense>
+
+#include <ForceColl/CriticalRegion.h>
+
+using namespace ForceColl;
+
+std::optional<CriticalRegion> CriticalRegion::makeFromSolution(const QpSolverCollection::QpCoeff & qpCoeff,
+                                                               const Eigen::MatrixXd & objParamMat,
+                                                               const Eigen::VectorXd & solution,
+                                                               const Eigen::VectorXd & param,
+                                                               double eps)
+{
+  const int varDim = qpCoeff.dim_var_;
+  const int eqDim = qpCoeff.dim_eq_;
+  const int ineqDim = qpCoeff.dim_ineq_;
+  const Eigen::DenseIndex paramDim = objParamMat.cols();
+
+  // Stack all inequality constraints as C x <= d
+  const int constraintNum = ineqDim + 2 * varDim;
+  Eigen::MatrixXd constraintMat(constraintNum, varDim);
+  Eigen::VectorXd constraintVec(constraintNum);
+  constraintMat << qpCoeff.ineq_mat_, -1 * Eigen::MatrixXd::Identity(varDim, varDim),
+      Eigen::MatrixXd::Identity(varDim, varDim);
+  constraintVec << qpCoeff.ineq_vec_, -1 * qpCoeff.x_min_, qpCoeff.x_max_;
+  auto calcTolerance = [&](int i) { return eps * std::max(1.0, std::abs(constraintVec(i))); };
+
+  // Solve KKT conditions: [H C_a^T E^T; C_a 0 0; E 0 0] [x; lambda; mu] = [-P theta; d_a; e]
+  // The solution and the multipliers are affine in the parameter, so the right-hand side is [-P, 0; 0, d_a; 0, e]
+  auto solveKkt = [&](const std::vector<int> & activeIdxs) -> Eigen::MatrixXd {
+    const int activeDim = static_cast<int>(activeIdxs.size());
+    const int kktDim = varDim + activeDim + eqDim;
+    Eigen::MatrixXd kktMat = Eigen::MatrixXd::Zero(kktDim, kktDim);
+    Eigen::MatrixXd kktRhsMat = Eigen::MatrixXd::Zero(kktDim, paramDim + 1);
+    kktMat.topLeftCorner(varDim, varDim) = qpCoeff.obj_mat_;
+    kktRhsMat.topLeftCorner(varDim, paramDim) = -1 * objParamMat;
+    for(int i = 0; i < activeDim; i++)
+    {
+      int row = varDim + i;
+      kktMat.block(row, 0, 1, varDim) = constraintMat.row(activeIdxs[i]);
+      kktMat.block(0, row, varDim, 1) = constraintMat.row(activeIdxs[i]).transpose();
+      kktRhsMat(row, paramDim) = constraintVec(activeIdxs[i]);
+    }
+    if(eqDim > 0)
+    {
+      kktMat.block(varDim + activeDim, 0, eqDim, varDim) = qpCoeff.eq_mat_;
+      kktMat.block(0, varDim + activeDim, varDim, eqDim) = qpCoeff.eq_mat_.transpose();
+      kktRhsMat.block(varDim + activeDim, paramDim, eqDim, 1) = qpCoeff.eq_vec_;
+    }
+    // The minimum norm multipliers are used if the active constraints are linearly dependent
+    return kktMat.completeOrthogonalDecomposition().solve(kktRhsMat);
+  };
+
+  // The solution of the QP solver is used only as the initial guess of the active set because it may be inaccurate
+  // along weakly regularized directions. The active set is refined by the primal-dual active set method.
+  std::vector<int> activeIdxs;
+  {
+    Eigen::VectorXd residual = constraintMat * solution - constraintVec;
+    for(int i = 0; i < constraintNum; i++)
+    {
+      if(residual(i) > -calcTolerance(i))
+      {
+        activeIdxs.push_back(i);
+      }
+    }
+  }
+  Eigen::MatrixXd kktSolMat;
+  for(int iter = 0; iter < constraintNum + 1; iter++)
+  {
+    kktSolMat = solveKkt(activeIdxs);
+    Eigen::VectorXd kktSol = kktSolMat.leftCols(paramDim) * param + kktSolMat.col(paramDim);
+    Eigen::VectorXd residual = constraintMat * kktSol.head(varDim) - constraintVec;
+
+    std::vector<int> newActiveIdxs;
+    size_t activeIdx = 0;
+    for(int i = 0; i < constraintNum; i++)
+    {
+      if(activeIdx < activeIdxs.size() && activeIdxs[activeIdx] == i)
+      {
+        if(kktSol(varDim + static_cast<Eigen::DenseIndex>(activeIdx)) >= -eps)
+        {
+          newActiveIdxs.push_back(i);
+        }
+        activeIdx++;
+      }
+      else if(residual(i) > calcTolerance(i))
+      {
+        newActiveIdxs.push_back(i);
+      }
+    }
+    if(newActiveIdxs == activeIdxs)
+    {
+      break;
+    }
+    activeIdxs = newActiveIdxs;
+  }
+
+  CriticalRegion region;
+  region.activeIdxs_ = activeIdxs;
+  region.gainMat_ = kktSolMat.topLeftCorner(varDim, paramDim);
+  region.offsetVec_ = kktSolMat.block(0, paramDim, varDim, 1);
+
+  // The region is given by the primal feasibility of inactive constraints and the dual feasibility of active ones
+  const int activeDim = static_cast<int>(activeIdxs.size());
+  region.ineqMat_.resize(constraintNum, paramDim);
+  region.ineqVec_.resize(constraintNum);
+  {
+    int row = 0;
+    size_t activeIdx = 0;
+    for(int i = 0; i < constraintNum; i++)
+    {
+      if(activeIdx < activeIdxs.size() && activeIdxs[activeIdx] == i)
+      {
+        activeIdx++;
+        continue;
+      }
+      region.ineqMat_.row(row) = constraintMat.row(i) * region.gainMat_;
+      region.ineqVec_(row) = constraintVec(i) - constraintMat.row(i).dot(region.offsetVec_);
+      row++;
+    }
+    for(int i = 0; i < activeDim; i++)
+    {
+      region.ineqMat_.row(row) = -1 * kktSolMat.block(varDim + i, 0, 1, paramDim);
+      region.ineqVec_(row) = kktSolMat(varDim + i, paramDim);
+      row++;
+    }
+  }
+
+  // Normalize the inequality rows and remove the rows independent of the parameter
+  {
+    int keepNum = 0;
+    for(Eigen::DenseIndex i = 0; i < region.ineqMat_.rows(); i++)
+    {
+      double rowNorm = region.ineqMat_.row(i).norm();
+      if(rowNorm < 1e-10)
+      {
+        if(region.ineqVec_(i) < -eps)
+        {
+          return std::nullopt;
+        }
+        continue;
+      }
+      region.ineqMat_.row(keepNum) = region.ineqMat_.row(i) / rowNorm;
+      region.ineqVec_(keepNum) = region.ineqVec_(i) / rowNorm;
+      keepNum++;
+    }
+    region.ineqMat_.conservativeResize(keepNum, Eigen::NoChange);
+    region.ineqVec_.conservativeResize(keepNum);
+  }
+
+  // The affine solution is optimal if the parameter is in the region
+  if(!region.contains(param, std::sqrt(eps)))
+  {
+    return std::nullopt;
+  }
+
+  return region;
+}
+
+bool CriticalRegion::contains(const Eigen::VectorXd & param, double eps) const
+{
+  if(ineqMat_.rows() == 0)
+  {
+    return true;
+  }
+  return (ineqMat_ * param - ineqVec_).maxCoeff() <= eps;
+}
@@ -0,0 +1,102 @@
+#include <mc_rtc/logging.h>
+
+#include <ForceColl/MultiBodyWrenchDistribution.h>
+
+#include <algorithm>
+#include <atomic>
+#include <exception>
+#include <thread>
+
+using namespace ForceColl;
+
+MultiBodyWrenchDistribution::MultiBodyWrenchDistribution(
+    const std::vector<std::vector<std::shared_ptr<Contact>>> & contactListList,
+    const mc_rtc::Configuration & mcRtcConfig)
+{
+  mcRtcConfig("threadNum", threadNum_);
+  if(threadNum_ <= 0)
+  {
+    threadNum_ = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+  }
+
+  for(const auto & contactList : contactListList)
+  {
+    wrenchDistList_.push_back(std::make_shared<WrenchDistribution>(contactList, mcRtcConfig));
+  }
+
+  result_.resultTotalWrenchList.assign(bodyNum(), sva::ForceVecd::Zero());
+  result_.resultWrenchRatioList.resize(bodyNum());
+  result_.resultWrenchListList.resize(bodyNum());
+
+  workerThreads_ = std::make_unique<WorkerThreads>(std::max(std::min(threadNum_, static_cast<int>(bodyNum())), 1));
+}
+
+const MultiBodyWrenchDistribution::Result & MultiBodyWrenchDistribution::run(
+    const std::vector<sva::ForceVecd> & desiredTotalWrenchList,
+    const std::vector<Eigen::Vector3d> & momentOriginList)
+{
+  if(desiredTotalWrenchList.size() != bodyNum())
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>(
+        "[MultiBodyWrenchDistribution::run] Size of desiredTotalWrenchList must be {}, but {} is given.", bodyNum(),
+        desiredTotalWrenchList.size());
+  }
+  if(!momentOriginList.empty() && momentOriginList.size() != bodyNum())
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>(
+        "[MultiBodyWrenchDistribution::run] Size of momentOriginList must be {} or zero, but {} is given.", bodyNum(),
+        momentOriginList.size());
+  }
+
+  std::vector<std::exception_ptr> exceptionList(bodyNum());
+  std::atomic<size_t> bodyIdx(0);
+
+  auto solve = [&](int) {
+    for(size_t i = bodyIdx++; i < bodyNum(); i = bodyIdx++)
+    {
+      try
+      {
+        const auto & wrenchDist = wrenchDistList_[i];
+        Eigen::Vector3d momentOrigin = momentOriginList.empty() ? Eigen::Vector3d::Zero() : momentOriginList[i];
+        result_.resultTotalWrenchList[i] = wrenchDist->run(desiredTotalWrenchList[i], momentOrigin);
+        result_.resultWrenchRatioList[i] = wrenchDist->resultWrenchRatio_;
+        if(wrenchDist->config().formulation == WrenchDistribution::Formulation::Cone)
+        {
+          // In the Cone formulation, the contact wrenches around the world origin are given instead of the ratio
+          auto & wrenchList = result_.resultWrenchListList[i];
+          wrenchList = wrenchDist->resultWrenchList_;
+          for(auto & wrench : wrenchList)
+          {
+            wrench.couple() -= momentOrigin.cross(wrench.force());
+          }
+        }
+        else
+        {
+          result_.resultWrenchListList[i] =
+              calcWrenchList(wrenchDist->solverContactList(), wrenchDist->resultWrenchRatio_, momentOrigin);
+        }
+      }
+      catch(...)
+      {
+        exceptionList[i] = std::current_exception();
+      }
+    }
+  };
+
+  int threadNum = std::max(std::min(threadNum_, static_cast<int>(bodyNum())), 1);
+  if(workerThreads_->threadNum() != threadNum)
+  {
+    workerThreads_ = std::make_unique<WorkerThreads>(threadNum);
+  }
+  workerThreads_->run(solve);
+
+  for(const auto & exception : exceptionList)
+  {
+    if(exception)
+    {
+      std::rethrow_exception(exception);
+    }
+  }
+
+  return result_;
+}
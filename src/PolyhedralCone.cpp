@@ -0,0 +1,269 @@
+#include <Eigen/Dense>
+
+#include <ForceColl/PolyhedralCone.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+using namespace ForceColl;
+
+namespace
+{
+/** \brief Set of constraint indices at which a ray is active. */
+class ZeroSet
+{
+public:
+  ZeroSet(int size) : words_((size + 63) / 64, 0) {}
+
+  inline void set(int idx)
+  {
+    words_[static_cast<size_t>(idx / 64)] |= (std::uint64_t(1) << (idx % 64));
+  }
+
+  inline int count() const
+  {
+    int cnt = 0;
+    for(const auto & word : words_)
+    {
+      cnt += __builtin_popcountll(word);
+    }
+    return cnt;
+  }
+
+  /** \brief Whether this is a subset of other. */
+  inline bool isSubsetOf(const ZeroSet & other) const
+  {
+    for(size_t i = 0; i < words_.size(); i++)
+    {
+      if((words_[i] & ~other.words_[i]) != 0)
+      {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  static inline ZeroSet intersection(const ZeroSet & set1, const ZeroSet & set2)
+  {
+    ZeroSet ret = set1;
+    for(size_t i = 0; i < ret.words_.size(); i++)
+    {
+      ret.words_[i] &= set2.words_[i];
+    }
+    return ret;
+  }
+
+protected:
+  std::vector<std::uint64_t> words_;
+};
+
+/** \brief Orthonormalize the rows of matrix. */
+Eigen::MatrixXd orthonormalizeRows(const Eigen::MatrixXd & mat, double eps)
+{
+  if(mat.rows() == 0)
+  {
+    return mat;
+  }
+  Eigen::JacobiSVD<Eigen::MatrixXd> svd(mat, Eigen::ComputeFullV);
+  svd.setThreshold(eps);
+  return svd.matrixV().leftCols(svd.rank()).transpose();
+}
+} // namespace
+
+PolyhedralCone PolyhedralCone::makeFromSpan(const Eigen::MatrixXd & spanMat, double eps)
+{
+  const Eigen::DenseIndex dim = spanMat.rows();
+
+  // Split the ambient space into the linear span of the generators and its orthogonal complement
+  Eigen::MatrixXd spanBasis(dim, 0);
+  Eigen::MatrixXd complementBasis = Eigen::MatrixXd::Identity(dim, dim);
+  if(spanMat.cols() > 0)
+  {
+    Eigen::JacobiSVD<Eigen::MatrixXd> svd(spanMat, Eigen::ComputeFullU);
+    svd.setThreshold(eps);
+    spanBasis = svd.matrixU().leftCols(svd.rank());
+    complementBasis = svd.matrixU().rightCols(dim - svd.rank());
+  }
+  const int rank = static_cast<int>(spanBasis.cols());
+  if(rank == 0)
+  {
+    return PolyhedralCone(Eigen::MatrixXd(0, dim), complementBasis.transpose());
+  }
+
+  // The faces of the cone are the extreme rays of the polar cone {y | constraintMat * y <= 0}, which is pointed
+  // because constraintMat has full column rank
+  Eigen::MatrixXd constraintMat = (spanBasis.transpose() * spanMat).transpose();
+  {
+    std::vector<Eigen::DenseIndex> nonzeroRowIdxs;
+    for(Eigen::DenseIndex i = 0; i < constraintMat.rows(); i++)
+    {
+      if(constraintMat.row(i).norm() > eps)
+      {
+        nonzeroRowIdxs.push_back(i);
+      }
+    }
+    Eigen::MatrixXd nonzeroConstraintMat(nonzeroRowIdxs.size(), rank);
+    for(size_t i = 0; i < nonzeroRowIdxs.size(); i++)
+    {
+      nonzeroConstraintMat.row(static_cast<Eigen::DenseIndex>(i)) =
+          constraintMat.row(nonzeroRowIdxs[i]).normalized();
+    }
+    constraintMat = nonzeroConstraintMat;
+  }
+  const int constraintNum = static_cast<int>(constraintMat.rows());
+
+  // Initialize with the cone of linearly independent constraints
+  std::vector<Eigen::VectorXd> rayList;
+  std::vector<ZeroSet> zeroSetList;
+  std::vector<bool> processedList(constraintNum, false);
+  {
+    Eigen::ColPivHouseholderQR<Eigen::MatrixXd> qr(constraintMat.transpose());
+    std::vector<int> initialIdxs;
+    for(int i = 0; i < rank; i++)
+    {
+      initialIdxs.push_back(static_cast<int>(qr.colsPermutation().indices()(i)));
+    }
+    Eigen::MatrixXd initialMat(rank, rank);
+    for(int i = 0; i < rank; i++)
+    {
+      initialMat.row(i) = constraintMat.row(initialIdxs[i]);
+    }
+    Eigen::MatrixXd initialRayMat = -1 * initialMat.inverse();
+    for(int i = 0; i < rank; i++)
+    {
+      ZeroSet zeroSet(constraintNum);
+      for(int j = 0; j < rank; j++)
+      {
+        if(j != i)
+        {
+          zeroSet.set(initialIdxs[j]);
+        }
+      }
+      rayList.push_back(initialRayMat.col(i).normalized());
+      zeroSetList.push_back(zeroSet);
+      processedList[initialIdxs[i]] = true;
+    }
+  }
+
+  // Add constraints one by one
+  for(int constraintIdx = 0; constraintIdx < constraintNum; constraintIdx++)
+  {
+    if(processedList[constraintIdx])
+    {
+      continue;
+    }
+    processedList[constraintIdx] = true;
+
+    std::vector<double> valueList(rayList.size());
+    std::vector<size_t> posIdxs, negIdxs;
+    for(size_t rayIdx = 0; rayIdx < rayList.size(); rayIdx++)
+    {
+      valueList[rayIdx] = constraintMat.row(constraintIdx).dot(rayList[rayIdx]);
+      if(valueList[rayIdx] > eps)
+      {
+        posIdxs.push_back(rayIdx);
+      }
+      else if(valueList[rayIdx] < -eps)
+      {
+        negIdxs.push_back(rayIdx);
+      }
+      else
+      {
+        zeroSetList[rayIdx].set(constraintIdx);
+      }
+    }
+    if(posIdxs.empty())
+    {
+      continue;
+    }
+
+    // Make new rays from adjacent pairs of rays on the opposite sides of the constraint hyperplane
+    std::vector<Eigen::VectorXd> newRayList;
+    std::vector<ZeroSet> newZeroSetList;
+    for(size_t posIdx : posIdxs)
+    {
+      for(size_t negIdx : negIdxs)
+      {
+        ZeroSet commonZeroSet = ZeroSet::intersection(zeroSetList[posIdx], zeroSetList[negIdx]);
+        if(commonZeroSet.count() < rank - 2)
+        {
+          continue;
+        }
+        bool adjacent = true;
+        for(size_t rayIdx = 0; rayIdx < rayList.size(); rayIdx++)
+        {
+          if(rayIdx != posIdx && rayIdx != negIdx && commonZeroSet.isSubsetOf(zeroSetList[rayIdx]))
+          {
+            adjacent = false;
+            break;
+          }
+        }
+        if(!adjacent)
+        {
+          continue;
+        }
+        Eigen::VectorXd newRay = valueList[posIdx] * rayList[negIdx] - valueList[negIdx] * rayList[posIdx];
+        commonZeroSet.set(constraintIdx);
+        newRayList.push_back(newRay.normalized());
+        newZeroSetList.push_back(commonZeroSet);
+      }
+    }
+
+    // Remove rays that violate the constraint
+    size_t keepNum = 0;
+    for(size_t rayIdx = 0; rayIdx < rayList.size(); rayIdx++)
+    {
+      if(valueList[rayIdx] <= eps)
+      {
+        rayList[keepNum] = rayList[rayIdx];
+        zeroSetList[keepNum] = zeroSetList[rayIdx];
+        keepNum++;
+      }
+    }
+    rayList.resize(keepNum, Eigen::VectorXd());
+    zeroSetList.resize(keepNum, ZeroSet(0));
+    rayList.insert(rayList.end(), newRayList.begin(), newRayList.end());
+    zeroSetList.insert(zeroSetList.end(), newZeroSetList.begin(), newZeroSetList.end());
+  }
+
+  Eigen::MatrixXd ineqMat(rayList.size(), dim);
+  for(size_t rayIdx = 0; rayIdx < rayList.size(); rayIdx++)
+  {
+    ineqMat.row(static_cast<Eigen::DenseIndex>(rayIdx)) = (spanBasis * rayList[rayIdx]).transpose();
+  }
+  return PolyhedralCone(ineqMat, complementBasis.transpose());
+}
+
+PolyhedralCone::PolyhedralCone(const Eigen::MatrixXd & ineqMat, const Eigen::MatrixXd & eqMat)
+: ineqMat_(ineqMat), eqMat_(eqMat)
+{
+  ineqMat_.rowwise().normalize();
+}
+
+double PolyhedralCone::calcMargin(const Eigen::VectorXd & x) const
+{
+  double margin = std::numeric_limits<double>::infinity();
+  if(ineqMat_.rows() > 0)
+  {
+    margin = -1 * (ineqMat_ * x).maxCoeff();
+  }
+  if(eqMat_.rows() > 0)
+  {
+    margin = std::min(margin, -1 * (eqMat_ * x).norm());
+  }
+  return margin;
+}
+
+PolyhedralCone PolyhedralCone::transform(const Eigen::MatrixXd & transMat) const
+{
+  Eigen::MatrixXd eqMat = orthonormalizeRows(eqMat_ * transMat, 1e-9);
+  Eigen::MatrixXd ineqMat = ineqMat_ * transMat;
+  // Keep the face normals in the linear span of the cone
+  if(eqMat.rows() > 0)
+  {
+    ineqMat -= (ineqMat * eqMat.transpose()) * eqMat;
+  }
+  return PolyhedralCone(ineqMat, eqMat);
+}
@@ -0,0 +1,351 @@
+#include <mc_rtc/logging.h>
+
+#include <ForceColl/QpFile.h>
+
+#include <cctype>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+constexpr double infinityThre = 1e20;
+} // namespace
+
+void ForceColl::writeQps(const QpSolverCollection::QpCoeff & qpCoeff,
+                         const std::string & path,
+                         const std::string & name)
+{
+  std::ofstream ofs(path);
+  if(!ofs)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[writeQps] Failed to open file: {}.", path);
+  }
+  ofs << std::setprecision(17);
+
+  ofs << "NAME " << name << "\n";
+  ofs << "ROWS\n";
+  ofs << " N obj\n";
+  for(int i = 0; i < qpCoeff.dim_eq_; i++)
+  {
+    ofs << " E e" << i << "\n";
+  }
+  for(int i = 0; i < qpCoeff.dim_ineq_; i++)
+  {
+    ofs << " L c" << i << "\n";
+  }
+
+  // The objective coefficient is always written so that the variables are declared in order
+  ofs << "COLUMNS\n";
+  for(int j = 0; j < qpCoeff.dim_var_; j++)
+  {
+    ofs << " x" << j << " obj " << qpCoeff.obj_vec_(j) << "\n";
+    for(int i = 0; i < qpCoeff.dim_eq_; i++)
+    {
+      if(qpCoeff.eq_mat_(i, j) != 0)
+      {
+        ofs << " x" << j << " e" << i << " " << qpCoeff.eq_mat_(i, j) << "\n";
+      }
+    }
+    for(int i = 0; i < qpCoeff.dim_ineq_; i++)
+    {
+      if(qpCoeff.ineq_mat_(i, j) != 0)
+      {
+        ofs << " x" << j << " c" << i << " " << qpCoeff.ineq_mat_(i, j) << "\n";
+      }
+    }
+  }
+
+  ofs << "RHS\n";
+  for(int i = 0; i < qpCoeff.dim_eq_; i++)
+  {
+    if(qpCoeff.eq_vec_(i) != 0)
+    {
+      ofs << " rhs e" << i << " " << qpCoeff.eq_vec_(i) << "\n";
+    }
+  }
+  for(int i = 0; i < qpCoeff.dim_ineq_; i++)
+  {
+    if(qpCoeff.ineq_vec_(i) != 0)
+    {
+      ofs << " rhs c" << i << " " << qpCoeff.ineq_vec_(i) << "\n";
+    }
+  }
+
+  // The default lower bound is zero in MPS format, so the lower bound is always written
+  ofs << "BOUNDS\n";
+  for(int j = 0; j < qpCoeff.dim_var_; j++)
+  {
+    double xMin = qpCoeff.x_min_(j);
+    double xMax = qpCoeff.x_max_(j);
+    if(xMin <= -infinityThre && xMax >= infinityThre)
+    {
+      ofs << " FR bnd x" << j << "\n";
+      continue;
+    }
+    if(xMin <= -infinityThre)
+    {
+      ofs << " MI bnd x" << j << "\n";
+    }
+    else
+    {
+      ofs << " LO bnd x" << j << " " << xMin << "\n";
+    }
+    if(xMax < infinityThre)
+    {
+      ofs << " UP bnd x" << j << " " << xMax << "\n";
+    }
+  }
+
+  ofs << "QUADOBJ\n";
+  for(int j = 0; j < qpCoeff.dim_var_; j++)
+  {
+    for(int i = j; i < qpCoeff.dim_var_; i++)
+    {
+      if(qpCoeff.obj_mat_(i, j) != 0)
+      {
+        ofs << " x" << j << " x" << i << " " << qpCoeff.obj_mat_(i, j) << "\n";
+      }
+    }
+  }
+  ofs << "ENDATA\n";
+
+  if(!ofs)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[writeQps] Failed to write file: {}.", path);
+  }
+}
+
+QpSolverCollection::QpCoeff ForceColl::readQps(const std::string & path)
+{
+  std::ifstream ifs(path);
+  if(!ifs)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[readQps] Failed to open file: {}.", path);
+  }
+
+  /** \brief Row of constraint. */
+  struct Row
+  {
+    char type;
+    std::unordered_map<int, double> coeffs;
+    double rhs = 0;
+  };
+  std::string objName;
+  std::vector<Row> rowList;
+  std::unordered_map<std::string, int> rowIdxMap;
+  std::vector<std::string> varNameList;
+  std::unordered_map<std::string, int> varIdxMap;
+  std::vector<double> objVec, xMinList, xMaxList;
+  std::vector<std::tuple<int, int, double>> objMatEntries;
+
+  auto getVarIdx = [&](const std::string & varName) {
+    auto it = varIdxMap.find(varName);
+    if(it != varIdxMap.end())
+    {
+      return it->second;
+    }
+    int varIdx = static_cast<int>(varNameList.size());
+    varIdxMap.emplace(varName, varIdx);
+    varNameList.push_back(varName);
+    objVec.push_back(0);
+    xMinList.push_back(0);
+    xMaxList.push_back(std::numeric_limits<double>::infinity());
+    return varIdx;
+  };
+  auto throwError = [&](const std::string & line) {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[readQps] Invalid line in {}: {}", path, line);
+  };
+
+  std::string section;
+  std::string line;
+  while(std::getline(ifs, line))
+  {
+    if(line.empty() || line[0] == '*')
+    {
+      continue;
+    }
+    std::istringstream iss(line);
+    std::vector<std::string> tokens;
+    for(std::string token; iss >> token;)
+    {
+      tokens.push_back(token);
+    }
+    if(tokens.empty())
+    {
+      continue;
+    }
+    if(!std::isspace(static_cast<unsigned char>(line[0])))
+    {
+      section = tokens[0];
+      if(section == "ENDATA")
+      {
+        break;
+      }
+      continue;
+    }
+
+    if(section == "ROWS")
+    {
+      if(tokens.size() != 2)
+      {
+        throwError(line);
+      }
+      if(tokens[0] == "N")
+      {
+        if(objName.empty())
+        {
+          objName = tokens[1];
+        }
+      }
+      else if(tokens[0] == "E" || tokens[0] == "L" || tokens[0] == "G")
+      {
+        rowIdxMap.emplace(tokens[1], static_cast<int>(rowList.size()));
+        rowList.push_back(Row{tokens[0][0], {}, 0});
+      }
+      else
+      {
+        throwError(line);
+      }
+    }
+    else if(section == "COLUMNS" || section == "RHS")
+    {
+      if(tokens.size() != 3 && tokens.size() != 5)
+      {
+        throwError(line);
+      }
+      int varIdx = (section == "COLUMNS" ? getVarIdx(tokens[0]) : -1);
+      for(size_t k = 1; k + 1 < tokens.size(); k += 2)
+      {
+        double value = std::stod(tokens[k + 1]);
+        if(tokens[k] == objName)
+        {
+          if(section == "COLUMNS")
+          {
+            objVec[static_cast<size_t>(varIdx)] = value;
+          }
+          continue;
+        }
+        auto it = rowIdxMap.find(tokens[k]);
+        if(it == rowIdxMap.end())
+        {
+          throwError(line);
+        }
+        if(section == "COLUMNS")
+        {
+          rowList[static_cast<size_t>(it->second)].coeffs[varIdx] = value;
+        }
+        else
+        {
+          rowList[static_cast<size_t>(it->second)].rhs = value;
+        }
+      }
+    }
+    else if(section == "BOUNDS")
+    {
+      if(tokens.size() < 3)
+      {
+        throwError(line);
+      }
+      int varIdx = getVarIdx(tokens[2]);
+      double value = (tokens.size() >= 4 ? std::stod(tokens[3]) : 0.0);
+      auto & xMin = xMinList[static_cast<size_t>(varIdx)];
+      auto & xMax = xMaxList[static_cast<size_t>(varIdx)];
+      if(tokens[0] == "LO")
+      {
+        xMin = value;
+      }
+      else if(tokens[0] == "UP")
+      {
+        xMax = value;
+      }
+      else if(tokens[0] == "FX")
+      {
+        xMin = value;
+        xMax = value;
+      }
+      else if(tokens[0] == "FR")
+      {
+        xMin = -std::numeric_limits<double>::infinity();
+        xMax = std::numeric_limits<double>::infinity();
+      }
+      else if(tokens[0] == "MI")
+      {
+        xMin = -std::numeric_limits<double>::infinity();
+      }
+      else if(tokens[0] == "PL")
+      {
+        xMax = std::numeric_limits<double>::infinity();
+      }
+      else
+      {
+        throwError(line);
+      }
+    }
+    else if(section == "QUADOBJ" || section == "QMATRIX")
+    {
+      if(tokens.size() != 3)
+      {
+        throwError(line);
+      }
+      objMatEntries.emplace_back(getVarIdx(tokens[0]), getVarIdx(tokens[1]), std::stod(tokens[2]));
+    }
+    else if(section != "NAME" && section != "OBJSENSE")
+    {
+      mc_rtc::log::error_and_throw<std::runtime_error>("[readQps] Unsupported section in {}: {}", path, section);
+    }
+  }
+
+  // Make QP coefficients
+  int eqDim = 0;
+  int ineqDim = 0;
+  for(const auto & row : rowList)
+  {
+    (row.type == 'E' ? eqDim : ineqDim)++;
+  }
+  QpSolverCollection::QpCoeff qpCoeff;
+  const int varDim = static_cast<int>(varNameList.size());
+  qpCoeff.setup(varDim, eqDim, ineqDim);
+  for(int j = 0; j < varDim; j++)
+  {
+    qpCoeff.obj_vec_(j) = objVec[static_cast<size_t>(j)];
+    qpCoeff.x_min_(j) = std::max(xMinList[static_cast<size_t>(j)], -1 * infinityThre);
+    qpCoeff.x_max_(j) = std::min(xMaxList[static_cast<size_t>(j)], infinityThre);
+  }
+  int eqIdx = 0;
+  int ineqIdx = 0;
+  for(const auto & row : rowList)
+  {
+    if(row.type == 'E')
+    {
+      for(const auto & [varIdx, coeff] : row.coeffs)
+      {
+        qpCoeff.eq_mat_(eqIdx, varIdx) = coeff;
+      }
+      qpCoeff.eq_vec_(eqIdx) = row.rhs;
+      eqIdx++;
+    }
+    else
+    {
+      // G rows are converted to L rows
+      double sign = (row.type == 'L' ? 1.0 : -1.0);
+      for(const auto & [varIdx, coeff] : row.coeffs)
+      {
+        qpCoeff.ineq_mat_(ineqIdx, varIdx) = sign * coeff;
+      }
+      qpCoeff.ineq_vec_(ineqIdx) = sign * row.rhs;
+      ineqIdx++;
+    }
+  }
+  for(const auto & [i, j, value] : objMatEntries)
+  {
+    qpCoeff.obj_mat_(i, j) = value;
+    qpCoeff.obj_mat_(j, i) = value;
+  }
+
+  return qpCoeff;
+}
@@ -0,0 +1,153 @@
+#include <mc_rtc/logging.h>
+
+#include <ForceColl/QpSolverSelector.h>
+
+#include <chrono>
+#include <limits>
+#include <map>
+#include <mutex>
+
+using namespace ForceColl;
+
+namespace
+{
+std::mutex & cacheMutex()
+{
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::map<QpSolverSelector::ShapeKey, QpSolverCollection::QpSolverType> & cache()
+{
+  static std::map<QpSolverSelector::ShapeKey, QpSolverCollection::QpSolverType> selectionMap;
+  return selectionMap;
+}
+} // namespace
+
+std::vector<QpSolverCollection::QpSolverType> QpSolverSelector::availableQpSolverTypes()
+{
+  std::vector<QpSolverCollection::QpSolverType> qpSolverTypeList;
+  for(const auto & qpSolverType :
+      {QpSolverCollection::QpSolverType::QLD, QpSolverCollection::QpSolverType::QuadProg,
+       QpSolverCollection::QpSolverType::LSSOL, QpSolverCollection::QpSolverType::JRLQP,
+       QpSolverCollection::QpSolverType::QPOASES, QpSolverCollection::QpSolverType::OSQP,
+       QpSolverCollection::QpSolverType::NASOQ, QpSolverCollection::QpSolverType::HPIPM,
+       QpSolverCollection::QpSolverType::PROXQP, QpSolverCollection::QpSolverType::QPMAD})
+  {
+    if(QpSolverCollection::isQpSolverEnabled(qpSolverType))
+    {
+      qpSolverTypeList.push_back(qpSolverType);
+    }
+  }
+  return qpSolverTypeList;
+}
+
+double QpSolverSelector::calcViolation(const QpSolverCollection::QpCoeff & qpCoeff, const Eigen::VectorXd & x)
+{
+  double violation = 0;
+  if(qpCoeff.dim_eq_ > 0)
+  {
+    violation = std::max(violation, (qpCoeff.eq_mat_ * x - qpCoeff.eq_vec_).cwiseAbs().maxCoeff());
+  }
+  if(qpCoeff.dim_ineq_ > 0)
+  {
+    violation = std::max(violation, (qpCoeff.ineq_mat_ * x - qpCoeff.ineq_vec_).maxCoeff());
+  }
+  if(qpCoeff.dim_var_ > 0)
+  {
+    violation = std::max(violation, (qpCoeff.x_min_ - x).maxCoeff());
+    violation = std::max(violation, (x - qpCoeff.x_max_).maxCoeff());
+  }
+  return violation;
+}
+
+double QpSolverSelector::calcObjective(const QpSolverCollection::QpCoeff & qpCoeff, const Eigen::VectorXd & x)
+{
+  return 0.5 * x.dot(qpCoeff.obj_mat_ * x) + qpCoeff.obj_vec_.dot(x);
+}
+
+QpSolverCollection::QpSolverType QpSolverSelector::select(const ShapeKey & shapeKey,
+                                                          const QpSolverCollection::QpCoeff & qpCoeff,
+                                                          int trialNum)
+{
+  if(auto cachedType = findCached(shapeKey))
+  {
+    return *cachedType;
+  }
+
+  // Benchmark the available solvers without holding the lock
+  std::vector<QpSolverCollection::QpSolverType> qpSolverTypeList = availableQpSolverTypes();
+  std::vector<double> timeList(qpSolverTypeList.size(), std::numeric_limits<double>::infinity());
+  std::vector<double> objList(qpSolverTypeList.size(), std::numeric_limits<double>::infinity());
+  double objMin = std::numeric_limits<double>::infinity();
+  for(size_t i = 0; i < qpSolverTypeList.size(); i++)
+  {
+    auto qpSolver = QpSolverCollection::allocateQpSolver(qpSolverTypeList[i]);
+    Eigen::VectorXd x;
+    double timeMin = std::numeric_limits<double>::infinity();
+    bool failed = false;
+    try
+    {
+      for(int j = 0; j < std::max(trialNum, 1); j++)
+      {
+        QpSolverCollection::QpCoeff qpCoeffCopy = qpCoeff;
+        auto startTime = std::chrono::steady_clock::now();
+        x = qpSolver->solve(qpCoeffCopy);
+        timeMin =
+            std::min(timeMin, std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count());
+        failed = failed || qpSolver->solveFailed();
+      }
+    }
+    catch(const std::exception &)
+    {
+      failed = true;
+    }
+    if(failed || x.size() != qpCoeff.dim_var_ || !x.allFinite() || calcViolation(qpCoeff, x) > violationThre)
+    {
+      continue;
+    }
+    timeList[i] = timeMin;
+    objList[i] = calcObjective(qpCoeff, x);
+    objMin = std::min(objMin, objList[i]);
+  }
+
+  QpSolverCollection::QpSolverType selectedType = QpSolverCollection::QpSolverType::Any;
+  double selectedTime = std::numeric_limits<double>::infinity();
+  for(size_t i = 0; i < qpSolverTypeList.size(); i++)
+  {
+    if((objList[i] - objMin) / std::max(1.0, std::abs(objMin)) <= objGapThre && timeList[i] < selectedTime)
+    {
+      selectedType = qpSolverTypeList[i];
+      selectedTime = timeList[i];
+    }
+  }
+  if(selectedType == QpSolverCollection::QpSolverType::Any)
+  {
+    mc_rtc::log::warning("[QpSolverSelector::select] No QP solver succeeded for shape [{}, {}, {}, {}].", shapeKey[0],
+                         shapeKey[1], shapeKey[2], shapeKey[3]);
+    return selectedType;
+  }
+  mc_rtc::log::info("[QpSolverSelector::select] Select {} ({:.4f} [ms]) for shape [{}, {}, {}, {}].",
+                    std::to_string(selectedType), 1e3 * selectedTime, shapeKey[0], shapeKey[1], shapeKey[2],
+                    shapeKey[3]);
+
+  std::lock_guard<std::mutex> lock(cacheMutex());
+  return cache().emplace(shapeKey, selectedType).first->second;
+}
+
+std::optional<QpSolverCollection::QpSolverType> QpSolverSelector::findCached(const ShapeKey & shapeKey)
+{
+  std::lock_guard<std::mutex> lock(cacheMutex());
+  auto it = cache().find(shapeKey);
+  if(it == cache().end())
+  {
+    return std::nullopt;
+  }
+  return it->second;
+}
+
+void QpSolverSelector::clearCache()
+{
+  std::lock_guard<std::mutex> lock(cacheMutex());
+  cache().clear();
+}
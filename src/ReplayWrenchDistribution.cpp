@@ -0,0 +1,110 @@
+#include <mc_rtc/logging.h>
+
+#include <ForceColl/WrenchDistributionLog.h>
+
+#include <chrono>
+
+/** \brief Replay the log of WrenchDistributionRecorder and report the computation time and the result difference.
+
+    Usage: ReplayWrenchDistribution <log file> [QP solver type ...]
+
+    If no QP solver type is given, the QP solver in the recorded configuration is used.
+ */
+int main(int argc, char ** argv)
+{
+  if(argc < 2)
+  {
+    mc_rtc::log::error("Usage: {} <log file> [QP solver type ...]", argv[0]);
+    return 1;
+  }
+  const std::string path = argv[1];
+  std::vector<std::optional<QpSolverCollection::QpSolverType>> qpSolverTypeList;
+  for(int i = 2; i < argc; i++)
+  {
+    qpSolverTypeList.push_back(QpSolverCollection::strToQpSolverType(argv[i]));
+  }
+  if(qpSolverTypeList.empty())
+  {
+    qpSolverTypeList.push_back(std::nullopt);
+  }
+
+  try
+  {
+    for(const auto & qpSolverType : qpSolverTypeList)
+    {
+      ForceColl::WrenchDistributionLogReader logReader(path);
+      std::shared_ptr<ForceColl::WrenchDistribution> wrenchDist;
+      size_t setupIdx = 0;
+      int frameNum = 0;
+      double timeSum = 0;
+      double timeMax = 0;
+      double recordedTimeSum = 0;
+      double recordedTimeMax = 0;
+      double ratioErrorMax = 0;
+      double wrenchErrorMax = 0;
+
+      while(auto frame = logReader.next())
+      {
+        if(!wrenchDist || frame->setupIdx != setupIdx)
+        {
+          setupIdx = frame->setupIdx;
+          wrenchDist = std::make_shared<ForceColl::WrenchDistribution>(frame->makeContactList(), *frame->config);
+          if(qpSolverType)
+          {
+            wrenchDist->qpSolver_ = QpSolverCollection::allocateQpSolver(*qpSolverType);
+          }
+        }
+        else
+        {
+          for(size_t i = 0; i < wrenchDist->contactList_.size(); i++)
+          {
+            wrenchDist->contactList_[i]->updateGlobalVertices(frame->poseList[i]);
+          }
+        }
+
+        auto startTime = std::chrono::steady_clock::now();
+        sva::ForceVecd resultTotalWrench = wrenchDist->run(frame->desiredTotalWrench, frame->momentOrigin);
+        double time = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+
+        frameNum++;
+        timeSum += time;
+        timeMax = std::max(timeMax, time);
+        recordedTimeSum += frame->computationTime;
+        recordedTimeMax = std::max(recordedTimeMax, frame->computationTime);
+        if(wrenchDist->resultWrenchRatio_.size() != frame->resultWrenchRatio.size())
+        {
+          ratioErrorMax = std::numeric_limits<double>::infinity();
+        }
+        else if(wrenchDist->resultWrenchRatio_.size() > 0)
+        {
+          // The wrench ratio is empty in the Cone formulation
+          ratioErrorMax = std::max(ratioErrorMax,
+                                   (wrenchDist->resultWrenchRatio_ - frame->resultWrenchRatio).cwiseAbs().maxCoeff());
+          sva::ForceVecd recordedTotalWrench = ForceColl::calcTotalWrench(
+              wrenchDist->solverContactList(), frame->resultWrenchRatio, frame->momentOrigin);
+          wrenchErrorMax = std::max(wrenchErrorMax, (resultTotalWrench - recordedTotalWrench).vector().norm());
+        }
+      }
+
+      if(frameNum == 0)
+      {
+        mc_rtc::log::warning("[ReplayWrenchDistribution] No frame in log: {}", path);
+        return 1;
+      }
+      mc_rtc::log::info("[ReplayWrenchDistribution] QP solver: {}, frames: {}",
+                        qpSolverType ? std::to_string(*qpSolverType) : std::string("recorded"), frameNum);
+      mc_rtc::log::info("  computation time [ms]: mean {:.4f}, max {:.4f} (recorded: mean {:.4f}, max {:.4f})",
+                        1e3 * timeSum / frameNum, 1e3 * timeMax, 1e3 * recordedTimeSum / frameNum,
+                        1e3 * recordedTimeMax);
+      mc_rtc::log::info("  max difference from recorded result: wrench ratio {:.3e}, total wrench {:.3e}",
+                        ratioErrorMax, wrenchErrorMax);
+    }
+  }
+  catch(const std::exception & e)
+  {
+    mc_rtc::log::error("[ReplayWrenchDistribution] {}", e.what());
+    return 1;
+  }
+
+  return 0;
+}
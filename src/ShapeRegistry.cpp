@@ -0,0 +1,140 @@
+#include <mc_rtc/logging.h>
+
+#include <ForceColl/ShapeRegistry.h>
+
+#include <algorithm>
+#include <cmath>
+
+using namespace ForceColl;
+
+namespace
+{
+/** \brief Whether the friction pyramid has the friction coefficient (within tolerance) and the number of ridges. */
+bool isSameFricPyramid(const FrictionPyramid & fricPyramid, double fricCoeff, int ridgeNum)
+{
+  return std::abs(fricPyramid.fricCoeff_ - fricCoeff) <= ShapeRegistry::fricCoeffTolerance
+         && fricPyramid.ridgeNum() == ridgeNum;
+}
+
+/** \brief Find shape for friction pyramid. */
+template<class ShapeHandle>
+ShapeHandle findShape(const std::unordered_map<std::string, std::vector<ShapeHandle>> & shapeMap,
+                      const std::string & name,
+                      double fricCoeff,
+                      int ridgeNum,
+                      const std::string & funcName)
+{
+  auto it = shapeMap.find(name);
+  if(it == shapeMap.end())
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[ShapeRegistry::{}] Vertices not found: {}.", funcName, name);
+  }
+  for(const auto & shape : it->second)
+  {
+    if(isSameFricPyramid(*shape->fricPyramid, fricCoeff, ridgeNum))
+    {
+      return shape;
+    }
+  }
+  mc_rtc::log::error_and_throw<std::runtime_error>(
+      "[ShapeRegistry::{}] Friction pyramid (fricCoeff: {}, ridgeNum: {}) is not registered for {}.", funcName,
+      fricCoeff, ridgeNum, name);
+}
+} // namespace
+
+ShapeRegistry::Builder & ShapeRegistry::Builder::addSurfaceVertices(const std::string & name,
+                                                                    const std::vector<Eigen::Vector3d> & localVertices)
+{
+  surfaceVerticesMap_[name] = localVertices;
+  return *this;
+}
+
+ShapeRegistry::Builder & ShapeRegistry::Builder::addGraspVertices(const std::string & name,
+                                                                  const std::vector<sva::PTransformd> & localVertices)
+{
+  graspVerticesMap_[name] = localVertices;
+  return *this;
+}
+
+ShapeRegistry::Builder & ShapeRegistry::Builder::loadSurfaceVerticesMap(const mc_rtc::Configuration & mcRtcConfig)
+{
+  for(const auto & verticesConfig : mcRtcConfig)
+  {
+    addSurfaceVertices(verticesConfig("name"), verticesConfig("vertices"));
+  }
+  return *this;
+}
+
+ShapeRegistry::Builder & ShapeRegistry::Builder::loadGraspVerticesMap(const mc_rtc::Configuration & mcRtcConfig)
+{
+  for(const auto & verticesConfig : mcRtcConfig)
+  {
+    addGraspVertices(verticesConfig("name"), verticesConfig("vertices"));
+  }
+  return *this;
+}
+
+ShapeRegistry::Builder & ShapeRegistry::Builder::addFricCoeff(double fricCoeff, int ridgeNum)
+{
+  if(std::none_of(fricPyramidList_.begin(), fricPyramidList_.end(),
+                  [&](const std::shared_ptr<const FrictionPyramid> & fricPyramid) {
+                    return isSameFricPyramid(*fricPyramid, fricCoeff, ridgeNum);
+                  }))
+  {
+    fricPyramidList_.push_back(FrictionPyramid::makeShared(fricCoeff, ridgeNum));
+  }
+  return *this;
+}
+
+std::shared_ptr<const ShapeRegistry> ShapeRegistry::Builder::build() const
+{
+  auto registry = std::make_shared<ShapeRegistry>();
+
+  // Compute the local grasp matrices by the same code as the contacts
+  for(const auto & [name, localVertices] : surfaceVerticesMap_)
+  {
+    auto & shapeList = registry->surfaceShapeMap_[name];
+    for(const auto & fricPyramid : fricPyramidList_)
+    {
+      SurfaceContact contact(name, fricPyramid->fricCoeff_, {}, sva::PTransformd::Identity());
+      contact.fricPyramid_ = fricPyramid;
+      contact.updateLocalVertices(localVertices);
+
+      auto shape = std::make_shared<SurfaceShape>();
+      shape->name = name;
+      shape->localVertices = contact.localVertices_;
+      shape->fricPyramid = fricPyramid;
+      shape->localGraspMat = contact.localGraspMat_;
+      shapeList.push_back(shape);
+    }
+  }
+  for(const auto & [name, localVertices] : graspVerticesMap_)
+  {
+    auto & shapeList = registry->graspShapeMap_[name];
+    for(const auto & fricPyramid : fricPyramidList_)
+    {
+      GraspContact contact(name, fricPyramid->fricCoeff_, {}, sva::PTransformd::Identity());
+      contact.fricPyramid_ = fricPyramid;
+      contact.updateLocalVertices(localVertices);
+
+      auto shape = std::make_shared<GraspShape>();
+      shape->name = name;
+      shape->localVertices = contact.localVertices_;
+      shape->fricPyramid = fricPyramid;
+      shape->localGraspMat = contact.localGraspMat_;
+      shapeList.push_back(shape);
+    }
+  }
+
+  return registry;
+}
+
+SurfaceShapeHandle ShapeRegistry::surfaceShape(const std::string & name, double fricCoeff, int ridgeNum) const
+{
+  return findShape(surfaceShapeMap_, name, fricCoeff, ridgeNum, "surfaceShape");
+}
+
+GraspShapeHandle ShapeRegistry::graspShape(const std::string & name, double fricCoeff, int ridgeNum) const
+{
+  return findShape(graspShapeMap_, name, fricCoeff, ridgeNum, "graspShape");
+}
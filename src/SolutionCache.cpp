@@ -0,0 +1,67 @@
+#include <ForceColl/SolutionCache.h>
+
+using namespace ForceColl;
+
+size_t SolutionCache::KeyHash::operator()(const Key & key) const noexcept
+{
+  // Combine the element hashes in the same way as boost::hash_combine
+  size_t hash = key.size();
+  for(const auto & element : key)
+  {
+    hash ^= std::hash<int64_t>()(element) + 0x9e3779b97f4a7c15ULL + (hash << 6) + (hash >> 2);
+  }
+  return hash;
+}
+
+SolutionCache::SolutionCache(size_t capacity) : capacity_(capacity)
+{
+}
+
+const Eigen::VectorXd * SolutionCache::find(const Key & key)
+{
+  auto it = entryMap_.find(key);
+  if(it == entryMap_.end())
+  {
+    missNum_++;
+    return nullptr;
+  }
+  hitNum_++;
+  entryList_.splice(entryList_.begin(), entryList_, it->second);
+  return &it->second->second;
+}
+
+void SolutionCache::insert(const Key & key, const Eigen::VectorXd & solution)
+{
+  if(capacity_ == 0)
+  {
+    return;
+  }
+
+  auto it = entryMap_.find(key);
+  if(it != entryMap_.end())
+  {
+    it->second->second = solution;
+    entryList_.splice(entryList_.begin(), entryList_, it->second);
+    return;
+  }
+
+  if(entryList_.size() >= capacity_)
+  {
+    entryMap_.erase(entryList_.back().first);
+    entryList_.pop_back();
+  }
+  entryList_.emplace_front(key, solution);
+  entryMap_.emplace(key, entryList_.begin());
+}
+
+void SolutionCache::clear()
+{
+  entryList_.clear();
+  entryMap_.clear();
+}
+
+void SolutionCache::resetStats()
+{
+  hitNum_ = 0;
+  missNum_ = 0;
+}
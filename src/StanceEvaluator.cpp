@@ -0,0 +1,119 @@
+#include <mc_rtc/logging.h>
+
+#include <ForceColl/StanceEvaluator.h>
+
+#include <algorithm>
+#include <atomic>
+#include <thread>
+
+using namespace ForceColl;
+
+StanceEvaluator::StanceEvaluator(const std::vector<std::shared_ptr<Contact>> & contactList,
+                                 const mc_rtc::Configuration & mcRtcConfig)
+: contactList_(contactList), mcRtcConfig_(mcRtcConfig)
+{
+  mcRtcConfig("threadNum", threadNum_);
+  mcRtcConfig("feasibleErrorThre", feasibleErrorThre_);
+  if(threadNum_ <= 0)
+  {
+    threadNum_ = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+  }
+}
+
+std::vector<StanceEvaluator::Result> StanceEvaluator::run(
+    const std::vector<std::vector<sva::PTransformd>> & poseSetList,
+    const sva::ForceVecd & desiredTotalWrench,
+    const Eigen::Vector3d & momentOrigin)
+{
+  for(const auto & poseSet : poseSetList)
+  {
+    if(poseSet.size() != contactList_.size())
+    {
+      mc_rtc::log::error_and_throw<std::runtime_error>(
+          "[StanceEvaluator::run] Size of pose set must be {}, but {} is given.", contactList_.size(), poseSet.size());
+    }
+  }
+
+  updateWorkers();
+
+  std::vector<Result> resultList(poseSetList.size());
+  std::atomic<size_t> candidateIdx(0);
+
+  auto evaluate = [&](int threadIdx) {
+    auto & worker = workerList_[static_cast<size_t>(threadIdx)];
+    const auto & contactList = worker.contactList;
+    auto & wrenchDist = *worker.wrenchDist;
+    const Eigen::Vector6d weightVec = wrenchDist.config().wrenchWeight.vector();
+
+    for(size_t i = candidateIdx++; i < poseSetList.size(); i = candidateIdx++)
+    {
+      for(size_t j = 0; j < contactList.size(); j++)
+      {
+        contactList[j]->updateGlobalVertices(poseSetList[i][j]);
+      }
+
+      auto & result = resultList[i];
+      result.resultTotalWrench = wrenchDist.run(desiredTotalWrench, momentOrigin);
+      result.wrenchRatio = wrenchDist.resultWrenchRatio_;
+      Eigen::Vector6d wrenchError = (result.resultTotalWrench - desiredTotalWrench).vector();
+      result.cost = wrenchError.dot(weightVec.cwiseProduct(wrenchError));
+      result.feasible = wrenchError.norm() < feasibleErrorThre_;
+    }
+  };
+
+  // The exception thrown in any thread is rethrown after all threads finish
+  workerThreads_->run(evaluate);
+
+  return resultList;
+}
+
+void StanceEvaluator::updateWorkers()
+{
+  int threadNum = std::max(threadNum_, 1);
+  if(!workerThreads_ || workerThreads_->threadNum() != threadNum)
+  {
+    workerThreads_ = std::make_unique<WorkerThreads>(threadNum);
+    workerList_.clear();
+  }
+
+  bool contactChanged = (sourceContactList_.size() != contactList_.size());
+  for(size_t i = 0; i < contactList_.size() && !contactChanged; i++)
+  {
+    contactChanged = (sourceContactList_[i] != contactList_[i]
+                      || sourceRevisionList_[i] != contactList_[i]->localGraspMatRevision());
+  }
+  if(contactChanged)
+  {
+    workerList_.clear();
+    sourceContactList_ = contactList_;
+    sourceRevisionList_.clear();
+    for(const auto & contact : contactList_)
+    {
+      sourceRevisionList_.push_back(contact->localGraspMatRevision());
+    }
+  }
+
+  if(workerList_.empty())
+  {
+    workerList_.resize(static_cast<size_t>(threadNum));
+    for(auto & worker : workerList_)
+    {
+      for(const auto & contact : contactList_)
+      {
+        worker.contactList.push_back(contact->clone());
+      }
+      worker.wrenchDist = std::make_shared<WrenchDistribution>(worker.contactList, mcRtcConfig_);
+    }
+  }
+  else
+  {
+    // The maximum wrench can be changed without updating the local grasp matrix
+    for(auto & worker : workerList_)
+    {
+      for(size_t i = 0; i < contactList_.size(); i++)
+      {
+        worker.contactList[i]->maxWrench_ = contactList_[i]->maxWrench_;
+      }
+    }
+  }
+}
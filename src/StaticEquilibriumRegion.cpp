@@ -0,0 +1,262 @@
+#include <mc_rtc/constants.h>
+
+#include <ForceColl/StaticEquilibriumRegion.h>
+
+using namespace ForceColl;
+
+namespace
+{
+/** \brief Calculate the angle of direction in [0, 2 pi). */
+double calcAngle(const Eigen::Vector2d & dir)
+{
+  double angle = std::atan2(dir.y(), dir.x());
+  return angle < 0 ? angle + 2 * mc_rtc::constants::PI : angle;
+}
+
+/** \brief Calculate the gap between inner and outer approximations at the edge between two support points.
+    \param dir1 direction of the first support point
+    \param point1 first support point
+    \param dir2 direction of the second support point
+    \param point2 second support point
+    \param newDir direction to query to reduce the gap
+*/
+double calcGap(const Eigen::Vector2d & dir1,
+               const Eigen::Vector2d & point1,
+               const Eigen::Vector2d & dir2,
+               const Eigen::Vector2d & point2,
+               Eigen::Vector2d & newDir)
+{
+  // Outer vertex is the intersection of the support lines
+  Eigen::Matrix2d lineMat;
+  lineMat << dir1.transpose(), dir2.transpose();
+  if(std::abs(lineMat.determinant()) < 1e-10)
+  {
+    return 0.0;
+  }
+  Eigen::Vector2d outerVertex = lineMat.inverse() * Eigen::Vector2d(dir1.dot(point1), dir2.dot(point2));
+
+  Eigen::Vector2d edge = point2 - point1;
+  if(edge.norm() < 1e-10)
+  {
+    newDir = (dir1 + dir2).normalized();
+    return (outerVertex - point1).norm();
+  }
+  newDir = Eigen::Vector2d(edge.y(), -edge.x()).normalized();
+  return std::max(newDir.dot(outerVertex - point1), 0.0);
+}
+} // namespace
+
+void StaticEquilibriumRegion::Configuration::load(const mc_rtc::Configuration & mcRtcConfig)
+{
+  mcRtcConfig("ridgeForceMinMax", ridgeForceMinMax);
+  mcRtcConfig("regularWeight", regularWeight);
+  mcRtcConfig("tolerance", tolerance);
+  mcRtcConfig("maxLpNum", maxLpNum);
+}
+
+StaticEquilibriumRegion::StaticEquilibriumRegion(const std::vector<std::shared_ptr<Contact>> & contactList,
+                                                 double mass,
+                                                 const mc_rtc::Configuration & mcRtcConfig)
+: contactList_(contactList), mass_(mass)
+{
+  config_.load(mcRtcConfig);
+
+  QpSolverCollection::QpSolverType qpSolverType = QpSolverCollection::QpSolverType::Any;
+  if(mcRtcConfig.has("qpSolverType"))
+  {
+    qpSolverType = QpSolverCollection::strToQpSolverType(mcRtcConfig("qpSolverType"));
+  }
+  qpSolver_ = QpSolverCollection::allocateQpSolver(qpSolverType);
+
+  update(false);
+}
+
+void StaticEquilibriumRegion::update(bool warmStart)
+{
+  lpNum_ = 0;
+  setupQp();
+
+  // Support points in counterclockwise order of directions
+  std::vector<Eigen::Vector2d> dirList;
+  if(warmStart && dirList_.size() >= 3)
+  {
+    dirList = dirList_;
+  }
+  else
+  {
+    for(int i = 0; i < 3; i++)
+    {
+      double angle = 2 * mc_rtc::constants::PI * i / 3.0 + 0.5 * mc_rtc::constants::PI;
+      dirList.push_back(Eigen::Vector2d(std::cos(angle), std::sin(angle)));
+    }
+  }
+  std::vector<Eigen::Vector2d> pointList;
+  for(const auto & dir : dirList)
+  {
+    auto point = calcSupportPoint(dir);
+    if(!point)
+    {
+      vertexList_.clear();
+      dirList_.clear();
+      return;
+    }
+    pointList.push_back(*point);
+  }
+
+  // Refine the edge with the largest gap between inner and outer approximations
+  while(lpNum_ < config_.maxLpNum)
+  {
+    double maxGap = config_.tolerance;
+    size_t maxGapIdx = 0;
+    Eigen::Vector2d maxGapDir;
+    for(size_t i = 0; i < dirList.size(); i++)
+    {
+      size_t j = (i + 1) % dirList.size();
+      Eigen::Vector2d newDir = Eigen::Vector2d::Zero();
+      double gap = calcGap(dirList[i], pointList[i], dirList[j], pointList[j], newDir);
+      if(gap > maxGap)
+      {
+        maxGap = gap;
+        maxGapIdx = i;
+        maxGapDir = newDir;
+      }
+    }
+    if(maxGap <= config_.tolerance)
+    {
+      break;
+    }
+
+    auto point = calcSupportPoint(maxGapDir);
+    if(!point)
+    {
+      break;
+    }
+    // Insert while keeping the counterclockwise order (maxGapDir is between the directions of the edge)
+    size_t insertIdx = maxGapIdx + 1;
+    if(insertIdx == dirList.size() && calcAngle(maxGapDir) < calcAngle(dirList.front()))
+    {
+      insertIdx = 0;
+    }
+    dirList.insert(dirList.begin() + static_cast<long>(insertIdx), maxGapDir);
+    pointList.insert(pointList.begin() + static_cast<long>(insertIdx), *point);
+  }
+
+  // Remove duplicated vertices, keeping the directions at both ends of each vertex for the next warm start
+  vertexList_.clear();
+  dirList_.clear();
+  for(size_t i = 0; i < pointList.size(); i++)
+  {
+    const auto & prevPoint = pointList[(i + pointList.size() - 1) % pointList.size()];
+    const auto & nextPoint = pointList[(i + 1) % pointList.size()];
+    bool samePrev = (pointList[i] - prevPoint).norm() < 1e-2 * config_.tolerance;
+    bool sameNext = (pointList[i] - nextPoint).norm() < 1e-2 * config_.tolerance;
+    if(!samePrev || !sameNext)
+    {
+      dirList_.push_back(dirList[i]);
+    }
+    if(!samePrev)
+    {
+      vertexList_.push_back(pointList[i]);
+    }
+  }
+  if(vertexList_.empty())
+  {
+    vertexList_.push_back(pointList.front());
+  }
+}
+
+bool StaticEquilibriumRegion::contains(const Eigen::Vector2d & comXY, double eps) const
+{
+  if(vertexList_.size() < 3)
+  {
+    return false;
+  }
+  for(size_t i = 0; i < vertexList_.size(); i++)
+  {
+    const Eigen::Vector2d & vertex = vertexList_[i];
+    Eigen::Vector2d edge = vertexList_[(i + 1) % vertexList_.size()] - vertex;
+    Eigen::Vector2d rel = comXY - vertex;
+    // Signed distance from the edge (positive inside)
+    if(edge.x() * rel.y() - edge.y() * rel.x() < -eps * edge.norm())
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+void StaticEquilibriumRegion::setupQp()
+{
+  int ridgeNum = 0;
+  int ineqDim = 0;
+  for(const auto & contact : contactList_)
+  {
+    ridgeNum += contact->ridgeNum();
+    ineqDim += (contact->maxWrench_ ? 12 : 0);
+  }
+  if(qpCoeff_.dim_var_ != ridgeNum || qpCoeff_.dim_eq_ != 4 || qpCoeff_.dim_ineq_ != ineqDim)
+  {
+    qpCoeff_.setup(ridgeNum, 4, ineqDim);
+  }
+  if(qpCoeff_.dim_ineq_ != 0)
+  {
+    qpCoeff_.ineq_mat_.setZero();
+  }
+
+  // Construct totalGraspMat and inequality constraints of maximum wrench
+  Eigen::Matrix<double, 6, Eigen::Dynamic> totalGraspMat(6, ridgeNum);
+  {
+    ridgeNum = 0;
+    int ineqRow = 0;
+    for(const auto & contact : contactList_)
+    {
+      totalGraspMat.middleCols(ridgeNum, contact->ridgeNum()) = contact->graspMat_;
+      if(contact->maxWrench_)
+      {
+        const auto & maxWrench = contact->maxWrench_->vector();
+        qpCoeff_.ineq_mat_.block(ineqRow, ridgeNum, 6, contact->ridgeNum()).noalias() = -contact->localGraspMat_;
+        qpCoeff_.ineq_mat_.block(ineqRow + 6, ridgeNum, 6, contact->ridgeNum()).noalias() = contact->localGraspMat_;
+        qpCoeff_.ineq_vec_.segment(ineqRow, 6) = maxWrench;
+        qpCoeff_.ineq_vec_.segment(ineqRow + 6, 6) = maxWrench;
+        ineqRow += 12;
+      }
+      ridgeNum += contact->ridgeNum();
+    }
+  }
+
+  // The total wrench around the world origin balances the gravity applied at the CoM c:
+  // moment = gravityForce * (c_y, -c_x, 0), force = (0, 0, gravityForce)
+  double gravityForce = mass_ * mc_rtc::constants::GRAVITY;
+  qpCoeff_.eq_mat_.row(0) = totalGraspMat.row(2);
+  qpCoeff_.eq_mat_.bottomRows<3>() = totalGraspMat.bottomRows<3>();
+  qpCoeff_.eq_vec_ << 0, 0, 0, gravityForce;
+  comMomentMat_.resize(2, ridgeNum);
+  comMomentMat_.row(0) = -1 * totalGraspMat.row(1);
+  comMomentMat_.row(1) = totalGraspMat.row(0);
+
+  qpCoeff_.obj_mat_.setIdentity();
+  qpCoeff_.obj_mat_.diagonal().array() *= config_.regularWeight;
+  qpCoeff_.x_min_.setConstant(qpCoeff_.dim_var_, config_.ridgeForceMinMax.first);
+  qpCoeff_.x_max_.setConstant(qpCoeff_.dim_var_, config_.ridgeForceMinMax.second);
+}
+
+std::optional<Eigen::Vector2d> StaticEquilibriumRegion::calcSupportPoint(const Eigen::Vector2d & dir)
+{
+  lpNum_++;
+
+  if(qpCoeff_.dim_var_ == 0)
+  {
+    return std::nullopt;
+  }
+
+  qpCoeff_.obj_vec_.noalias() = -1 * comMomentMat_.transpose() * dir;
+  Eigen::VectorXd wrenchRatio = qpSolver_->solve(qpCoeff_);
+
+  double gravityForce = mass_ * mc_rtc::constants::GRAVITY;
+  if(qpSolver_->solveFailed()
+     || (qpCoeff_.eq_mat_ * wrenchRatio - qpCoeff_.eq_vec_).norm() > config_.tolerance * gravityForce)
+  {
+    return std::nullopt;
+  }
+  return Eigen::Vector2d(comMomentMat_ * wrenchRatio / gravityForce);
+}
@@ -0,0 +1,106 @@
+#include <ForceColl/WorkerThreads.h>
+
+#include <algorithm>
+
+using namespace ForceColl;
+
+WorkerThreads::WorkerThreads(int threadNum)
+{
+  exceptionList_.resize(static_cast<size_t>(std::max(threadNum, 1)));
+  for(int i = 1; i < threadNum; i++)
+  {
+    threadList_.emplace_back(&WorkerThreads::workerLoop, this, i);
+  }
+}
+
+WorkerThreads::~WorkerThreads()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stop_ = true;
+  }
+  startCond_.notify_all();
+  for(auto & thread : threadList_)
+  {
+    thread.join();
+  }
+}
+
+void WorkerThreads::run(const std::function<void(int)> & func)
+{
+  std::fill(exceptionList_.begin(), exceptionList_.end(), nullptr);
+
+  if(!threadList_.empty())
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      func_ = &func;
+      runningNum_ = static_cast<int>(threadList_.size());
+      runCount_++;
+    }
+    startCond_.notify_all();
+  }
+
+  try
+  {
+    func(0);
+  }
+  catch(...)
+  {
+    exceptionList_[0] = std::current_exception();
+  }
+
+  if(!threadList_.empty())
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    finishCond_.wait(lock, [this]() { return runningNum_ == 0; });
+    func_ = nullptr;
+  }
+
+  for(const auto & exception : exceptionList_)
+  {
+    if(exception)
+    {
+      std::rethrow_exception(exception);
+    }
+  }
+}
+
+void WorkerThreads::workerLoop(int threadIdx)
+{
+  size_t runCount = 0;
+  while(true)
+  {
+    const std::function<void(int)> * func = nullptr;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      startCond_.wait(lock, [this, runCount]() { return stop_ || runCount_ != runCount; });
+      if(stop_)
+      {
+        return;
+      }
+      runCount = runCount_;
+      func = func_;
+    }
+
+    try
+    {
+      (*func)(threadIdx);
+    }
+    catch(...)
+    {
+      exceptionList_[static_cast<size_t>(threadIdx)] = std::current_exception();
+    }
+
+    bool finished = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      runningNum_--;
+      finished = (runningNum_ == 0);
+    }
+    if(finished)
+    {
+      finishCond_.notify_one();
+    }
+  }
+}
@@ -1,20 +1,268 @@
+#include <mc_rtc/constants.h>
+#include <mc_rtc/logging.h>
+
+#include <ForceColl/QpFile.h>
+#include <ForceColl/QpSolverSelector.h>
 #include <ForceColl/WrenchDistribution.h>
 
+#include <algorithm>
+#include <atomic>
+#include <iomanip>
+#include <sstream>
 // std::accumulate
 #include <numeric>
 
 using namespace ForceColl;
 
+namespace
+{
+/** \brief Solve non-negative least squares by Lawson-Hanson active set method.
+    \param mat matrix A
+    \param vec vector b
+    \returns x minimizing |A x - b| subject to x >= 0
+*/
+Eigen::VectorXd solveNnls(const Eigen::MatrixXd & mat, const Eigen::VectorXd & vec, double eps = 1e-10)
+{
+  const Eigen::DenseIndex varDim = mat.cols();
+  Eigen::VectorXd x = Eigen::VectorXd::Zero(varDim);
+  std::vector<bool> passiveList(varDim, false);
+
+  for(Eigen::DenseIndex iter = 0; iter < 3 * varDim; iter++)
+  {
+    // Add the variable with the largest gradient to the passive set
+    Eigen::VectorXd grad = mat.transpose() * (vec - mat * x);
+    Eigen::DenseIndex addIdx = -1;
+    for(Eigen::DenseIndex i = 0; i < varDim; i++)
+    {
+      if(!passiveList[i] && grad(i) > eps && (addIdx < 0 || grad(i) > grad(addIdx)))
+      {
+        addIdx = i;
+      }
+    }
+    if(addIdx < 0)
+    {
+      break;
+    }
+    passiveList[addIdx] = true;
+
+    while(true)
+    {
+      // Solve unconstrained least squares in the passive set
+      std::vector<Eigen::DenseIndex> passiveIdxs;
+      for(Eigen::DenseIndex i = 0; i < varDim; i++)
+      {
+        if(passiveList[i])
+        {
+          passiveIdxs.push_back(i);
+        }
+      }
+      Eigen::MatrixXd passiveMat(mat.rows(), passiveIdxs.size());
+      for(size_t i = 0; i < passiveIdxs.size(); i++)
+      {
+        passiveMat.col(static_cast<Eigen::DenseIndex>(i)) = mat.col(passiveIdxs[i]);
+      }
+      Eigen::VectorXd passiveSol = passiveMat.colPivHouseholderQr().solve(vec);
+      if((passiveSol.array() > eps).all())
+      {
+        x.setZero();
+        for(size_t i = 0; i < passiveIdxs.size(); i++)
+        {
+          x(passiveIdxs[i]) = passiveSol(static_cast<Eigen::DenseIndex>(i));
+        }
+        break;
+      }
+
+      // Move toward the solution while keeping feasibility
+      double alpha = 1.0;
+      for(size_t i = 0; i < passiveIdxs.size(); i++)
+      {
+        double sol = passiveSol(static_cast<Eigen::DenseIndex>(i));
+        double cur = x(passiveIdxs[i]);
+        if(sol <= eps && cur - sol > 0)
+        {
+          alpha = std::min(alpha, cur / (cur - sol));
+        }
+      }
+      for(size_t i = 0; i < passiveIdxs.size(); i++)
+      {
+        Eigen::DenseIndex idx = passiveIdxs[i];
+        x(idx) += alpha * (passiveSol(static_cast<Eigen::DenseIndex>(i)) - x(idx));
+        if(x(idx) <= eps)
+        {
+          x(idx) = 0;
+          passiveList[idx] = false;
+        }
+      }
+      if(std::none_of(passiveList.begin(), passiveList.end(), [](bool passive) { return passive; }))
+      {
+        break;
+      }
+    }
+  }
+
+  return x;
+}
+
+/** \brief Whether the states of two contacts are the same.
+
+    The global vertices are not compared because they are determined by the pose and the local grasp matrix.
+*/
+bool isContactStateEqual(const Contact & contact1, const Contact & contact2)
+{
+  if(contact1.fricPyramid_ != contact2.fricPyramid_
+     || contact1.maxWrench_.has_value() != contact2.maxWrench_.has_value()
+     || contact1.localGraspMat_.cols() != contact2.localGraspMat_.cols())
+  {
+    return false;
+  }
+  if(contact1.maxWrench_ && contact1.maxWrench_->vector() != contact2.maxWrench_->vector())
+  {
+    return false;
+  }
+  return contact1.pose_.rotation() == contact2.pose_.rotation()
+         && contact1.pose_.translation() == contact2.pose_.translation()
+         && contact1.localGraspMat_ == contact2.localGraspMat_;
+}
+
+/** \brief Assign the state of contact in place.
+    \param contact contact to be assigned
+    \param srcContact contact of the same type as contact
+*/
+void assignContact(Contact & contact, const Contact & srcContact)
+{
+  if(auto * surfaceContact = dynamic_cast<SurfaceContact *>(&contact))
+  {
+    *surfaceContact = dynamic_cast<const SurfaceContact &>(srcContact);
+  }
+  else if(auto * graspContact = dynamic_cast<GraspContact *>(&contact))
+  {
+    *graspContact = dynamic_cast<const GraspContact &>(srcContact);
+  }
+  else if(auto * emptyContact = dynamic_cast<EmptyContact *>(&contact))
+  {
+    *emptyContact = dynamic_cast<const EmptyContact &>(srcContact);
+  }
+  else
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[WrenchDistribution::restore] Unsupported contact type: {}.",
+                                                     contact.type());
+  }
+}
+
+//! Last ID of wrench distribution
+std::atomic<size_t> lastWrenchDistributionId(0);
+
+//! Last revision of QP data over all wrench distributions
+std::atomic<size_t> lastQpRevision(0);
+} // namespace
+
+WrenchDistribution::Formulation ForceColl::strToFormulation(const std::string & formulationStr)
+{
+  if(formulationStr == "Ridge")
+  {
+    return WrenchDistribution::Formulation::Ridge;
+  }
+  else if(formulationStr == "Wrench")
+  {
+    return WrenchDistribution::Formulation::Wrench;
+  }
+  else if(formulationStr == "Cone")
+  {
+    return WrenchDistribution::Formulation::Cone;
+  }
+  else if(formulationStr == "Lifted")
+  {
+    return WrenchDistribution::Formulation::Lifted;
+  }
+  else
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[strToFormulation] Unsupported formulation name: {}",
+                                                     formulationStr);
+  }
+}
+
+std::string ForceColl::formulationToStr(WrenchDistribution::Formulation formulation)
+{
+  switch(formulation)
+  {
+    case WrenchDistribution::Formulation::Ridge:
+      return "Ridge";
+    case WrenchDistribution::Formulation::Wrench:
+      return "Wrench";
+    case WrenchDistribution::Formulation::Cone:
+      return "Cone";
+    case WrenchDistribution::Formulation::Lifted:
+      return "Lifted";
+  }
+  mc_rtc::log::error_and_throw<std::runtime_error>("[formulationToStr] Unsupported formulation: {}",
+                                                   static_cast<int>(formulation));
+}
+
 void WrenchDistribution::Configuration::load(const mc_rtc::Configuration & mcRtcConfig)
 {
   mcRtcConfig("wrenchWeight", wrenchWeight);
   mcRtcConfig("regularWeight", regularWeight);
   mcRtcConfig("ridgeForceMinMax", ridgeForceMinMax);
+  mcRtcConfig("criticalRegionNumMax", criticalRegionNumMax);
+  mcRtcConfig("coarseVertexNum", coarseVertexNum);
+  mcRtcConfig("refineMargin", refineMargin);
+  mcRtcConfig("coneTolerance", coneTolerance);
+  mcRtcConfig("coneIterMax", coneIterMax);
+  mcRtcConfig("coneCutNumMax", coneCutNumMax);
+  if(coneCutNumMax < 5)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>(
+        "[WrenchDistribution::Configuration::load] coneCutNumMax must be at least 5: {}.", coneCutNumMax);
+  }
+  mcRtcConfig("adaptiveRidgeNum", adaptiveRidgeNum);
+  if(adaptiveRidgeNum.second > 0
+     && (!FrictionPyramid::isSupportedRidgeNum(adaptiveRidgeNum.first)
+         || adaptiveRidgeNum.first > adaptiveRidgeNum.second))
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>(
+        "[WrenchDistribution::Configuration::load] Invalid adaptiveRidgeNum: [{}, {}]. The coarse one must be at least "
+        "3 and not larger than the fine one.",
+        adaptiveRidgeNum.first, adaptiveRidgeNum.second);
+  }
+  mcRtcConfig("adaptiveFricUsageThre", adaptiveFricUsageThre);
+  mcRtcConfig("qpExportDir", qpExportDir);
+  mcRtcConfig("qpDecimation", qpDecimation);
+  mcRtcConfig("solutionCacheSize", solutionCacheSize);
+  mcRtcConfig("solutionCachePosResolution", solutionCachePosResolution);
+  mcRtcConfig("solutionCacheRotResolution", solutionCacheRotResolution);
+  mcRtcConfig("solutionCacheWrenchResolution", solutionCacheWrenchResolution);
+  if(mcRtcConfig.has("formulation"))
+  {
+    formulation = strToFormulation(mcRtcConfig("formulation"));
+  }
+}
+
+void WrenchDistribution::Configuration::save(mc_rtc::Configuration & mcRtcConfig) const
+{
+  mcRtcConfig.add("wrenchWeight", wrenchWeight);
+  mcRtcConfig.add("regularWeight", regularWeight);
+  mcRtcConfig.add("ridgeForceMinMax", ridgeForceMinMax);
+  mcRtcConfig.add("criticalRegionNumMax", criticalRegionNumMax);
+  mcRtcConfig.add("coarseVertexNum", coarseVertexNum);
+  mcRtcConfig.add("refineMargin", refineMargin);
+  mcRtcConfig.add("coneTolerance", coneTolerance);
+  mcRtcConfig.add("coneIterMax", coneIterMax);
+  mcRtcConfig.add("coneCutNumMax", coneCutNumMax);
+  mcRtcConfig.add("adaptiveRidgeNum", adaptiveRidgeNum);
+  mcRtcConfig.add("adaptiveFricUsageThre", adaptiveFricUsageThre);
+  mcRtcConfig.add("qpExportDir", qpExportDir);
+  mcRtcConfig.add("qpDecimation", qpDecimation);
+  mcRtcConfig.add("solutionCacheSize", solutionCacheSize);
+  mcRtcConfig.add("solutionCachePosResolution", solutionCachePosResolution);
+  mcRtcConfig.add("solutionCacheRotResolution", solutionCacheRotResolution);
+  mcRtcConfig.add("solutionCacheWrenchResolution", solutionCacheWrenchResolution);
+  mcRtcConfig.add("formulation", formulationToStr(formulation));
 }
 
 WrenchDistribution::WrenchDistribution(const std::vector<std::shared_ptr<Contact>> & contactList,
                                        const mc_rtc::Configuration & mcRtcConfig)
-: contactList_(contactList)
+: contactList_(contactList), solverContactList_(contactList), adaptedContactList_(contactList.size()),
+  id_(++lastWrenchDistributionId)
 {
   config_.load(mcRtcConfig);
 
@@ -23,99 +271,1526 @@ WrenchDistribution::WrenchDistribution(const std::vector<std::shared_ptr<Contact
   {
     ridgeNum += contact->ridgeNum();
   }
-  resultWrenchRatio_ = Eigen::VectorXd::Zero(ridgeNum);
+  // The result is not decomposed into the ridges in the Cone formulation
+  resultWrenchRatio_ = Eigen::VectorXd::Zero(config_.formulation == Formulation::Cone ? 0 : ridgeNum);
 
   QpSolverCollection::QpSolverType qpSolverType = QpSolverCollection::QpSolverType::Any;
   if(mcRtcConfig.has("qpSolverType"))
   {
-    qpSolverType = QpSolverCollection::strToQpSolverType(mcRtcConfig("qpSolverType"));
+    std::string qpSolverTypeStr = mcRtcConfig("qpSolverType");
+    if(qpSolverTypeStr == "Auto")
+    {
+      // The solver selected in warmUpQpSolverSelection() is used in solveQp() when the QP shape is known
+      autoQpSolver_ = true;
+    }
+    else
+    {
+      qpSolverType = QpSolverCollection::strToQpSolverType(qpSolverTypeStr);
+    }
   }
   qpSolver_ = QpSolverCollection::allocateQpSolver(qpSolverType);
+  if(autoQpSolver_)
+  {
+    qpSolverMap_.emplace(qpSolver_->type(), qpSolver_);
+    for(const auto & availableQpSolverType : QpSolverSelector::availableQpSolverTypes())
+    {
+      if(qpSolverMap_.count(availableQpSolverType) == 0)
+      {
+        qpSolverMap_.emplace(availableQpSolverType, QpSolverCollection::allocateQpSolver(availableQpSolverType));
+      }
+    }
+  }
+
+  solutionCache_ = SolutionCache(static_cast<size_t>(std::max(config_.solutionCacheSize, 0)));
 }
 
 sva::ForceVecd WrenchDistribution::run(const sva::ForceVecd & desiredTotalWrench, const Eigen::Vector3d & momentOrigin)
 {
   desiredTotalWrench_ = desiredTotalWrench;
+  updateSolverContactList();
+
+  // Look up the solution cache
+  solutionCacheHit_ = false;
+  bool solutionCacheEnabled = (config_.solutionCacheSize > 0 && config_.formulation != Formulation::Cone);
+  if(solutionCacheEnabled)
+  {
+    if(const Eigen::VectorXd * wrenchRatio = solutionCache_.find(makeSolutionCacheKey(momentOrigin)))
+    {
+      // The key contains the number of ridges of each contact, so the size of the wrench ratio is consistent
+      resultWrenchRatio_ = *wrenchRatio;
+      updateTotalGraspMat(momentOrigin);
+      resultTotalWrench_ = sva::ForceVecd(totalGraspMat_ * resultWrenchRatio_);
+      criticalRegionHit_ = false;
+      projectionUsed_ = false;
+      solutionCacheHit_ = true;
+      return resultTotalWrench_;
+    }
+  }
+
+  // Skip QP between the decimated solves
+  if(projectWrenchRatio(momentOrigin))
+  {
+    return resultTotalWrench_;
+  }
+
+  // Coarsen the friction pyramids according to the last result, and refine them according to the current result
+  bool adaptive = (config_.adaptiveRidgeNum.second > 0);
+  if(adaptive)
+  {
+    adaptFricPyramids(false);
+  }
+  calcWrenchRatio(momentOrigin);
+  if(adaptive && adaptFricPyramids(true))
+  {
+    calcWrenchRatio(momentOrigin);
+  }
+  storeProjection(momentOrigin);
+
+  if(solutionCacheEnabled && !qpSolver_->solveFailed())
+  {
+    // The key is made again because the friction pyramids may be adapted
+    solutionCache_.insert(makeSolutionCacheKey(momentOrigin), resultWrenchRatio_);
+  }
+
+  return resultTotalWrench_;
+}
+
+void WrenchDistribution::calcWrenchRatio(const Eigen::Vector3d & momentOrigin)
+{
+  int ridgeNum = std::accumulate(solverContactList_.begin(), solverContactList_.end(), 0,
+                                 [](int _ridgeNum, const auto & contact) { return _ridgeNum + contact->ridgeNum(); });
 
   // Return if variable dimension is zero
-  if(resultWrenchRatio_.size() == 0)
+  if(ridgeNum == 0)
   {
+    resultWrenchRatio_.resize(0);
     resultTotalWrench_ = sva::ForceVecd::Zero();
-    return resultTotalWrench_;
+    return;
   }
 
-  // Resize QP if needed
+  criticalRegionHit_ = false;
+  coneConverged_ = true;
+  lastCriticalRegion_.reset();
+  fullQpSetup_ = true;
+  qpCoeffRevision_ = ++lastQpRevision;
+  lastCriticalRegionRevision_ = ++lastQpRevision;
+
+  // Solve by adding the tangent planes of friction cones
+  if(config_.formulation == Formulation::Cone)
   {
-    int varDim = static_cast<int>(resultWrenchRatio_.size());
-    int ineqDim =
-        std::accumulate(contactList_.begin(), contactList_.end(), 0,
-                        [](int _ineqDim, const auto & contact) { return _ineqDim + (contact->maxWrench_ ? 12 : 0); });
-    if(qpCoeff_.dim_var_ != varDim || qpCoeff_.dim_ineq_ != ineqDim)
-    {
-      qpCoeff_.setup(varDim, 0, ineqDim);
-    }
-    if(qpCoeff_.dim_ineq_ != 0)
-    {
-      qpCoeff_.ineq_mat_.setZero();
-    }
+    fullQpSetup_ = false;
+    runCone(momentOrigin);
+    return;
   }
 
-  // Construct totalGraspMat
-  Eigen::Matrix<double, 6, Eigen::Dynamic> totalGraspMat(6, resultWrenchRatio_.size());
+  // Resize if the number of ridges is changed
+  if(resultWrenchRatio_.size() != ridgeNum)
   {
-    int ridgeNum = 0;
-    int ineqRow = 0;
-    for(const auto & contact : contactList_)
+    resultWrenchRatio_ = Eigen::VectorXd::Zero(ridgeNum);
+  }
+
+  updateTotalGraspMat(momentOrigin);
+
+  // Solve by the coarse-to-fine method
+  if(config_.coarseVertexNum > 0 && config_.formulation == Formulation::Ridge)
+  {
+    runCoarseToFine();
+    resultTotalWrench_ = sva::ForceVecd(totalGraspMat_ * resultWrenchRatio_);
+    return;
+  }
+
+  // Look up critical regions
+  if(config_.criticalRegionNumMax > 0)
+  {
+    checkCriticalRegionKey();
+    for(auto it = criticalRegionList_.begin(); it != criticalRegionList_.end(); it++)
     {
-      totalGraspMat.middleCols(ridgeNum, contact->ridgeNum()) = contact->graspMat_;
-      if(contact->maxWrench_)
+      if(it->contains(desiredTotalWrench_.vector()))
       {
-        const auto & maxWrench = contact->maxWrench_->vector();
-        qpCoeff_.ineq_mat_.block(ineqRow, ridgeNum, 6, contact->ridgeNum()).noalias() = -contact->localGraspMat_;
-        qpCoeff_.ineq_mat_.block(ineqRow + 6, ridgeNum, 6, contact->ridgeNum()).noalias() = contact->localGraspMat_;
-        qpCoeff_.ineq_vec_.segment(ineqRow, 6) = maxWrench;
-        qpCoeff_.ineq_vec_.segment(ineqRow + 6, 6) = maxWrench;
-        ineqRow += 12;
+        qpSolution_ = it->calcSolution(desiredTotalWrench_.vector());
+        std::rotate(criticalRegionList_.begin(), it, it + 1);
+        criticalRegionHit_ = true;
+        break;
       }
-      ridgeNum += contact->ridgeNum();
     }
-    if(momentOrigin.norm() > 0)
+  }
+
+  // Solve QP
+  if(!criticalRegionHit_)
+  {
+    if(config_.formulation == Formulation::Ridge)
+    {
+      setupRidgeQp();
+    }
+    else if(config_.formulation == Formulation::Lifted)
+    {
+      setupLiftedQp(momentOrigin);
+    }
+    else
+    {
+      setupWrenchQp(momentOrigin);
+    }
+    qpSolution_ = solveQp();
+
+    if(config_.criticalRegionNumMax > 0 && !qpSolver_->solveFailed())
     {
-      for(int i = 0; i < ridgeNum; i++)
+      lastCriticalRegion_ =
+          CriticalRegion::makeFromSolution(qpCoeff_, objParamMat_, qpSolution_, desiredTotalWrench_.vector());
+      if(lastCriticalRegion_)
       {
-        // totalGraspMat.col(i).tail<3>() is the force ridge
-        totalGraspMat.col(i).head<3>() -= momentOrigin.cross(totalGraspMat.col(i).tail<3>());
+        if(static_cast<int>(criticalRegionList_.size()) >= config_.criticalRegionNumMax)
+        {
+          criticalRegionList_.pop_back();
+        }
+        criticalRegionList_.insert(criticalRegionList_.begin(), *lastCriticalRegion_);
       }
     }
   }
 
-  // Solve QP
+  if(config_.formulation == Formulation::Ridge)
   {
-    Eigen::MatrixXd weightMat = config_.wrenchWeight.vector().asDiagonal();
-    qpCoeff_.obj_mat_.noalias() = totalGraspMat.transpose() * weightMat * totalGraspMat;
-    qpCoeff_.obj_mat_.diagonal().array() += config_.regularWeight;
-    qpCoeff_.obj_vec_.noalias() = -1 * totalGraspMat.transpose() * weightMat * desiredTotalWrench_.vector();
-    qpCoeff_.x_min_.setConstant(qpCoeff_.dim_var_, config_.ridgeForceMinMax.first);
-    qpCoeff_.x_max_.setConstant(qpCoeff_.dim_var_, config_.ridgeForceMinMax.second);
-    resultWrenchRatio_ = qpSolver_->solve(qpCoeff_);
+    resultWrenchRatio_ = qpSolution_;
+  }
+  else if(config_.formulation == Formulation::Lifted)
+  {
+    resultWrenchRatio_ = qpSolution_.head(resultWrenchRatio_.size());
+  }
+  else
+  {
+    calcWrenchRatioFromWrench(qpSolution_);
   }
 
-  resultTotalWrench_ = sva::ForceVecd(totalGraspMat * resultWrenchRatio_);
+  resultTotalWrench_ = sva::ForceVecd(totalGraspMat_ * resultWrenchRatio_);
+}
 
-  return resultTotalWrench_;
+void WrenchDistribution::updateTotalGraspMat(const Eigen::Vector3d & momentOrigin)
+{
+  totalGraspMat_.resize(6, resultWrenchRatio_.size());
+  int ridgeNum = 0;
+  for(const auto & contact : solverContactList_)
+  {
+    totalGraspMat_.middleCols(ridgeNum, contact->ridgeNum()) = contact->graspMat_;
+    ridgeNum += contact->ridgeNum();
+  }
+  if(momentOrigin.norm() > 0)
+  {
+    for(int i = 0; i < ridgeNum; i++)
+    {
+      // totalGraspMat_.col(i).tail<3>() is the force ridge
+      totalGraspMat_.col(i).head<3>() -= momentOrigin.cross(totalGraspMat_.col(i).tail<3>());
+    }
+  }
 }
 
-void WrenchDistribution::addToGUI(mc_rtc::gui::StateBuilder & gui,
-                                  const std::vector<std::string> & category,
-                                  double forceScale,
-                                  double fricPyramidScale)
+SolutionCache::Key WrenchDistribution::makeSolutionCacheKey(const Eigen::Vector3d & momentOrigin) const
 {
-  int wrenchRatioIdx = 0;
+  auto quantize = [](double value, double resolution) {
+    return static_cast<int64_t>(std::llround(value / resolution));
+  };
+
+  // Friction coefficients closer than this are regarded as the same
+  constexpr double fricCoeffResolution = 1e-6;
+
+  SolutionCache::Key key;
+  key.reserve(22 * solverContactList_.size() + 9);
+  for(const auto & contact : solverContactList_)
+  {
+    key.push_back(contact->ridgeNum());
+    key.push_back(static_cast<int64_t>(contact->localGraspMatRevision()));
+    key.push_back(contact->fricPyramid_ ? quantize(contact->fricPyramid_->fricCoeff_, fricCoeffResolution) : -1);
+    key.push_back(contact->maxWrench_.has_value());
+    for(int i = 0; i < 6; i++)
+    {
+      key.push_back(contact->maxWrench_
+                        ? quantize(contact->maxWrench_->vector()[i], config_.solutionCacheWrenchResolution)
+                        : 0);
+    }
+    for(int i = 0; i < 3; i++)
+    {
+      key.push_back(quantize(contact->pose_.translation()[i], config_.solutionCachePosResolution));
+    }
+    const Eigen::Matrix3d & rot = contact->pose_.rotation();
+    for(Eigen::DenseIndex i = 0; i < rot.size(); i++)
+    {
+      key.push_back(quantize(rot(i), config_.solutionCacheRotResolution));
+    }
+  }
+  for(int i = 0; i < 6; i++)
+  {
+    key.push_back(quantize(desiredTotalWrench_.vector()[i], config_.solutionCacheWrenchResolution));
+  }
+  for(int i = 0; i < 3; i++)
+  {
+    key.push_back(quantize(momentOrigin[i], config_.solutionCachePosResolution));
+  }
+  return key;
+}
 
+void WrenchDistribution::clearSolutionCache()
+{
+  solutionCache_.clear();
+}
+
+std::shared_ptr<const WrenchDistribution::Snapshot> WrenchDistribution::snapshot()
+{
+  auto snapshot = std::make_shared<Snapshot>();
+
+  snapshot->ownerId = id_;
+  snapshot->contactPtrList = contactList_;
+  snapshot->contactList.reserve(contactList_.size());
   for(const auto & contact : contactList_)
   {
-    contact->addToGUI(gui, category, forceScale, fricPyramidScale,
-                      resultWrenchRatio_.segment(wrenchRatioIdx, contact->ridgeNum()));
+    // Share the copy in the last snapshot if the contact is not changed
+    std::shared_ptr<const Contact> contactCopy;
+    if(lastSnapshot_)
+    {
+      const auto & lastContactPtrList = lastSnapshot_->contactPtrList;
+      auto it = std::find(lastContactPtrList.begin(), lastContactPtrList.end(), contact);
+      if(it != lastContactPtrList.end())
+      {
+        const auto & lastContactCopy = lastSnapshot_->contactList[it - lastContactPtrList.begin()];
+        if(isContactStateEqual(*contact, *lastContactCopy))
+        {
+          contactCopy = lastContactCopy;
+        }
+      }
+    }
+    if(!contactCopy)
+    {
+      contactCopy = contact->clone();
+    }
+    snapshot->contactList.push_back(contactCopy);
+  }
+
+  snapshot->resultWrenchRatio = resultWrenchRatio_;
+  snapshot->desiredTotalWrench = desiredTotalWrench_;
+  snapshot->resultTotalWrench = resultTotalWrench_;
+  // Share the QP data in the last snapshot if they are not changed
+  if(lastSnapshot_ && lastSnapshot_->qpCoeffRevision == qpCoeffRevision_)
+  {
+    snapshot->qpCoeff = lastSnapshot_->qpCoeff;
+    snapshot->objParamMat = lastSnapshot_->objParamMat;
+  }
+  else
+  {
+    snapshot->qpCoeff = std::make_shared<const QpSolverCollection::QpCoeff>(qpCoeff_);
+    snapshot->objParamMat = std::make_shared<const Eigen::MatrixXd>(objParamMat_);
+  }
+  snapshot->qpCoeffRevision = qpCoeffRevision_;
+  snapshot->totalGraspMat = totalGraspMat_;
+  snapshot->qpSolution = qpSolution_;
+  snapshot->resultWrenchList = resultWrenchList_;
+  snapshot->criticalRegionHit = criticalRegionHit_;
+  snapshot->projectionUsed = projectionUsed_;
+  snapshot->solutionCacheHit = solutionCacheHit_;
+  snapshot->coneConverged = coneConverged_;
+  snapshot->fullQpSetup = fullQpSetup_;
+  snapshot->coneCutAngleList = coneCutAngleList_;
+  if(lastSnapshot_ && lastSnapshot_->lastCriticalRegionRevision == lastCriticalRegionRevision_)
+  {
+    snapshot->lastCriticalRegion = lastSnapshot_->lastCriticalRegion;
+  }
+  else if(lastCriticalRegion_)
+  {
+    snapshot->lastCriticalRegion = std::make_shared<const CriticalRegion>(*lastCriticalRegion_);
+  }
+  snapshot->lastCriticalRegionRevision = lastCriticalRegionRevision_;
+  snapshot->qpDecimationCount = qpDecimationCount_;
+  snapshot->projectionGainMat = projectionGainMat_;
+  snapshot->projectionSolution = projectionSolution_;
+  snapshot->projectionDesiredTotalWrench = projectionDesiredTotalWrench_;
+  snapshot->projectionMomentOrigin = projectionMomentOrigin_;
+  snapshot->adaptedRidgeNumList.reserve(adaptedContactList_.size());
+  for(const auto & adaptedContact : adaptedContactList_)
+  {
+    snapshot->adaptedRidgeNumList.push_back(adaptedContact.contact ? adaptedContact.contact->fricPyramid_->ridgeNum()
+                                                                   : 0);
+  }
+
+  lastSnapshot_ = snapshot;
+  return snapshot;
+}
+
+void WrenchDistribution::restore(const std::shared_ptr<const Snapshot> & snapshot)
+{
+  if(!snapshot)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[WrenchDistribution::restore] Snapshot is null.");
+  }
+  if(snapshot->ownerId != id_)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>(
+        "[WrenchDistribution::restore] Snapshot is taken by another instance.");
+  }
+  if(!snapshot->qpCoeff || !snapshot->objParamMat)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[WrenchDistribution::restore] QP coefficients are null.");
+  }
+  if(snapshot->contactPtrList.size() != snapshot->contactList.size())
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>(
+        "[WrenchDistribution::restore] Numbers of contacts ({}) and their copies ({}) mismatch.",
+        snapshot->contactPtrList.size(), snapshot->contactList.size());
+  }
+  for(size_t i = 0; i < snapshot->contactPtrList.size(); i++)
+  {
+    const auto & contact = snapshot->contactPtrList[i];
+    const auto & contactCopy = snapshot->contactList[i];
+    if(!contact || !contactCopy || contact->type() != contactCopy->type() || contact->name_ != contactCopy->name_)
+    {
+      mc_rtc::log::error_and_throw<std::runtime_error>(
+          "[WrenchDistribution::restore] Contact {} does not match its copy in the snapshot.", i);
+    }
+  }
+
+  contactList_ = snapshot->contactPtrList;
+  for(size_t i = 0; i < contactList_.size(); i++)
+  {
+    if(!isContactStateEqual(*contactList_[i], *snapshot->contactList[i]))
+    {
+      assignContact(*contactList_[i], *snapshot->contactList[i]);
+    }
+  }
+
+  resultWrenchRatio_ = snapshot->resultWrenchRatio;
+  desiredTotalWrench_ = snapshot->desiredTotalWrench;
+  resultTotalWrench_ = snapshot->resultTotalWrench;
+  // The QP data are copied only if they are changed since the snapshot (the revisions are unique over all instances)
+  if(qpCoeffRevision_ != snapshot->qpCoeffRevision)
+  {
+    qpCoeff_ = *snapshot->qpCoeff;
+    objParamMat_ = *snapshot->objParamMat;
+    ridgeQpIneqKeyList_.clear();
+    qpCoeffRevision_ = snapshot->qpCoeffRevision;
+  }
+  totalGraspMat_ = snapshot->totalGraspMat;
+  qpSolution_ = snapshot->qpSolution;
+  resultWrenchList_ = snapshot->resultWrenchList;
+  criticalRegionHit_ = snapshot->criticalRegionHit;
+  projectionUsed_ = snapshot->projectionUsed;
+  solutionCacheHit_ = snapshot->solutionCacheHit;
+  coneConverged_ = snapshot->coneConverged;
+  fullQpSetup_ = snapshot->fullQpSetup;
+  coneCutAngleList_ = snapshot->coneCutAngleList;
+  if(lastCriticalRegionRevision_ != snapshot->lastCriticalRegionRevision)
+  {
+    if(snapshot->lastCriticalRegion)
+    {
+      lastCriticalRegion_ = *snapshot->lastCriticalRegion;
+    }
+    else
+    {
+      lastCriticalRegion_.reset();
+    }
+    lastCriticalRegionRevision_ = snapshot->lastCriticalRegionRevision;
+  }
+  qpDecimationCount_ = snapshot->qpDecimationCount;
+  projectionGainMat_ = snapshot->projectionGainMat;
+  projectionSolution_ = snapshot->projectionSolution;
+  projectionDesiredTotalWrench_ = snapshot->projectionDesiredTotalWrench;
+  projectionMomentOrigin_ = snapshot->projectionMomentOrigin;
+
+  // The adapted copies are reused if they have the same friction pyramids
+  adaptedContactList_.resize(contactList_.size());
+  for(size_t i = 0; i < contactList_.size(); i++)
+  {
+    int ridgeNum = i < snapshot->adaptedRidgeNumList.size() ? snapshot->adaptedRidgeNumList[i] : 0;
+    auto & adaptedContact = adaptedContactList_[i];
+    if(ridgeNum == 0)
+    {
+      adaptedContact = AdaptedContact();
+    }
+    else if(!adaptedContact.contact || adaptedContact.source != contactList_[i]
+            || adaptedContact.contact->fricPyramid_->ridgeNum() != ridgeNum)
+    {
+      adaptedContact = makeAdaptedContact(contactList_[i], ridgeNum);
+    }
+  }
+  updateSolverContactList();
+
+  lastSnapshot_ = snapshot;
+}
+
+bool WrenchDistribution::projectWrenchRatio(const Eigen::Vector3d & momentOrigin)
+{
+  projectionUsed_ = false;
+  if(config_.qpDecimation <= 1 || projectionGainMat_.size() == 0)
+  {
+    return false;
+  }
+
+  qpDecimationCount_++;
+  int ridgeNum = std::accumulate(solverContactList_.begin(), solverContactList_.end(), 0,
+                                 [](int _ridgeNum, const auto & contact) { return _ridgeNum + contact->ridgeNum(); });
+  if(qpDecimationCount_ >= config_.qpDecimation || ridgeNum != resultWrenchRatio_.size()
+     || momentOrigin != projectionMomentOrigin_)
+  {
+    return false;
+  }
+
+  // The grasp matrices are updated because the contact poses may be changed since the last QP solve
+  updateTotalGraspMat(momentOrigin);
+
+  Eigen::VectorXd solution =
+      projectionSolution_ + projectionGainMat_ * (desiredTotalWrench_.vector() - projectionDesiredTotalWrench_);
+  if(config_.formulation == Formulation::Wrench)
+  {
+    calcWrenchRatioFromWrench(solution);
+  }
+  else
+  {
+    // In the Lifted formulation, the ridge forces are the head of the solution
+    resultWrenchRatio_ = solution.head(ridgeNum)
+                             .cwiseMax(config_.ridgeForceMinMax.first)
+                             .cwiseMin(config_.ridgeForceMinMax.second);
+  }
+  resultTotalWrench_ = sva::ForceVecd(totalGraspMat_ * resultWrenchRatio_);
+  criticalRegionHit_ = false;
+  projectionUsed_ = true;
+  return true;
+}
+
+void WrenchDistribution::storeProjection(const Eigen::Vector3d & momentOrigin)
+{
+  qpDecimationCount_ = 0;
+  projectionGainMat_.resize(0, 0);
+  if(config_.qpDecimation <= 1 || config_.formulation == Formulation::Cone || resultWrenchRatio_.size() == 0
+     || qpSolver_->solveFailed())
+  {
+    return;
+  }
+
+  try
+  {
+    projectionGainMat_ = lastCriticalRegion().gainMat_;
+  }
+  catch(const std::runtime_error &)
+  {
+    // QP is solved again in the next run() if the active set is not identified
+    projectionGainMat_.resize(0, 0);
+    return;
+  }
+  projectionSolution_ = config_.formulation == Formulation::Ridge ? resultWrenchRatio_ : qpSolution_;
+  projectionDesiredTotalWrench_ = desiredTotalWrench_.vector();
+  projectionMomentOrigin_ = momentOrigin;
+}
+
+void WrenchDistribution::setupRidgeQp()
+{
+  // Resize QP if needed
+  {
+    int varDim = static_cast<int>(resultWrenchRatio_.size());
+    int ineqDim =
+        std::accumulate(solverContactList_.begin(), solverContactList_.end(), 0,
+                        [](int _ineqDim, const auto & contact) { return _ineqDim + (contact->maxWrench_ ? 12 : 0); });
+    if(qpCoeff_.dim_var_ != varDim || qpCoeff_.dim_eq_ != 0 || qpCoeff_.dim_ineq_ != ineqDim)
+    {
+      qpCoeff_.setup(varDim, 0, ineqDim);
+      ridgeQpIneqKeyList_.clear();
+    }
+  }
+
+  // Clear the inequality rows if the layout of the rows and columns is changed
+  {
+    bool layoutChanged = (ridgeQpIneqKeyList_.size() != solverContactList_.size());
+    for(size_t i = 0; i < solverContactList_.size() && !layoutChanged; i++)
+    {
+      const auto & contact = solverContactList_[i];
+      const auto & ineqKey = ridgeQpIneqKeyList_[i];
+      layoutChanged =
+          (ineqKey.ridgeNum != contact->ridgeNum() || ineqKey.hasMaxWrench != contact->maxWrench_.has_value());
+    }
+    if(layoutChanged)
+    {
+      if(qpCoeff_.dim_ineq_ != 0)
+      {
+        qpCoeff_.ineq_mat_.setZero();
+      }
+      ridgeQpIneqKeyList_.assign(solverContactList_.size(), RidgeQpIneqKey());
+      for(size_t i = 0; i < solverContactList_.size(); i++)
+      {
+        ridgeQpIneqKeyList_[i].ridgeNum = solverContactList_[i]->ridgeNum();
+        ridgeQpIneqKeyList_[i].hasMaxWrench = solverContactList_[i]->maxWrench_.has_value();
+      }
+    }
+  }
+
+  // Set inequality constraints of maximum wrench
+  // The rows are written only for the contacts whose local grasp matrices are changed
+  {
+    int ridgeNum = 0;
+    int ineqRow = 0;
+    for(size_t i = 0; i < solverContactList_.size(); i++)
+    {
+      const auto & contact = solverContactList_[i];
+      if(contact->maxWrench_)
+      {
+        auto & ineqKey = ridgeQpIneqKeyList_[i];
+        if(ineqKey.localGraspMatRevision != contact->localGraspMatRevision())
+        {
+          qpCoeff_.ineq_mat_.block(ineqRow, ridgeNum, 6, contact->ridgeNum()).noalias() = -contact->localGraspMat_;
+          qpCoeff_.ineq_mat_.block(ineqRow + 6, ridgeNum, 6, contact->ridgeNum()).noalias() = contact->localGraspMat_;
+          ineqKey.localGraspMatRevision = contact->localGraspMatRevision();
+        }
+        const auto & maxWrench = contact->maxWrench_->vector();
+        qpCoeff_.ineq_vec_.segment(ineqRow, 6) = maxWrench;
+        qpCoeff_.ineq_vec_.segment(ineqRow + 6, 6) = maxWrench;
+        ineqRow += 12;
+      }
+      ridgeNum += contact->ridgeNum();
+    }
+  }
+
+  // Set objective and bounds
+  // The objective is rebuilt for all contacts because it depends on the global poses of all contacts
+  {
+    Eigen::MatrixXd weightMat = config_.wrenchWeight.vector().asDiagonal();
+    qpCoeff_.obj_mat_.noalias() = totalGraspMat_.transpose() * weightMat * totalGraspMat_;
+    qpCoeff_.obj_mat_.diagonal().array() += config_.regularWeight;
+    objParamMat_.noalias() = -1 * totalGraspMat_.transpose() * weightMat;
+    qpCoeff_.obj_vec_.noalias() = objParamMat_ * desiredTotalWrench_.vector();
+    qpCoeff_.x_min_.setConstant(qpCoeff_.dim_var_, config_.ridgeForceMinMax.first);
+    qpCoeff_.x_max_.setConstant(qpCoeff_.dim_var_, config_.ridgeForceMinMax.second);
+  }
+}
+
+void WrenchDistribution::setupWrenchQp(const Eigen::Vector3d & momentOrigin)
+{
+  // The inequality rows of the Ridge QP are overwritten
+  ridgeQpIneqKeyList_.clear();
+
+  // Resize QP if needed
+  {
+    int varDim = 0;
+    int eqDim = 0;
+    int ineqDim = 0;
+    for(const auto & contact : solverContactList_)
+    {
+      if(contact->ridgeNum() == 0)
+      {
+        continue;
+      }
+      const auto & wrenchCone = contact->wrenchCone();
+      varDim += 6;
+      eqDim += static_cast<int>(wrenchCone.eqMat_.rows());
+      ineqDim += static_cast<int>(wrenchCone.ineqMat_.rows()) + (contact->maxWrench_ ? 12 : 0);
+    }
+    if(qpCoeff_.dim_var_ != varDim || qpCoeff_.dim_eq_ != eqDim || qpCoeff_.dim_ineq_ != ineqDim)
+    {
+      qpCoeff_.setup(varDim, eqDim, ineqDim);
+    }
+    if(qpCoeff_.dim_eq_ != 0)
+    {
+      qpCoeff_.eq_mat_.setZero();
+    }
+    if(qpCoeff_.dim_ineq_ != 0)
+    {
+      qpCoeff_.ineq_mat_.setZero();
+    }
+  }
+
+  // Set constraints of contact wrench cone and maximum wrench
+  // The contact wrenches are expressed around the world origin
+  Eigen::Matrix<double, 6, Eigen::Dynamic> totalTransMat(6, qpCoeff_.dim_var_);
+  {
+    Eigen::Matrix<double, 6, 6> momentTransMat = Eigen::Matrix<double, 6, 6>::Identity();
+    momentTransMat.topRightCorner<3, 3>() = -1 * sva::vector3ToCrossMatrix(momentOrigin);
+
+    int varIdx = 0;
+    int eqRow = 0;
+    int ineqRow = 0;
+    for(const auto & contact : solverContactList_)
+    {
+      if(contact->ridgeNum() == 0)
+      {
+        continue;
+      }
+
+      totalTransMat.middleCols<6>(varIdx) = momentTransMat;
+
+      // The wrench with the minimum ridge forces is the vertex of the cone
+      const auto & wrenchCone = contact->wrenchCone();
+      Eigen::Vector6d minWrench = config_.ridgeForceMinMax.first * contact->graspMat_.rowwise().sum();
+      int eqNum = static_cast<int>(wrenchCone.eqMat_.rows());
+      int ineqNum = static_cast<int>(wrenchCone.ineqMat_.rows());
+      qpCoeff_.eq_mat_.block(eqRow, varIdx, eqNum, 6) = wrenchCone.eqMat_;
+      qpCoeff_.eq_vec_.segment(eqRow, eqNum).noalias() = wrenchCone.eqMat_ * minWrench;
+      qpCoeff_.ineq_mat_.block(ineqRow, varIdx, ineqNum, 6) = wrenchCone.ineqMat_;
+      qpCoeff_.ineq_vec_.segment(ineqRow, ineqNum).noalias() = wrenchCone.ineqMat_ * minWrench;
+      eqRow += eqNum;
+      ineqRow += ineqNum;
+
+      if(contact->maxWrench_)
+      {
+        const auto & maxWrench = contact->maxWrench_->vector();
+        Eigen::Matrix<double, 6, 6> localTransMat = contact->pose_.dualMatrix();
+        qpCoeff_.ineq_mat_.block<6, 6>(ineqRow, varIdx) = -localTransMat;
+        qpCoeff_.ineq_mat_.block<6, 6>(ineqRow + 6, varIdx) = localTransMat;
+        qpCoeff_.ineq_vec_.segment<6>(ineqRow) = maxWrench;
+        qpCoeff_.ineq_vec_.segment<6>(ineqRow + 6) = maxWrench;
+        ineqRow += 12;
+      }
+
+      varIdx += 6;
+    }
+  }
+
+  // Set objective and bounds
+  {
+    Eigen::MatrixXd weightMat = config_.wrenchWeight.vector().asDiagonal();
+    qpCoeff_.obj_mat_.noalias() = totalTransMat.transpose() * weightMat * totalTransMat;
+    qpCoeff_.obj_mat_.diagonal().array() += config_.regularWeight;
+    objParamMat_.noalias() = -1 * totalTransMat.transpose() * weightMat;
+    qpCoeff_.obj_vec_.noalias() = objParamMat_ * desiredTotalWrench_.vector();
+    qpCoeff_.x_min_.setConstant(qpCoeff_.dim_var_, -1e10);
+    qpCoeff_.x_max_.setConstant(qpCoeff_.dim_var_, 1e10);
+  }
+}
+
+void WrenchDistribution::setupLiftedQp(const Eigen::Vector3d & momentOrigin)
+{
+  // The inequality rows of the Ridge QP are overwritten
+  ridgeQpIneqKeyList_.clear();
+
+  // Resize QP if needed
+  // The variables are the ridge forces, the local contact wrenches, and the total wrench around the moment origin
+  int ridgeNum = static_cast<int>(resultWrenchRatio_.size());
+  int wrenchDim = 6
+                  * static_cast<int>(std::count_if(solverContactList_.begin(), solverContactList_.end(),
+                                                   [](const auto & contact) { return contact->ridgeNum() > 0; }));
+  int totalWrenchIdx = ridgeNum + wrenchDim;
+  {
+    if(qpCoeff_.dim_var_ != totalWrenchIdx + 6 || qpCoeff_.dim_eq_ != wrenchDim + 6 || qpCoeff_.dim_ineq_ != 0)
+    {
+      qpCoeff_.setup(totalWrenchIdx + 6, wrenchDim + 6, 0);
+    }
+    qpCoeff_.eq_mat_.setZero();
+    qpCoeff_.eq_vec_.setZero();
+  }
+
+  // Set equality constraints linking the local contact wrenches to the ridge forces and to the total wrench, and the
+  // bounds of maximum wrench
+  qpCoeff_.x_min_.head(ridgeNum).setConstant(config_.ridgeForceMinMax.first);
+  qpCoeff_.x_max_.head(ridgeNum).setConstant(config_.ridgeForceMinMax.second);
+  qpCoeff_.eq_mat_.block<6, 6>(wrenchDim, totalWrenchIdx).setIdentity();
+  {
+    int ridgeIdx = 0;
+    int varIdx = ridgeNum;
+    int eqRow = 0;
+    for(const auto & contact : solverContactList_)
+    {
+      if(contact->ridgeNum() == 0)
+      {
+        continue;
+      }
+
+      qpCoeff_.eq_mat_.block(eqRow, ridgeIdx, 6, contact->ridgeNum()) = -1 * contact->localGraspMat_;
+      qpCoeff_.eq_mat_.block<6, 6>(eqRow, varIdx).setIdentity();
+
+      // The local wrench is transformed to the wrench around the moment origin
+      Eigen::Matrix3d rotTrans = contact->pose_.rotation().transpose();
+      Eigen::Matrix<double, 6, 6> transMat = Eigen::Matrix<double, 6, 6>::Zero();
+      transMat.topLeftCorner<3, 3>() = rotTrans;
+      transMat.topRightCorner<3, 3>() =
+          sva::vector3ToCrossMatrix(Eigen::Vector3d(contact->pose_.translation() - momentOrigin)) * rotTrans;
+      transMat.bottomRightCorner<3, 3>() = rotTrans;
+      qpCoeff_.eq_mat_.block<6, 6>(wrenchDim, varIdx) = -1 * transMat;
+
+      if(contact->maxWrench_)
+      {
+        qpCoeff_.x_min_.segment<6>(varIdx) = -1 * contact->maxWrench_->vector();
+        qpCoeff_.x_max_.segment<6>(varIdx) = contact->maxWrench_->vector();
+      }
+      else
+      {
+        qpCoeff_.x_min_.segment<6>(varIdx).setConstant(-1e10);
+        qpCoeff_.x_max_.segment<6>(varIdx).setConstant(1e10);
+      }
+
+      ridgeIdx += contact->ridgeNum();
+      varIdx += 6;
+      eqRow += 6;
+    }
+  }
+  qpCoeff_.x_min_.tail<6>().setConstant(-1e10);
+  qpCoeff_.x_max_.tail<6>().setConstant(1e10);
+
+  // Set objective
+  // The wrench weight is applied only to the total wrench variable, so the Hessian is diagonal
+  {
+    Eigen::MatrixXd weightMat = config_.wrenchWeight.vector().asDiagonal();
+    qpCoeff_.obj_mat_.setZero();
+    qpCoeff_.obj_mat_.bottomRightCorner<6, 6>() = weightMat;
+    qpCoeff_.obj_mat_.diagonal().array() += config_.regularWeight;
+    objParamMat_.setZero(qpCoeff_.dim_var_, 6);
+    objParamMat_.bottomRows<6>() = -1 * weightMat;
+    qpCoeff_.obj_vec_.noalias() = objParamMat_ * desiredTotalWrench_.vector();
+  }
+}
+
+void WrenchDistribution::setupConeQp(
+    const std::vector<Eigen::Matrix<double, 6, Eigen::Dynamic>> & vertexForceGraspMatList)
+{
+  // The inequality rows of the Ridge QP are overwritten
+  ridgeQpIneqKeyList_.clear();
+
+  // Resize QP if needed
+  {
+    int varDim = 0;
+    int ineqDim = 0;
+    size_t vertexIdx = 0;
+    for(size_t contactIdx = 0; contactIdx < solverContactList_.size(); contactIdx++)
+    {
+      int vertexNum = static_cast<int>(vertexForceGraspMatList[contactIdx].cols() / 3);
+      varDim += 3 * vertexNum;
+      for(int i = 0; i < vertexNum; i++)
+      {
+        ineqDim += static_cast<int>(coneCutAngleList_[vertexIdx++].size());
+      }
+      ineqDim += (solverContactList_[contactIdx]->maxWrench_ && vertexNum > 0 ? 12 : 0);
+    }
+    if(qpCoeff_.dim_var_ != varDim || qpCoeff_.dim_eq_ != 0 || qpCoeff_.dim_ineq_ != ineqDim)
+    {
+      qpCoeff_.setup(varDim, 0, ineqDim);
+    }
+    if(qpCoeff_.dim_ineq_ != 0)
+    {
+      qpCoeff_.ineq_mat_.setZero();
+    }
+  }
+
+  // Set constraints of friction cone tangent planes and maximum wrench
+  Eigen::Matrix<double, 6, Eigen::Dynamic> totalTransMat(6, qpCoeff_.dim_var_);
+  {
+    int varIdx = 0;
+    int ineqRow = 0;
+    size_t vertexIdx = 0;
+    for(size_t contactIdx = 0; contactIdx < solverContactList_.size(); contactIdx++)
+    {
+      const auto & contact = solverContactList_[contactIdx];
+      const auto & vertexForceGraspMat = vertexForceGraspMatList[contactIdx];
+      int vertexNum = static_cast<int>(vertexForceGraspMat.cols() / 3);
+      if(vertexNum == 0)
+      {
+        continue;
+      }
+      totalTransMat.middleCols(varIdx, 3 * vertexNum) = vertexForceGraspMat;
+
+      double fricCoeff = contact->fricPyramid_->fricCoeff_;
+      for(int i = 0; i < vertexNum; i++)
+      {
+        for(double angle : coneCutAngleList_[vertexIdx])
+        {
+          qpCoeff_.ineq_mat_.block<1, 3>(ineqRow, varIdx + 3 * i) << std::cos(angle), std::sin(angle), -fricCoeff;
+          qpCoeff_.ineq_vec_(ineqRow) = 0;
+          ineqRow++;
+        }
+        vertexIdx++;
+      }
+
+      if(contact->maxWrench_)
+      {
+        const auto & maxWrench = contact->maxWrench_->vector();
+        Eigen::Matrix<double, 6, Eigen::Dynamic> localVertexForceGraspMat =
+            contact->pose_.dualMatrix() * contact->calcVertexForceGraspMat();
+        qpCoeff_.ineq_mat_.block(ineqRow, varIdx, 6, 3 * vertexNum) = -1 * localVertexForceGraspMat;
+        qpCoeff_.ineq_mat_.block(ineqRow + 6, varIdx, 6, 3 * vertexNum) = localVertexForceGraspMat;
+        qpCoeff_.ineq_vec_.segment<6>(ineqRow) = maxWrench;
+        qpCoeff_.ineq_vec_.segment<6>(ineqRow + 6) = maxWrench;
+        ineqRow += 12;
+      }
+
+      varIdx += 3 * vertexNum;
+    }
+  }
+
+  // Set objective and bounds
+  {
+    Eigen::MatrixXd weightMat = config_.wrenchWeight.vector().asDiagonal();
+    qpCoeff_.obj_mat_.noalias() = totalTransMat.transpose() * weightMat * totalTransMat;
+    qpCoeff_.obj_mat_.diagonal().array() += config_.regularWeight;
+    objParamMat_.noalias() = -1 * totalTransMat.transpose() * weightMat;
+    qpCoeff_.obj_vec_.noalias() = objParamMat_ * desiredTotalWrench_.vector();
+    // Only the normal forces are bounded
+    for(int i = 0; i < qpCoeff_.dim_var_; i += 3)
+    {
+      qpCoeff_.x_min_.segment<3>(i) << -1e10, -1e10, config_.ridgeForceMinMax.first;
+      qpCoeff_.x_max_.segment<3>(i) << 1e10, 1e10, config_.ridgeForceMinMax.second;
+    }
+  }
+}
+
+void WrenchDistribution::runCone(const Eigen::Vector3d & momentOrigin)
+{
+  // Calculate vertex force grasp matrices around the world origin
+  std::vector<Eigen::Matrix<double, 6, Eigen::Dynamic>> vertexForceGraspMatList;
+  size_t vertexNum = 0;
+  for(const auto & contact : solverContactList_)
+  {
+    vertexForceGraspMatList.push_back(contact->ridgeNum() == 0 ? Eigen::Matrix<double, 6, Eigen::Dynamic>(6, 0)
+                                                               : contact->calcVertexForceGraspMat());
+    vertexNum += static_cast<size_t>(vertexForceGraspMatList.back().cols() / 3);
+  }
+
+  // Start from the square circumscribing the friction cone, or from the tangent planes of the last run()
+  if(coneCutAngleList_.size() != vertexNum)
+  {
+    coneCutAngleList_.assign(vertexNum, std::vector<double>{});
+    for(auto & coneCutAngles : coneCutAngleList_)
+    {
+      for(int i = 0; i < 4; i++)
+      {
+        coneCutAngles.push_back(mc_rtc::constants::PI * (0.25 + 0.5 * i));
+      }
+    }
+  }
+
+  // Shift moment origin for the objective
+  std::vector<Eigen::Matrix<double, 6, Eigen::Dynamic>> shiftedVertexForceGraspMatList = vertexForceGraspMatList;
+  if(momentOrigin.norm() > 0)
+  {
+    for(auto & vertexForceGraspMat : shiftedVertexForceGraspMatList)
+    {
+      for(Eigen::DenseIndex i = 0; i < vertexForceGraspMat.cols(); i++)
+      {
+        vertexForceGraspMat.col(i).head<3>() -= momentOrigin.cross(vertexForceGraspMat.col(i).tail<3>());
+      }
+    }
+  }
+
+  coneConverged_ = false;
+  for(int iter = 0; iter < config_.coneIterMax; iter++)
+  {
+    setupConeQp(shiftedVertexForceGraspMatList);
+    qpSolution_ = solveQp();
+
+    // Add tangent planes at the vertices violating the friction cone
+    bool added = false;
+    size_t vertexIdx = 0;
+    Eigen::DenseIndex varIdx = 0;
+    for(size_t contactIdx = 0; contactIdx < solverContactList_.size(); contactIdx++)
+    {
+      for(Eigen::DenseIndex i = 0; i < vertexForceGraspMatList[contactIdx].cols() / 3; i++)
+      {
+        Eigen::Vector3d force = qpSolution_.segment<3>(varIdx);
+        double fricCoeff = solverContactList_[contactIdx]->fricPyramid_->fricCoeff_;
+        if(force.head<2>().norm() > (1 + config_.coneTolerance) * fricCoeff * force.z())
+        {
+          auto & coneCutAngles = coneCutAngleList_[vertexIdx];
+          // Remove the oldest tangent plane except for the initial square to bound the QP size
+          if(static_cast<int>(coneCutAngles.size()) >= config_.coneCutNumMax)
+          {
+            coneCutAngles.erase(coneCutAngles.begin() + 4);
+          }
+          coneCutAngles.push_back(std::atan2(force.y(), force.x()));
+          added = true;
+        }
+        vertexIdx++;
+        varIdx += 3;
+      }
+    }
+    if(!added)
+    {
+      coneConverged_ = true;
+      break;
+    }
+  }
+
+  // Set result (the vertex forces in the friction cones are not decomposed into the ridges of the friction pyramids)
+  resultWrenchRatio_.resize(0);
+  resultWrenchList_.clear();
+  Eigen::DenseIndex varIdx = 0;
+  Eigen::Vector6d resultTotalWrench = Eigen::Vector6d::Zero();
+  for(size_t contactIdx = 0; contactIdx < solverContactList_.size(); contactIdx++)
+  {
+    Eigen::DenseIndex contactVarDim = vertexForceGraspMatList[contactIdx].cols();
+    Eigen::Vector6d wrench = vertexForceGraspMatList[contactIdx] * qpSolution_.segment(varIdx, contactVarDim);
+    resultWrenchList_.push_back(sva::ForceVecd(wrench));
+    resultTotalWrench += shiftedVertexForceGraspMatList[contactIdx] * qpSolution_.segment(varIdx, contactVarDim);
+    varIdx += contactVarDim;
+  }
+  resultTotalWrench_ = sva::ForceVecd(resultTotalWrench);
+}
+
+Eigen::VectorXd WrenchDistribution::solvePartialRidgeQp(const std::vector<bool> & freeList,
+                                                        const Eigen::VectorXd & fixedWrenchRatio)
+{
+  std::vector<Eigen::DenseIndex> freeIdxs;
+  for(size_t i = 0; i < freeList.size(); i++)
+  {
+    if(freeList[i])
+    {
+      freeIdxs.push_back(static_cast<Eigen::DenseIndex>(i));
+    }
+  }
+  if(freeIdxs.empty())
+  {
+    return fixedWrenchRatio;
+  }
+
+  // The inequality rows of the Ridge QP are overwritten
+  ridgeQpIneqKeyList_.clear();
+
+  // Resize QP if needed
+  {
+    int varDim = static_cast<int>(freeIdxs.size());
+    int ineqDim = 0;
+    int ridgeNum = 0;
+    for(const auto & contact : solverContactList_)
+    {
+      if(contact->maxWrench_
+         && std::any_of(freeList.begin() + ridgeNum, freeList.begin() + ridgeNum + contact->ridgeNum(),
+                        [](bool free) { return free; }))
+      {
+        ineqDim += 12;
+      }
+      ridgeNum += contact->ridgeNum();
+    }
+    if(qpCoeff_.dim_var_ != varDim || qpCoeff_.dim_eq_ != 0 || qpCoeff_.dim_ineq_ != ineqDim)
+    {
+      qpCoeff_.setup(varDim, 0, ineqDim);
+    }
+    if(qpCoeff_.dim_ineq_ != 0)
+    {
+      qpCoeff_.ineq_mat_.setZero();
+    }
+  }
+
+  // Set inequality constraints of maximum wrench, where the wrench of fixed ridges is moved to the right-hand side
+  Eigen::Matrix<double, 6, Eigen::Dynamic> freeGraspMat(6, qpCoeff_.dim_var_);
+  {
+    int ridgeNum = 0;
+    int ineqRow = 0;
+    int freeIdx = 0;
+    for(const auto & contact : solverContactList_)
+    {
+      int contactFreeIdx = freeIdx;
+      Eigen::Vector6d fixedLocalWrench = Eigen::Vector6d::Zero();
+      for(int i = 0; i < contact->ridgeNum(); i++)
+      {
+        if(freeList[ridgeNum + i])
+        {
+          freeGraspMat.col(freeIdx) = totalGraspMat_.col(ridgeNum + i);
+          if(contact->maxWrench_)
+          {
+            qpCoeff_.ineq_mat_.block<6, 1>(ineqRow, freeIdx) = -1 * contact->localGraspMat_.col(i);
+            qpCoeff_.ineq_mat_.block<6, 1>(ineqRow + 6, freeIdx) = contact->localGraspMat_.col(i);
+          }
+          freeIdx++;
+        }
+        else
+        {
+          fixedLocalWrench += fixedWrenchRatio(ridgeNum + i) * contact->localGraspMat_.col(i);
+        }
+      }
+      if(contact->maxWrench_ && freeIdx > contactFreeIdx)
+      {
+        const auto & maxWrench = contact->maxWrench_->vector();
+        qpCoeff_.ineq_vec_.segment<6>(ineqRow) = maxWrench + fixedLocalWrench;
+        qpCoeff_.ineq_vec_.segment<6>(ineqRow + 6) = maxWrench - fixedLocalWrench;
+        ineqRow += 12;
+      }
+      ridgeNum += contact->ridgeNum();
+    }
+  }
+
+  // Set objective and bounds
+  {
+    Eigen::Vector6d freeTotalWrench = desiredTotalWrench_.vector();
+    for(Eigen::DenseIndex i = 0; i < fixedWrenchRatio.size(); i++)
+    {
+      if(!freeList[static_cast<size_t>(i)])
+      {
+        freeTotalWrench -= fixedWrenchRatio(i) * totalGraspMat_.col(i);
+      }
+    }
+    Eigen::MatrixXd weightMat = config_.wrenchWeight.vector().asDiagonal();
+    qpCoeff_.obj_mat_.noalias() = freeGraspMat.transpose() * weightMat * freeGraspMat;
+    qpCoeff_.obj_mat_.diagonal().array() += config_.regularWeight;
+    qpCoeff_.obj_vec_.noalias() = -1 * freeGraspMat.transpose() * weightMat * freeTotalWrench;
+    qpCoeff_.x_min_.setConstant(qpCoeff_.dim_var_, config_.ridgeForceMinMax.first);
+    qpCoeff_.x_max_.setConstant(qpCoeff_.dim_var_, config_.ridgeForceMinMax.second);
+  }
+
+  Eigen::VectorXd freeWrenchRatio = solveQp();
+  Eigen::VectorXd wrenchRatio = fixedWrenchRatio;
+  for(size_t i = 0; i < freeIdxs.size(); i++)
+  {
+    wrenchRatio(freeIdxs[i]) = freeWrenchRatio(static_cast<Eigen::DenseIndex>(i));
+  }
+  return wrenchRatio;
+}
+
+void WrenchDistribution::runCoarseToFine()
+{
+  fullQpSetup_ = false;
+
+  // Coarse stage: optimize the ridges of the representative vertices selected by the farthest point sampling
+  std::vector<bool> freeList(static_cast<size_t>(resultWrenchRatio_.size()), false);
+  {
+    int ridgeNum = 0;
+    for(const auto & contact : solverContactList_)
+    {
+      const auto & vertexWithRidgeList = contact->vertexWithRidgeList_;
+      if(vertexWithRidgeList.empty())
+      {
+        ridgeNum += contact->ridgeNum();
+        continue;
+      }
+      int vertexNum = static_cast<int>(vertexWithRidgeList.size());
+      int vertexRidgeNum = contact->ridgeNum() / vertexNum;
+
+      Eigen::Vector3d centroid = Eigen::Vector3d::Zero();
+      for(const auto & vertexWithRidge : vertexWithRidgeList)
+      {
+        centroid += vertexWithRidge.vertex / vertexNum;
+      }
+      std::vector<double> distList(vertexNum);
+      for(int i = 0; i < vertexNum; i++)
+      {
+        distList[i] = (vertexWithRidgeList[i].vertex - centroid).norm();
+      }
+      for(int selectNum = 0; selectNum < std::min(vertexNum, config_.coarseVertexNum); selectNum++)
+      {
+        int selectIdx = static_cast<int>(std::max_element(distList.begin(), distList.end()) - distList.begin());
+        std::fill(freeList.begin() + ridgeNum + selectIdx * vertexRidgeNum,
+                  freeList.begin() + ridgeNum + (selectIdx + 1) * vertexRidgeNum, true);
+        for(int i = 0; i < vertexNum; i++)
+        {
+          distList[i] =
+              std::min(distList[i], (vertexWithRidgeList[i].vertex - vertexWithRidgeList[selectIdx].vertex).norm());
+        }
+      }
+      ridgeNum += contact->ridgeNum();
+    }
+  }
+  Eigen::VectorXd coarseWrenchRatio = solvePartialRidgeQp(
+      freeList, Eigen::VectorXd::Constant(resultWrenchRatio_.size(), config_.ridgeForceMinMax.first));
+
+  // Fine stage: optimize all ridges of the contacts whose coarse solution is near the bounds
+  std::vector<bool> refineList(freeList.size(), false);
+  {
+    int ridgeNum = 0;
+    for(const auto & contact : solverContactList_)
+    {
+      bool refine = false;
+      for(int i = 0; i < contact->ridgeNum(); i++)
+      {
+        double wrenchRatio = coarseWrenchRatio(ridgeNum + i);
+        if(freeList[ridgeNum + i]
+           && (wrenchRatio < config_.ridgeForceMinMax.first + config_.refineMargin
+               || wrenchRatio > config_.ridgeForceMinMax.second - config_.refineMargin))
+        {
+          refine = true;
+          break;
+        }
+      }
+      if(!refine && contact->maxWrench_)
+      {
+        Eigen::Vector6d localWrench =
+            contact->localGraspMat_ * coarseWrenchRatio.segment(ridgeNum, contact->ridgeNum());
+        refine =
+            ((localWrench.cwiseAbs() - contact->maxWrench_->vector()).array() > -config_.refineMargin).any();
+      }
+      if(refine)
+      {
+        std::fill(refineList.begin() + ridgeNum, refineList.begin() + ridgeNum + contact->ridgeNum(), true);
+      }
+      ridgeNum += contact->ridgeNum();
+    }
+  }
+  resultWrenchRatio_ = solvePartialRidgeQp(refineList, coarseWrenchRatio);
+  qpSolution_ = resultWrenchRatio_;
+}
+
+void WrenchDistribution::calcWrenchRatioFromWrench(const Eigen::VectorXd & wrenchList)
+{
+  // Decompose each contact wrench into the ridge forces above the minimum
+  int ridgeNum = 0;
+  int varIdx = 0;
+  for(const auto & contact : solverContactList_)
+  {
+    if(contact->ridgeNum() == 0)
+    {
+      continue;
+    }
+    Eigen::Vector6d minWrench = config_.ridgeForceMinMax.first * contact->graspMat_.rowwise().sum();
+    resultWrenchRatio_.segment(ridgeNum, contact->ridgeNum()) =
+        solveNnls(contact->graspMat_, wrenchList.segment<6>(varIdx) - minWrench).array()
+        + config_.ridgeForceMinMax.first;
+    ridgeNum += contact->ridgeNum();
+    varIdx += 6;
+  }
+}
+
+bool WrenchDistribution::adaptFricPyramids(bool refine)
+{
+  // The result wrench ratio must correspond to the current ridges
+  int totalRidgeNum =
+      std::accumulate(solverContactList_.begin(), solverContactList_.end(), 0,
+                      [](int _ridgeNum, const auto & contact) { return _ridgeNum + contact->ridgeNum(); });
+  if(resultWrenchRatio_.size() != totalRidgeNum)
+  {
+    return false;
+  }
+
+  bool updated = false;
+  int ridgeNum = 0;
+  for(size_t i = 0; i < solverContactList_.size(); i++)
+  {
+    const auto & contact = solverContactList_[i];
+    if(contact->ridgeNum() == 0)
+    {
+      continue;
+    }
+    double fricUsage = contact->calcFricUsage(resultWrenchRatio_.segment(ridgeNum, contact->ridgeNum()));
+    ridgeNum += contact->ridgeNum();
+
+    // The fine pyramid is held by a private copy, and the coarse one is the own pyramid of the contact
+    auto & adaptedContact = adaptedContactList_[i];
+    if(refine && !adaptedContact.contact && fricUsage > config_.adaptiveFricUsageThre.second
+       && contactList_[i]->fricPyramid_->ridgeNum() < config_.adaptiveRidgeNum.second)
+    {
+      adaptedContact = makeAdaptedContact(contactList_[i], config_.adaptiveRidgeNum.second);
+    }
+    else if(!refine && adaptedContact.contact && fricUsage < config_.adaptiveFricUsageThre.first)
+    {
+      adaptedContact = AdaptedContact();
+    }
+    else
+    {
+      continue;
+    }
+    solverContactList_[i] = adaptedContact.contact ? adaptedContact.contact : contactList_[i];
+    updated = true;
+  }
+  return updated;
+}
+
+WrenchDistribution::AdaptedContact WrenchDistribution::makeAdaptedContact(const std::shared_ptr<Contact> & contact,
+                                                                          int ridgeNum) const
+{
+  AdaptedContact adaptedContact;
+  adaptedContact.source = contact;
+  adaptedContact.sourceRevision = contact->localGraspMatRevision();
+  adaptedContact.sourceFricPyramid = contact->fricPyramid_;
+  adaptedContact.contact = contact->clone();
+  adaptedContact.contact->updateFricPyramid(FrictionPyramid::makeShared(contact->fricPyramid_->fricCoeff_, ridgeNum));
+  return adaptedContact;
+}
+
+void WrenchDistribution::updateSolverContactList()
+{
+  adaptedContactList_.resize(contactList_.size());
+  solverContactList_.resize(contactList_.size());
+  for(size_t i = 0; i < contactList_.size(); i++)
+  {
+    const auto & contact = contactList_[i];
+    auto & adaptedContact = adaptedContactList_[i];
+    if(adaptedContact.contact)
+    {
+      if(adaptedContact.source != contact || contact->ridgeNum() == 0
+         || contact->fricPyramid_->ridgeNum() >= adaptedContact.contact->fricPyramid_->ridgeNum())
+      {
+        // The contact is replaced or does not need the fine pyramid
+        adaptedContact = AdaptedContact();
+      }
+      else if(adaptedContact.sourceRevision != contact->localGraspMatRevision()
+              || adaptedContact.sourceFricPyramid != contact->fricPyramid_)
+      {
+        // The local vertices or the friction coefficient of the source are changed
+        adaptedContact = makeAdaptedContact(contact, adaptedContact.contact->fricPyramid_->ridgeNum());
+      }
+      else
+      {
+        auto & adaptedContactPtr = adaptedContact.contact;
+        adaptedContactPtr->maxWrench_ = contact->maxWrench_;
+        if(adaptedContactPtr->pose_.translation() != contact->pose_.translation()
+           || adaptedContactPtr->pose_.rotation() != contact->pose_.rotation())
+        {
+          adaptedContactPtr->updateGlobalVertices(contact->pose_);
+        }
+      }
+    }
+    solverContactList_[i] = adaptedContact.contact ? adaptedContact.contact : contact;
+  }
+}
+
+Eigen::MatrixXd WrenchDistribution::calcWrenchRatioJacobian()
+{
+  if(config_.formulation == Formulation::Cone)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>(
+        "[WrenchDistribution::calcWrenchRatioJacobian] Cone formulation is not supported.");
+  }
+
+  if(resultWrenchRatio_.size() == 0)
+  {
+    return Eigen::MatrixXd::Zero(0, 6);
+  }
+
+  const CriticalRegion & region = lastCriticalRegion();
+  if(config_.formulation == Formulation::Ridge)
+  {
+    return region.gainMat_;
+  }
+  if(config_.formulation == Formulation::Lifted)
+  {
+    return region.gainMat_.topRows(resultWrenchRatio_.size());
+  }
+
+  // In Wrench formulation, the ridge forces above the minimum are obtained from the contact wrench by the least squares
+  Eigen::MatrixXd wrenchRatioJacobian = Eigen::MatrixXd::Zero(resultWrenchRatio_.size(), 6);
+  int ridgeNum = 0;
+  int varIdx = 0;
+  for(const auto & contact : solverContactList_)
+  {
+    if(contact->ridgeNum() == 0)
+    {
+      continue;
+    }
+    std::vector<int> passiveIdxs;
+    for(int i = 0; i < contact->ridgeNum(); i++)
+    {
+      if(resultWrenchRatio_(ridgeNum + i) > config_.ridgeForceMinMax.first + 1e-8)
+      {
+        passiveIdxs.push_back(i);
+      }
+    }
+    if(!passiveIdxs.empty())
+    {
+      Eigen::MatrixXd passiveGraspMat(6, passiveIdxs.size());
+      for(size_t i = 0; i < passiveIdxs.size(); i++)
+      {
+        passiveGraspMat.col(static_cast<Eigen::DenseIndex>(i)) = contact->graspMat_.col(passiveIdxs[i]);
+      }
+      Eigen::MatrixXd passiveJacobian = passiveGraspMat.completeOrthogonalDecomposition().pseudoInverse()
+                                        * region.gainMat_.middleRows<6>(varIdx);
+      for(size_t i = 0; i < passiveIdxs.size(); i++)
+      {
+        wrenchRatioJacobian.row(ridgeNum + passiveIdxs[i]) = passiveJacobian.row(static_cast<Eigen::DenseIndex>(i));
+      }
+    }
+    ridgeNum += contact->ridgeNum();
+    varIdx += 6;
+  }
+  return wrenchRatioJacobian;
+}
+
+std::vector<Eigen::Matrix6d> WrenchDistribution::calcWrenchJacobianList()
+{
+  Eigen::MatrixXd wrenchRatioJacobian = calcWrenchRatioJacobian();
+
+  std::vector<Eigen::Matrix6d> wrenchJacobianList;
+  int ridgeNum = 0;
+  for(const auto & contact : solverContactList_)
+  {
+    if(contact->ridgeNum() == 0)
+    {
+      wrenchJacobianList.push_back(Eigen::Matrix6d::Zero());
+      continue;
+    }
+    wrenchJacobianList.push_back(totalGraspMat_.middleCols(ridgeNum, contact->ridgeNum())
+                                 * wrenchRatioJacobian.middleRows(ridgeNum, contact->ridgeNum()));
+    ridgeNum += contact->ridgeNum();
+  }
+  return wrenchJacobianList;
+}
+
+const CriticalRegion & WrenchDistribution::lastCriticalRegion()
+{
+  if(!lastCriticalRegion_)
+  {
+    lastCriticalRegionRevision_ = ++lastQpRevision;
+    if(criticalRegionHit_)
+    {
+      // The region used in the last run() is moved to the front
+      lastCriticalRegion_ = criticalRegionList_.front();
+    }
+    else
+    {
+      if(!fullQpSetup_)
+      {
+        // The solution of the coarse-to-fine method is used as the initial guess of the active set of the full QP
+        setupRidgeQp();
+        fullQpSetup_ = true;
+        qpCoeffRevision_ = ++lastQpRevision;
+      }
+      lastCriticalRegion_ =
+          CriticalRegion::makeFromSolution(qpCoeff_, objParamMat_, qpSolution_, desiredTotalWrench_.vector());
+    }
+    if(!lastCriticalRegion_)
+    {
+      mc_rtc::log::error_and_throw<std::runtime_error>(
+          "[WrenchDistribution::lastCriticalRegion] Failed to identify the active set of the last run.");
+    }
+  }
+  return *lastCriticalRegion_;
+}
+
+void WrenchDistribution::checkCriticalRegionKey()
+{
+  int keySize = static_cast<int>(totalGraspMat_.size());
+  for(const auto & contact : solverContactList_)
+  {
+    keySize += (contact->maxWrench_ ? 6 : 0);
+  }
+
+  Eigen::VectorXd key(keySize);
+  key.head(totalGraspMat_.size()) = Eigen::Map<const Eigen::VectorXd>(totalGraspMat_.data(), totalGraspMat_.size());
+  int keyIdx = static_cast<int>(totalGraspMat_.size());
+  for(const auto & contact : solverContactList_)
+  {
+    if(contact->maxWrench_)
+    {
+      key.segment<6>(keyIdx) = contact->maxWrench_->vector();
+      keyIdx += 6;
+    }
+  }
+
+  if(key.size() != criticalRegionKey_.size() || key != criticalRegionKey_)
+  {
+    criticalRegionList_.clear();
+    criticalRegionKey_ = key;
+  }
+}
+
+Eigen::VectorXd WrenchDistribution::solveQp()
+{
+  if(!config_.qpExportDir.empty())
+  {
+    std::ostringstream path;
+    path << config_.qpExportDir << "/wrench_distribution_" << std::setw(6) << std::setfill('0') << qpExportCount_
+         << ".qps";
+    writeQps(qpCoeff_, path.str(), "wrench_distribution_" + std::to_string(qpExportCount_));
+    qpExportCount_++;
+  }
+  if(autoQpSolver_)
+  {
+    QpSolverSelector::ShapeKey shapeKey = qpSolverShapeKey();
+    if(shapeKey != qpSolverShapeKey_)
+    {
+      // Keep the current solver for the unseen shape and look it up again in the next solve, as the selection may be
+      // made in the meantime by another instance
+      std::optional<QpSolverCollection::QpSolverType> qpSolverType = qpSolverBenchmarkEnabled_
+                                                                         ? QpSolverSelector::select(shapeKey, qpCoeff_)
+                                                                         : QpSolverSelector::findCached(shapeKey);
+      if(qpSolverType && *qpSolverType != QpSolverCollection::QpSolverType::Any)
+      {
+        qpSolverShapeKey_ = shapeKey;
+        if(*qpSolverType != qpSolver_->type())
+        {
+          // The solver replaced by the user (e.g., qpSolver_ is assigned directly) is also kept
+          qpSolverMap_[qpSolver_->type()] = qpSolver_;
+          auto it = qpSolverMap_.find(*qpSolverType);
+          if(it == qpSolverMap_.end())
+          {
+            it = qpSolverMap_.emplace(*qpSolverType, QpSolverCollection::allocateQpSolver(*qpSolverType)).first;
+          }
+          qpSolver_ = it->second;
+        }
+      }
+    }
+  }
+  return qpSolver_->solve(qpCoeff_);
+}
+
+QpSolverSelector::ShapeKey WrenchDistribution::qpSolverShapeKey() const
+{
+  int varDim = 0;
+  int eqDim = 0;
+  int ineqDim = 0;
+  int wrenchDim = 0;
+  for(const auto & contact : solverContactList_)
+  {
+    int maxWrenchDim = (contact->maxWrench_ ? 12 : 0);
+    if(config_.formulation == Formulation::Ridge)
+    {
+      varDim += contact->ridgeNum();
+      ineqDim += maxWrenchDim;
+      continue;
+    }
+    if(contact->ridgeNum() == 0)
+    {
+      continue;
+    }
+    if(config_.formulation == Formulation::Wrench)
+    {
+      const auto & wrenchCone = contact->wrenchCone();
+      varDim += 6;
+      eqDim += static_cast<int>(wrenchCone.eqMat_.rows());
+      ineqDim += static_cast<int>(wrenchCone.ineqMat_.rows()) + maxWrenchDim;
+    }
+    else if(config_.formulation == Formulation::Cone)
+    {
+      int vertexNum = static_cast<int>(contact->vertexWithRidgeList_.size());
+      varDim += 3 * vertexNum;
+      ineqDim += config_.coneCutNumMax * vertexNum + maxWrenchDim;
+    }
+    else
+    {
+      varDim += contact->ridgeNum() + 6;
+      wrenchDim += 6;
+    }
+  }
+  if(config_.formulation == Formulation::Lifted)
+  {
+    // The total wrench variables and their equality constraints are added
+    varDim += 6;
+    eqDim = wrenchDim + 6;
+  }
+  return {static_cast<int>(config_.formulation), varDim, eqDim, ineqDim};
+}
+
+void WrenchDistribution::precomputeCriticalRegions(const std::vector<sva::ForceVecd> & desiredTotalWrenchList,
+                                                   const Eigen::Vector3d & momentOrigin)
+{
+  for(const auto & desiredTotalWrench : desiredTotalWrenchList)
+  {
+    run(desiredTotalWrench, momentOrigin);
+  }
+}
+
+void WrenchDistribution::warmUpQpSolverSelection(const sva::ForceVecd & desiredTotalWrench,
+                                                 const Eigen::Vector3d & momentOrigin)
+{
+  if(!autoQpSolver_)
+  {
+    return;
+  }
+
+  qpSolverBenchmarkEnabled_ = true;
+  try
+  {
+    run(desiredTotalWrench, momentOrigin);
+  }
+  catch(...)
+  {
+    qpSolverBenchmarkEnabled_ = false;
+    throw;
+  }
+  qpSolverBenchmarkEnabled_ = false;
+}
+
+void WrenchDistribution::addToGUI(mc_rtc::gui::StateBuilder & gui,
+                                  const std::vector<std::string> & category,
+                                  double forceScale,
+                                  double fricPyramidScale)
+{
+  int wrenchRatioIdx = 0;
+
+  for(const auto & contact : solverContactList_)
+  {
+    // The wrench ratio is empty in the Cone formulation
+    if(wrenchRatioIdx + contact->ridgeNum() <= resultWrenchRatio_.size())
+    {
+      contact->addToGUI(gui, category, forceScale, fricPyramidScale,
+                        resultWrenchRatio_.segment(wrenchRatioIdx, contact->ridgeNum()));
+    }
+    else
+    {
+      contact->addToGUI(gui, category, forceScale, fricPyramidScale);
+    }
     wrenchRatioIdx += contact->ridgeNum();
   }
 }
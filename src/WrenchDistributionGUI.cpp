@@ -0,0 +1,201 @@
+#include <mc_rtc/gui/Arrow.h>
+#include <mc_rtc/gui/Point3D.h>
+#include <mc_rtc/gui/Polygon.h>
+#include <mc_rtc/gui/Polyhedron.h>
+
+#include <ForceColl/WrenchDistributionGUI.h>
+
+using namespace ForceColl;
+
+void WrenchDistributionGUI::Configuration::load(const mc_rtc::Configuration & mcRtcConfig)
+{
+  mcRtcConfig("forceScale", forceScale);
+  mcRtcConfig("fricPyramidScale", fricPyramidScale);
+  mcRtcConfig("updateDecimation", updateDecimation);
+}
+
+WrenchDistributionGUI::WrenchDistributionGUI(const std::shared_ptr<const WrenchDistribution> & wrenchDist,
+                                             mc_rtc::gui::StateBuilder & gui,
+                                             const std::vector<std::string> & category,
+                                             const mc_rtc::Configuration & mcRtcConfig)
+: wrenchDist_(wrenchDist), gui_(gui), category_(category)
+{
+  config_.load(mcRtcConfig);
+  registerElements();
+  refresh();
+}
+
+WrenchDistributionGUI::~WrenchDistributionGUI()
+{
+  removeElements();
+}
+
+void WrenchDistributionGUI::update()
+{
+  updateCount_++;
+  if(updateCount_ >= config_.updateDecimation)
+  {
+    refresh();
+  }
+}
+
+void WrenchDistributionGUI::refresh()
+{
+  updateCount_ = 0;
+
+  if(isStructureChanged())
+  {
+    removeElements();
+    registerElements();
+  }
+
+  const Eigen::VectorXd & wrenchRatio = wrenchDist_->resultWrenchRatio_;
+  Eigen::DenseIndex wrenchRatioIdx = 0;
+  for(auto & contactMarker : contactMarkerList_)
+  {
+    const auto & contact = contactMarker.contact;
+    const bool hasWrenchRatio = wrenchRatioIdx + contact->ridgeNum() <= wrenchRatio.size();
+    for(size_t vertexIdx = 0; vertexIdx < contact->vertexWithRidgeList_.size(); vertexIdx++)
+    {
+      const auto & vertexWithRidge = contact->vertexWithRidgeList_[vertexIdx];
+      auto & vertexMarker = contactMarker.vertexMarkerList[vertexIdx];
+
+      Eigen::Vector3d vertexForce = Eigen::Vector3d::Zero();
+      for(size_t ridgeIdx = 0; ridgeIdx < vertexWithRidge.ridgeList.size(); ridgeIdx++)
+      {
+        const auto & ridge = vertexWithRidge.ridgeList[ridgeIdx];
+        if(hasWrenchRatio)
+        {
+          vertexForce += wrenchRatio(wrenchRatioIdx) * ridge;
+        }
+        if(config_.fricPyramidScale > 0)
+        {
+          vertexMarker.fricPyramidVertices[ridgeIdx + 1] = vertexWithRidge.vertex + config_.fricPyramidScale * ridge;
+        }
+        wrenchRatioIdx++;
+      }
+      vertexMarker.arrowStart = vertexWithRidge.vertex;
+      vertexMarker.arrowEnd = vertexWithRidge.vertex + config_.forceScale * vertexForce;
+      if(config_.fricPyramidScale > 0)
+      {
+        vertexMarker.fricPyramidVertices[0] = vertexWithRidge.vertex;
+      }
+      contactMarker.regionVertices[vertexIdx] = vertexWithRidge.vertex;
+    }
+  }
+}
+
+bool WrenchDistributionGUI::isStructureChanged() const
+{
+  if(contactMarkerList_.size() != wrenchDist_->solverContactList().size())
+  {
+    return true;
+  }
+  for(size_t contactIdx = 0; contactIdx < contactMarkerList_.size(); contactIdx++)
+  {
+    const auto & contactMarker = contactMarkerList_[contactIdx];
+    const auto & contact = wrenchDist_->solverContactList()[contactIdx];
+    if(contactMarker.contact != contact || contactMarker.ridgeNum != contact->ridgeNum()
+       || contactMarker.vertexMarkerList.size() != contact->vertexWithRidgeList_.size())
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+void WrenchDistributionGUI::registerElements()
+{
+  contactMarkerList_.resize(wrenchDist_->solverContactList().size());
+  for(size_t contactIdx = 0; contactIdx < contactMarkerList_.size(); contactIdx++)
+  {
+    const auto & contact = wrenchDist_->solverContactList()[contactIdx];
+    auto & contactMarker = contactMarkerList_[contactIdx];
+    contactMarker.contact = contact;
+    contactMarker.ridgeNum = contact->ridgeNum();
+    contactMarker.vertexMarkerList.assign(contact->vertexWithRidgeList_.size(), VertexMarker());
+    contactMarker.regionVertices.assign(contact->vertexWithRidgeList_.size(), Eigen::Vector3d::Zero());
+
+    for(size_t vertexIdx = 0; vertexIdx < contact->vertexWithRidgeList_.size(); vertexIdx++)
+    {
+      auto & vertexMarker = contactMarker.vertexMarkerList[vertexIdx];
+      size_t vertexRidgeNum = contact->vertexWithRidgeList_[vertexIdx].ridgeList.size();
+
+      // Add force arrow
+      if(config_.forceScale > 0)
+      {
+        mc_rtc::gui::ArrowConfig arrowConfig;
+        arrowConfig.color = mc_rtc::gui::Color::Red;
+        arrowConfig.head_diam = 0.020;
+        arrowConfig.head_len = 0.03;
+        arrowConfig.shaft_diam = 0.010;
+        elementNameList_.push_back(contact->name_ + "_Force" + std::to_string(vertexIdx));
+        gui_.addElement(category_,
+                        mc_rtc::gui::Arrow(
+                            elementNameList_.back(), arrowConfig,
+                            [this, contactIdx, vertexIdx]() -> const Eigen::Vector3d & {
+                              return contactMarkerList_[contactIdx].vertexMarkerList[vertexIdx].arrowStart;
+                            },
+                            [this, contactIdx, vertexIdx]() -> const Eigen::Vector3d & {
+                              return contactMarkerList_[contactIdx].vertexMarkerList[vertexIdx].arrowEnd;
+                            }));
+      }
+
+      // Add friction pyramid
+      if(config_.fricPyramidScale > 0)
+      {
+        vertexMarker.fricPyramidVertices.assign(vertexRidgeNum + 1, Eigen::Vector3d::Zero());
+        for(size_t ridgeIdx = 0; ridgeIdx < vertexRidgeNum; ridgeIdx++)
+        {
+          vertexMarker.fricPyramidIndices.push_back({0, ridgeIdx + 1, (ridgeIdx + 1) % vertexRidgeNum + 1});
+        }
+        mc_rtc::gui::PolyhedronConfig polyConfig;
+        polyConfig.show_triangle = false;
+        polyConfig.edge_config.color = mc_rtc::gui::Color(1.0, 0.6, 0.0, 1.0);
+        polyConfig.show_vertices = false;
+        elementNameList_.push_back(contact->name_ + "_FricPyramid" + std::to_string(vertexIdx));
+        gui_.addElement(category_,
+                        mc_rtc::gui::Polyhedron(
+                            elementNameList_.back(), polyConfig,
+                            [this, contactIdx, vertexIdx]() -> const std::vector<Eigen::Vector3d> & {
+                              return contactMarkerList_[contactIdx].vertexMarkerList[vertexIdx].fricPyramidVertices;
+                            },
+                            [this, contactIdx, vertexIdx]() -> const std::vector<std::array<size_t, 3>> & {
+                              return contactMarkerList_[contactIdx].vertexMarkerList[vertexIdx].fricPyramidIndices;
+                            }));
+      }
+    }
+
+    // Add region
+    if(contact->type() == "Surface")
+    {
+      elementNameList_.push_back(contact->name_ + "_SurfaceRegion");
+      gui_.addElement(category_, mc_rtc::gui::Polygon(elementNameList_.back(), {mc_rtc::gui::Color::Blue, 0.02},
+                                                      [this, contactIdx]() -> const std::vector<Eigen::Vector3d> & {
+                                                        return contactMarkerList_[contactIdx].regionVertices;
+                                                      }));
+    }
+    else if(contact->type() == "Grasp")
+    {
+      for(size_t vertexIdx = 0; vertexIdx < contact->vertexWithRidgeList_.size(); vertexIdx++)
+      {
+        elementNameList_.push_back(contact->name_ + "_GraspRegion_" + std::to_string(vertexIdx));
+        gui_.addElement(category_,
+                        mc_rtc::gui::Point3D(elementNameList_.back(), {mc_rtc::gui::Color::Blue, 0.03},
+                                             [this, contactIdx, vertexIdx]() -> const Eigen::Vector3d & {
+                                               return contactMarkerList_[contactIdx].regionVertices[vertexIdx];
+                                             }));
+      }
+    }
+  }
+}
+
+void WrenchDistributionGUI::removeElements()
+{
+  for(const auto & elementName : elementNameList_)
+  {
+    gui_.removeElement(category_, elementName);
+  }
+  elementNameList_.clear();
+  contactMarkerList_.clear();
+}
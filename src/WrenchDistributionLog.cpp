@@ -0,0 +1,377 @@
+#include <mc_rtc/logging.h>
+
+#include <ForceColl/WrenchDistributionLog.h>
+
+#include <cstring>
+
+using namespace ForceColl;
+
+namespace
+{
+constexpr char logMagic[8] = "FCDLOG1";
+constexpr std::uint32_t logVersion = 1;
+constexpr std::uint32_t byteOrderMark = 0x01020304;
+
+/** \brief Type of log record. */
+enum class RecordType : std::uint32_t
+{
+  Setup = 1,
+  Run
+};
+
+/** \brief Type of contact in log. */
+enum class ContactType : std::uint32_t
+{
+  Empty = 0,
+  Surface,
+  Grasp
+};
+
+template<class T>
+void writeValue(std::ofstream & ofs, const T & value)
+{
+  ofs.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+void writeDoubles(std::ofstream & ofs, const double * data, size_t size)
+{
+  ofs.write(reinterpret_cast<const char *>(data), static_cast<std::streamsize>(size * sizeof(double)));
+}
+
+void writeString(std::ofstream & ofs, const std::string & str)
+{
+  writeValue(ofs, static_cast<std::uint64_t>(str.size()));
+  ofs.write(str.data(), static_cast<std::streamsize>(str.size()));
+}
+
+void writePose(std::ofstream & ofs, const sva::PTransformd & pose)
+{
+  Eigen::Matrix3d rot = pose.rotation();
+  Eigen::Vector3d trans = pose.translation();
+  writeDoubles(ofs, rot.data(), 9);
+  writeDoubles(ofs, trans.data(), 3);
+}
+
+template<class T>
+bool readValue(std::ifstream & ifs, T & value)
+{
+  return static_cast<bool>(ifs.read(reinterpret_cast<char *>(&value), sizeof(T)));
+}
+
+bool readDoubles(std::ifstream & ifs, double * data, size_t size)
+{
+  return static_cast<bool>(
+      ifs.read(reinterpret_cast<char *>(data), static_cast<std::streamsize>(size * sizeof(double))));
+}
+
+bool readString(std::ifstream & ifs, std::string & str)
+{
+  std::uint64_t size;
+  if(!readValue(ifs, size))
+  {
+    return false;
+  }
+  str.resize(static_cast<size_t>(size));
+  return static_cast<bool>(ifs.read(str.data(), static_cast<std::streamsize>(size)));
+}
+
+bool readPose(std::ifstream & ifs, sva::PTransformd & pose)
+{
+  Eigen::Matrix3d rot;
+  Eigen::Vector3d trans;
+  if(!readDoubles(ifs, rot.data(), 9) || !readDoubles(ifs, trans.data(), 3))
+  {
+    return false;
+  }
+  pose = sva::PTransformd(rot, trans);
+  return true;
+}
+} // namespace
+
+WrenchDistributionRecorder::WrenchDistributionRecorder(const std::string & path)
+: ofs_(path, std::ios::binary | std::ios::trunc)
+{
+  if(!ofs_)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[WrenchDistributionRecorder] Failed to open file: {}.", path);
+  }
+  ofs_.write(logMagic, sizeof(logMagic));
+  writeValue(ofs_, logVersion);
+  writeValue(ofs_, byteOrderMark);
+}
+
+sva::ForceVecd WrenchDistributionRecorder::runAndRecord(WrenchDistribution & wrenchDist,
+                                                        const sva::ForceVecd & desiredTotalWrench,
+                                                        const Eigen::Vector3d & momentOrigin)
+{
+  auto startTime = std::chrono::steady_clock::now();
+  sva::ForceVecd resultTotalWrench = wrenchDist.run(desiredTotalWrench, momentOrigin);
+  double computationTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+  record(wrenchDist, momentOrigin, computationTime);
+  return resultTotalWrench;
+}
+
+void WrenchDistributionRecorder::record(const WrenchDistribution & wrenchDist,
+                                        const Eigen::Vector3d & momentOrigin,
+                                        double computationTime)
+{
+  if(runNum_ == 0 || isSetupChanged(wrenchDist))
+  {
+    writeSetup(wrenchDist);
+  }
+
+  writeValue(ofs_, RecordType::Run);
+  writeValue(ofs_, static_cast<std::uint64_t>(wrenchDist.contactList_.size()));
+  for(const auto & contact : wrenchDist.contactList_)
+  {
+    writePose(ofs_, contact->pose_);
+  }
+  writeDoubles(ofs_, wrenchDist.desiredTotalWrench_.vector().data(), 6);
+  writeDoubles(ofs_, momentOrigin.data(), 3);
+  writeValue(ofs_, static_cast<std::uint64_t>(wrenchDist.resultWrenchRatio_.size()));
+  writeDoubles(ofs_, wrenchDist.resultWrenchRatio_.data(), static_cast<size_t>(wrenchDist.resultWrenchRatio_.size()));
+  writeValue(ofs_, computationTime);
+  runNum_++;
+}
+
+void WrenchDistributionRecorder::flush()
+{
+  ofs_.flush();
+}
+
+bool WrenchDistributionRecorder::isSetupChanged(const WrenchDistribution & wrenchDist) const
+{
+  if(qpSolverType_ != wrenchDist.qpSolverType() || contactList_.size() != wrenchDist.contactList_.size())
+  {
+    return true;
+  }
+  for(size_t i = 0; i < contactList_.size(); i++)
+  {
+    const auto & contact = wrenchDist.contactList_[i];
+    if(contactList_[i] != contact || localGraspMatList_[i].cols() != contact->localGraspMat_.cols()
+       || localGraspMatList_[i] != contact->localGraspMat_)
+    {
+      return true;
+    }
+    const auto & maxWrench = maxWrenchList_[i];
+    if(maxWrench.has_value() != contact->maxWrench_.has_value()
+       || (maxWrench.has_value() && maxWrench->vector() != contact->maxWrench_->vector()))
+    {
+      return true;
+    }
+  }
+  return false;
+}
+
+void WrenchDistributionRecorder::writeSetup(const WrenchDistribution & wrenchDist)
+{
+  contactList_ = wrenchDist.contactList_;
+  localGraspMatList_.clear();
+  maxWrenchList_.clear();
+  qpSolverType_ = wrenchDist.qpSolverType();
+
+  // The configuration is restored by WrenchDistribution::Configuration::load() and the constructor in replay
+  mc_rtc::Configuration mcRtcConfig;
+  wrenchDist.config().save(mcRtcConfig);
+  mcRtcConfig.add("qpSolverType", std::to_string(qpSolverType_));
+
+  writeValue(ofs_, RecordType::Setup);
+  writeString(ofs_, mcRtcConfig.dump());
+  writeValue(ofs_, static_cast<std::uint64_t>(contactList_.size()));
+  for(const auto & contact : contactList_)
+  {
+    localGraspMatList_.push_back(contact->localGraspMat_);
+    maxWrenchList_.push_back(contact->maxWrench_);
+
+    ContactType type = ContactType::Empty;
+    std::vector<double> vertexData;
+    if(auto surfaceContact = std::dynamic_pointer_cast<SurfaceContact>(contact))
+    {
+      type = ContactType::Surface;
+      for(const auto & vertex : surfaceContact->localVertices_)
+      {
+        vertexData.insert(vertexData.end(), vertex.data(), vertex.data() + 3);
+      }
+    }
+    else if(auto graspContact = std::dynamic_pointer_cast<GraspContact>(contact))
+    {
+      type = ContactType::Grasp;
+      for(const auto & vertex : graspContact->localVertices_)
+      {
+        Eigen::Matrix3d rot = vertex.rotation();
+        vertexData.insert(vertexData.end(), rot.data(), rot.data() + 9);
+        vertexData.insert(vertexData.end(), vertex.translation().data(), vertex.translation().data() + 3);
+      }
+    }
+
+    writeValue(ofs_, type);
+    writeString(ofs_, contact->name_);
+    writeValue(ofs_, contact->fricPyramid_ ? contact->fricPyramid_->fricCoeff_ : 0.0);
+    writeValue(ofs_, static_cast<std::int32_t>(contact->fricPyramid_ ? contact->fricPyramid_->ridgeNum() : 0));
+    writeValue(ofs_, static_cast<std::uint32_t>(contact->maxWrench_.has_value()));
+    sva::ForceVecd maxWrench = contact->maxWrench_.value_or(sva::ForceVecd::Zero());
+    writeDoubles(ofs_, maxWrench.vector().data(), 6);
+    writeValue(ofs_, static_cast<std::uint64_t>(vertexData.size()));
+    writeDoubles(ofs_, vertexData.data(), vertexData.size());
+  }
+}
+
+std::vector<std::shared_ptr<Contact>> WrenchDistributionLogReader::Frame::makeContactList() const
+{
+  std::vector<std::shared_ptr<Contact>> newContactList;
+  for(size_t i = 0; i < contactList->size(); i++)
+  {
+    auto contact = (*contactList)[i]->clone();
+    contact->updateGlobalVertices(poseList[i]);
+    newContactList.push_back(contact);
+  }
+  return newContactList;
+}
+
+WrenchDistributionLogReader::WrenchDistributionLogReader(const std::string & path)
+: path_(path), ifs_(path, std::ios::binary)
+{
+  if(!ifs_)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[WrenchDistributionLogReader] Failed to open file: {}.", path);
+  }
+  char magic[sizeof(logMagic)];
+  std::uint32_t version = 0;
+  std::uint32_t bom = 0;
+  if(!ifs_.read(magic, sizeof(magic)) || std::memcmp(magic, logMagic, sizeof(logMagic)) != 0
+     || !readValue(ifs_, version) || version != logVersion || !readValue(ifs_, bom) || bom != byteOrderMark)
+  {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[WrenchDistributionLogReader] Invalid log header: {}.", path);
+  }
+}
+
+std::optional<WrenchDistributionLogReader::Frame> WrenchDistributionLogReader::next()
+{
+  RecordType recordType;
+  while(readValue(ifs_, recordType))
+  {
+    if(recordType == RecordType::Setup)
+    {
+      readSetup();
+      continue;
+    }
+    else if(recordType != RecordType::Run || !contactList_)
+    {
+      mc_rtc::log::error_and_throw<std::runtime_error>("[WrenchDistributionLogReader] Invalid record: {}.", path_);
+    }
+
+    // A truncated record at the end of log is ignored
+    Frame frame;
+    frame.config = config_;
+    frame.contactList = contactList_;
+    frame.setupIdx = setupNum_ - 1;
+    std::uint64_t contactNum, ratioSize;
+    if(!readValue(ifs_, contactNum) || contactNum != contactList_->size())
+    {
+      return std::nullopt;
+    }
+    frame.poseList.resize(static_cast<size_t>(contactNum));
+    for(auto & pose : frame.poseList)
+    {
+      if(!readPose(ifs_, pose))
+      {
+        return std::nullopt;
+      }
+    }
+    Eigen::Vector6d desiredTotalWrench;
+    if(!readDoubles(ifs_, desiredTotalWrench.data(), 6) || !readDoubles(ifs_, frame.momentOrigin.data(), 3)
+       || !readValue(ifs_, ratioSize))
+    {
+      return std::nullopt;
+    }
+    frame.desiredTotalWrench = sva::ForceVecd(desiredTotalWrench);
+    frame.resultWrenchRatio.resize(static_cast<Eigen::DenseIndex>(ratioSize));
+    if(!readDoubles(ifs_, frame.resultWrenchRatio.data(), static_cast<size_t>(ratioSize))
+       || !readValue(ifs_, frame.computationTime))
+    {
+      return std::nullopt;
+    }
+    return frame;
+  }
+  return std::nullopt;
+}
+
+void WrenchDistributionLogReader::readSetup()
+{
+  auto throwError = [&]() {
+    mc_rtc::log::error_and_throw<std::runtime_error>("[WrenchDistributionLogReader] Invalid setup record: {}.", path_);
+  };
+
+  std::string configStr;
+  std::uint64_t contactNum;
+  if(!readString(ifs_, configStr) || !readValue(ifs_, contactNum))
+  {
+    throwError();
+  }
+  config_ = std::make_shared<mc_rtc::Configuration>(mc_rtc::Configuration::fromYAMLData(configStr));
+
+  auto contactList = std::make_shared<std::vector<std::shared_ptr<Contact>>>();
+  for(std::uint64_t i = 0; i < contactNum; i++)
+  {
+    ContactType type;
+    std::string name;
+    double fricCoeff;
+    std::int32_t ridgeNum;
+    std::uint32_t hasMaxWrench;
+    Eigen::Vector6d maxWrenchVec;
+    std::uint64_t vertexDataSize;
+    if(!readValue(ifs_, type) || !readString(ifs_, name) || !readValue(ifs_, fricCoeff) || !readValue(ifs_, ridgeNum)
+       || !readValue(ifs_, hasMaxWrench) || !readDoubles(ifs_, maxWrenchVec.data(), 6)
+       || !readValue(ifs_, vertexDataSize))
+    {
+      throwError();
+    }
+    std::vector<double> vertexData(static_cast<size_t>(vertexDataSize));
+    if(!readDoubles(ifs_, vertexData.data(), vertexData.size()))
+    {
+      throwError();
+    }
+    std::optional<sva::ForceVecd> maxWrench;
+    if(hasMaxWrench)
+    {
+      maxWrench = sva::ForceVecd(maxWrenchVec);
+    }
+
+    std::shared_ptr<Contact> contact;
+    if(type == ContactType::Empty)
+    {
+      contact = std::make_shared<EmptyContact>(name);
+    }
+    else if(type == ContactType::Surface && vertexData.size() % 3 == 0)
+    {
+      std::vector<Eigen::Vector3d> localVertices;
+      for(size_t j = 0; j < vertexData.size(); j += 3)
+      {
+        localVertices.push_back(Eigen::Map<const Eigen::Vector3d>(vertexData.data() + j));
+      }
+      contact =
+          std::make_shared<SurfaceContact>(name, fricCoeff, localVertices, sva::PTransformd::Identity(), maxWrench);
+    }
+    else if(type == ContactType::Grasp && vertexData.size() % 12 == 0)
+    {
+      std::vector<sva::PTransformd> localVertices;
+      for(size_t j = 0; j < vertexData.size(); j += 12)
+      {
+        localVertices.emplace_back(Eigen::Map<const Eigen::Matrix3d>(vertexData.data() + j),
+                                   Eigen::Map<const Eigen::Vector3d>(vertexData.data() + j + 9));
+      }
+      contact = std::make_shared<GraspContact>(name, fricCoeff, localVertices, sva::PTransformd::Identity(), maxWrench);
+    }
+    else
+    {
+      throwError();
+    }
+    if(contact->fricPyramid_ && contact->fricPyramid_->ridgeNum() != ridgeNum)
+    {
+      contact->updateFricPyramid(FrictionPyramid::makeShared(fricCoeff, ridgeNum));
+    }
+    contactList->push_back(contact);
+  }
+  contactList_ = contactList;
+  setupNum_++;
+}
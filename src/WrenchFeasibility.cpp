@@ -0,0 +1,38 @@
+#include <ForceColl/WrenchFeasibility.h>
+
+using namespace ForceColl;
+
+WrenchFeasibility::WrenchFeasibility(const std::vector<std::shared_ptr<Contact>> & contactList, double ridgeForceMin)
+: contactList_(contactList), ridgeForceMin_(ridgeForceMin)
+{
+  update();
+}
+
+void WrenchFeasibility::update()
+{
+  int ridgeNum = 0;
+  for(const auto & contact : contactList_)
+  {
+    ridgeNum += contact->ridgeNum();
+  }
+
+  Eigen::Matrix<double, 6, Eigen::Dynamic> totalGraspMat(6, ridgeNum);
+  ridgeNum = 0;
+  for(const auto & contact : contactList_)
+  {
+    totalGraspMat.middleCols(ridgeNum, contact->ridgeNum()) = contact->graspMat_;
+    ridgeNum += contact->ridgeNum();
+  }
+
+  totalWrenchCone_ = PolyhedralCone::makeFromSpan(totalGraspMat);
+  minTotalWrench_ = sva::ForceVecd(Eigen::Vector6d(ridgeForceMin_ * totalGraspMat.rowwise().sum()));
+}
+
+double WrenchFeasibility::calcMargin(const sva::ForceVecd & desiredTotalWrench,
+                                     const Eigen::Vector3d & momentOrigin) const
+{
+  // Convert to the wrench around the world origin
+  sva::ForceVecd totalWrench(desiredTotalWrench.moment() + momentOrigin.cross(desiredTotalWrench.force()),
+                             desiredTotalWrench.force());
+  return totalWrenchCone_.calcMargin((totalWrench - minTotalWrench_).vector());
+}
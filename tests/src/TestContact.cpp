@@ -173,6 +173,199 @@ TEST(TestContact, UpdateGraspContactVertices)
       << targetContact->graspMat_ << std::endl;
 }
 
+TEST(TestContact, UpdateLocalVerticesInPlace)
+{
+  sva::PTransformd pose(sva::RotX(M_PI / 2), Eigen::Vector3d(0.0, 0.5, -0.5));
+  {
+    std::vector<Eigen::Vector3d> localVertices = {Eigen::Vector3d(-0.1, -0.1, 0.0), Eigen::Vector3d(-0.1, 0.1, 0.0),
+                                                  Eigen::Vector3d(0.1, 0.0, 0.0)};
+    auto contact = std::make_shared<ForceColl::SurfaceContact>("SurfaceContact", 1.0, localVertices, pose);
+    const double * localGraspMatData = contact->localGraspMat_.data();
+    size_t revision = contact->localGraspMatRevision();
+
+    EXPECT_FALSE(contact->updateLocalVerticesInPlace(localVertices));
+    EXPECT_EQ(contact->localGraspMatRevision(), revision);
+
+    localVertices[1] = Eigen::Vector3d(-0.1, 0.15, 0.01);
+    EXPECT_TRUE(contact->updateLocalVerticesInPlace(localVertices));
+    contact->updateGlobalVertices(pose);
+    EXPECT_NE(contact->localGraspMatRevision(), revision);
+    EXPECT_EQ(contact->localGraspMat_.data(), localGraspMatData);
+
+    auto targetContact = std::make_shared<ForceColl::SurfaceContact>("TargetContact", 1.0, localVertices, pose);
+    EXPECT_LT((contact->localGraspMat_ - targetContact->localGraspMat_).norm(), 1e-10);
+    EXPECT_LT((contact->graspMat_ - targetContact->graspMat_).norm(), 1e-10);
+    EXPECT_LT((contact->vertexWithRidgeList_[1].vertex - targetContact->vertexWithRidgeList_[1].vertex).norm(), 1e-10);
+
+    // Fall back to the reallocation if the number of vertices is changed
+    localVertices.push_back(Eigen::Vector3d(0.1, 0.1, 0.0));
+    EXPECT_TRUE(contact->updateLocalVerticesInPlace(localVertices));
+    EXPECT_EQ(contact->localGraspMat_.cols(), 4 * contact->fricPyramid_->ridgeNum());
+  }
+  {
+    std::vector<sva::PTransformd> localVertices = {
+        sva::PTransformd(sva::RotX(-1 * M_PI / 2), Eigen::Vector3d(-0.1, -0.1, 0.0)),
+        sva::PTransformd(sva::RotX(M_PI / 2), Eigen::Vector3d(-0.1, 0.1, 0.0))};
+    auto contact = std::make_shared<ForceColl::GraspContact>("GraspContact", 1.0, localVertices, pose);
+    size_t revision = contact->localGraspMatRevision();
+
+    localVertices[0] = sva::PTransformd(sva::RotY(0.1), Eigen::Vector3d(0.0, -0.1, 0.0));
+    EXPECT_TRUE(contact->updateLocalVerticesInPlace(localVertices));
+    contact->updateGlobalVertices(pose);
+    EXPECT_NE(contact->localGraspMatRevision(), revision);
+
+    auto targetContact = std::make_shared<ForceColl::GraspContact>("TargetContact", 1.0, localVertices, pose);
+    EXPECT_LT((contact->localGraspMat_ - targetContact->localGraspMat_).norm(), 1e-10);
+    EXPECT_LT((contact->graspMat_ - targetContact->graspMat_).norm(), 1e-10);
+  }
+}
+
+TEST(TestContact, WrenchCone)
+{
+  sva::PTransformd pose(sva::RotY(M_PI / 4) * sva::RotX(M_PI / 2), Eigen::Vector3d(0.0, 0.5, -0.5));
+  std::vector<std::shared_ptr<ForceColl::Contact>> contactList = {
+      std::make_shared<ForceColl::SurfaceContact>(
+          "SurfaceContact", 0.5,
+          std::vector<Eigen::Vector3d>{Eigen::Vector3d(-0.1, -0.1, 0.0), Eigen::Vector3d(-0.1, 0.1, 0.0),
+                                       Eigen::Vector3d(0.1, 0.0, 0.0)},
+          pose),
+      std::make_shared<ForceColl::SurfaceContact>("PointContact", 0.5,
+                                                  std::vector<Eigen::Vector3d>{Eigen::Vector3d::Zero()}, pose),
+      std::make_shared<ForceColl::GraspContact>(
+          "GraspContact", 0.5,
+          std::vector<sva::PTransformd>{sva::PTransformd(Eigen::Vector3d(0.0, 0.0, -0.01)),
+                                        sva::PTransformd(sva::RotX(M_PI), Eigen::Vector3d(0.0, 0.0, 0.01))},
+          pose)};
+
+  for(const auto & contact : contactList)
+  {
+    for(int i = 0; i < 100; i++)
+    {
+      Eigen::VectorXd wrenchRatio = Eigen::VectorXd::Random(contact->ridgeNum()).cwiseAbs();
+      EXPECT_TRUE(contact->localWrenchCone().contains(contact->localGraspMat_ * wrenchRatio))
+          << contact->name_ << ": " << contact->localWrenchCone().calcMargin(contact->localGraspMat_ * wrenchRatio);
+      EXPECT_TRUE(contact->wrenchCone().contains(contact->graspMat_ * wrenchRatio))
+          << contact->name_ << ": " << contact->wrenchCone().calcMargin(contact->graspMat_ * wrenchRatio);
+    }
+
+    // Pulling force is not in the cone
+    sva::ForceVecd pullingWrench = pose.transMul(sva::ForceVecd(Eigen::Vector3d::Zero(), Eigen::Vector3d(0, 0, -1)));
+    if(contact->name_ != "GraspContact")
+    {
+      EXPECT_FALSE(contact->wrenchCone().contains(pullingWrench.vector())) << contact->name_;
+    }
+  }
+}
+
+TEST(TestContact, SupportPolygonVertices)
+{
+  // Square with interior, duplicated, and collinear vertices
+  std::vector<Eigen::Vector3d> localVertices = {
+      Eigen::Vector3d(-0.1, -0.05, 0.0), Eigen::Vector3d(0.0, 0.0, 0.0),    Eigen::Vector3d(0.1, 0.05, 0.0),
+      Eigen::Vector3d(-0.1, 0.05, 0.0),  Eigen::Vector3d(0.0, 0.05, 0.0),   Eigen::Vector3d(0.1, -0.05, 0.0),
+      Eigen::Vector3d(0.1, 0.05, 0.0),   Eigen::Vector3d(0.05, -0.02, 0.0), Eigen::Vector3d(0.1, 0.0, 0.0)};
+  auto supportVertices = ForceColl::calcSupportPolygonVertices(localVertices);
+  EXPECT_EQ(supportVertices.size(), 4);
+
+  auto contact = std::make_shared<ForceColl::SurfaceContact>("Contact", 0.5, localVertices,
+                                                             sva::PTransformd(Eigen::Vector3d(0.1, 0.2, 0.3)));
+  ForceColl::SurfaceContact::verticesMap["Square"] = localVertices;
+  auto prunedContact = std::make_shared<ForceColl::SurfaceContact>(mc_rtc::Configuration::fromYAMLData(R"(
+name: PrunedContact
+fricCoeff: 0.5
+verticesName: Square
+pose:
+  translation: [0.1, 0.2, 0.3]
+vertexPruningTolerance: 0.0
+)"));
+  EXPECT_EQ(prunedContact->ridgeNum(), 4 * contact->fricPyramid_->ridgeNum());
+
+  // The contact wrench cone is unchanged
+  for(Eigen::DenseIndex i = 0; i < contact->graspMat_.cols(); i++)
+  {
+    EXPECT_TRUE(prunedContact->wrenchCone().contains(contact->graspMat_.col(i), 1e-8));
+  }
+
+  // Simplification removes the vertex close to the segment between its neighbors
+  std::vector<Eigen::Vector3d> pentagonVertices = {Eigen::Vector3d(-0.1, -0.05, 0.0), Eigen::Vector3d(0.1, -0.05, 0.0),
+                                                   Eigen::Vector3d(0.1, 0.05, 0.0), Eigen::Vector3d(0.0, 0.051, 0.0),
+                                                   Eigen::Vector3d(-0.1, 0.05, 0.0)};
+  EXPECT_EQ(ForceColl::calcSupportPolygonVertices(pentagonVertices).size(), 5);
+  EXPECT_EQ(ForceColl::calcSupportPolygonVertices(pentagonVertices, 1e-2).size(), 4);
+
+  // Vertices with different z coordinates are pruned separately
+  std::vector<Eigen::Vector3d> twoLevelVertices = {Eigen::Vector3d(0.0, 0.0, 0.0), Eigen::Vector3d(0.0, 0.0, 0.1),
+                                                   Eigen::Vector3d(0.1, 0.0, 0.1), Eigen::Vector3d(0.2, 0.0, 0.1)};
+  EXPECT_EQ(ForceColl::calcSupportPolygonVertices(twoLevelVertices).size(), 3);
+
+  // Vertices in the same plane up to rounding errors are pruned together
+  std::vector<Eigen::Vector3d> noisyVertices = localVertices;
+  for(size_t i = 0; i < noisyVertices.size(); i++)
+  {
+    noisyVertices[i].z() = (i % 2 == 0 ? 1e-12 : -1e-12);
+  }
+  EXPECT_EQ(ForceColl::calcSupportPolygonVertices(noisyVertices).size(), 4);
+}
+
+TEST(TestContact, UpdateFricPyramid)
+{
+  auto contact = std::make_shared<ForceColl::GraspContact>(
+      "Contact", 0.5,
+      std::vector<sva::PTransformd>{sva::PTransformd(Eigen::Vector3d(0.0, 0.0, -0.01)),
+                                    sva::PTransformd(sva::RotX(M_PI), Eigen::Vector3d(0.0, 0.0, 0.01))},
+      sva::PTransformd(sva::RotY(M_PI / 2), Eigen::Vector3d(0.5, 0.5, 1.0)));
+  contact->updateFricPyramid(std::make_shared<ForceColl::FrictionPyramid>(0.5, 6));
+  EXPECT_EQ(contact->ridgeNum(), 12);
+  EXPECT_EQ(contact->localGraspMat_.cols(), 12);
+  EXPECT_EQ(contact->vertexWithRidgeList_[0].ridgeList.size(), 6);
+
+  // Friction usage is zero for normal forces and one on the friction cone
+  Eigen::VectorXd wrenchRatio = Eigen::VectorXd::Zero(12);
+  wrenchRatio.head<6>().setConstant(1.0);
+  EXPECT_LT(contact->calcFricUsage(wrenchRatio), 1e-10);
+  wrenchRatio(7) = 10.0;
+  EXPECT_NEAR(contact->calcFricUsage(wrenchRatio), 1.0, 1e-10);
+}
+
+TEST(TestContact, FrictionPyramidRegistry)
+{
+  auto fricPyramid = ForceColl::FrictionPyramid::makeShared(0.5);
+  EXPECT_EQ(fricPyramid, ForceColl::FrictionPyramid::makeShared(0.5, 4));
+  EXPECT_NE(fricPyramid, ForceColl::FrictionPyramid::makeShared(0.5, 8));
+  EXPECT_NE(fricPyramid, ForceColl::FrictionPyramid::makeShared(0.6, 4));
+  static_assert(std::is_same_v<decltype(fricPyramid), std::shared_ptr<const ForceColl::FrictionPyramid>>,
+                "Interned friction pyramid must be immutable");
+
+  // Pyramid is recreated after the interned one is destroyed
+  {
+    std::weak_ptr<const ForceColl::FrictionPyramid> expiredFricPyramid = ForceColl::FrictionPyramid::makeShared(0.9, 6);
+    EXPECT_TRUE(expiredFricPyramid.expired());
+    auto recreatedFricPyramid = ForceColl::FrictionPyramid::makeShared(0.9, 6);
+    EXPECT_EQ(recreatedFricPyramid->fricCoeff_, 0.9);
+    EXPECT_EQ(recreatedFricPyramid->ridgeNum(), 6);
+  }
+
+  auto contact1 = std::make_shared<ForceColl::SurfaceContact>(
+      "Contact1", 0.5, std::vector<Eigen::Vector3d>{Eigen::Vector3d::Zero()}, sva::PTransformd::Identity());
+  auto contact2 = std::make_shared<ForceColl::SurfaceContact>(
+      "Contact2", 0.5, std::vector<Eigen::Vector3d>{Eigen::Vector3d::Zero()}, sva::PTransformd::Identity());
+  EXPECT_EQ(contact1->fricPyramid_, fricPyramid);
+  EXPECT_EQ(contact2->fricPyramid_, fricPyramid);
+
+  // Ridges from the unit circle tables are same as those from trigonometric functions
+  for(int ridgeNum : {3, 4, 5, 6, 8, 12, 16})
+  {
+    auto tableFricPyramid = ForceColl::FrictionPyramid::makeShared(0.7, ridgeNum);
+    ASSERT_EQ(tableFricPyramid->ridgeNum(), ridgeNum);
+    for(int i = 0; i < ridgeNum; i++)
+    {
+      double theta = 2 * M_PI * i / ridgeNum;
+      Eigen::Vector3d ridge = Eigen::Vector3d(0.7 * std::cos(theta), 0.7 * std::sin(theta), 1).normalized();
+      EXPECT_LT((tableFricPyramid->localRidgeList_[i] - ridge).norm(), 1e-15);
+    }
+  }
+}
+
 int main(int argc, char ** argv)
 {
   testing::InitGoogleTest(&argc, argv);
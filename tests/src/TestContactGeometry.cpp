@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include <ForceColl/ContactGeometry.h>
+
+namespace
+{
+std::vector<std::shared_ptr<ForceColl::Contact>> makeContactList()
+{
+  return {std::make_shared<ForceColl::SurfaceContact>(
+              "Surface", 0.5,
+              std::vector<Eigen::Vector3d>{Eigen::Vector3d(-0.1, -0.05, 0.0), Eigen::Vector3d(-0.1, 0.05, 0.0),
+                                           Eigen::Vector3d(0.1, -0.05, 0.0), Eigen::Vector3d(0.1, 0.05, 0.0)},
+              sva::PTransformd(sva::RotX(0.2), Eigen::Vector3d(0.0, 0.1, 0.0))),
+          std::make_shared<ForceColl::GraspContact>(
+              "Grasp", 0.8,
+              std::vector<sva::PTransformd>{sva::PTransformd(sva::RotY(0.3), Eigen::Vector3d(0.0, 0.02, 0.0)),
+                                            sva::PTransformd(sva::RotZ(-0.4), Eigen::Vector3d(0.0, -0.02, 0.0))},
+              sva::PTransformd(sva::RotZ(1.0), Eigen::Vector3d(0.3, -0.2, 1.0)))};
+}
+} // namespace
+
+TEST(TestContactGeometry, GraspMat)
+{
+  auto contactList = makeContactList();
+
+  // The grasp matrix of contact is consistent with the global vertices and ridges
+  for(const auto & contact : contactList)
+  {
+    Eigen::DenseIndex colIdx = 0;
+    for(const auto & vertexWithRidge : contact->vertexWithRidgeList_)
+    {
+      for(const auto & ridge : vertexWithRidge.ridgeList)
+      {
+        Eigen::Vector6d col;
+        col << vertexWithRidge.vertex.cross(ridge), ridge;
+        EXPECT_LT((contact->graspMat_.col(colIdx) - col).norm(), 1e-10);
+        colIdx++;
+      }
+    }
+    EXPECT_EQ(colIdx, contact->ridgeNum());
+  }
+
+  ForceColl::ContactGeometry<> contactGeom(contactList);
+  EXPECT_EQ(contactGeom.contactNum(), contactList.size());
+  EXPECT_EQ(contactGeom.ridgeNum(), contactList[0]->ridgeNum() + contactList[1]->ridgeNum());
+  EXPECT_LT((contactGeom.graspMat_.leftCols(contactList[0]->ridgeNum()) - contactList[0]->graspMat_).norm(), 1e-10);
+  EXPECT_LT((contactGeom.graspMat_.rightCols(contactList[1]->ridgeNum()) - contactList[1]->graspMat_).norm(), 1e-10);
+
+  EXPECT_THROW(contactGeom.updateGlobalVertices({sva::PTransformd::Identity()}), std::runtime_error);
+}
+
+TEST(TestContactGeometry, Float)
+{
+  auto contactList = makeContactList();
+  ForceColl::ContactGeometry<float> contactGeom(contactList);
+
+  std::vector<sva::PTransformd> poseList = {sva::PTransformd(sva::RotY(-0.3), Eigen::Vector3d(0.5, 0.2, 0.1)),
+                                            sva::PTransformd(sva::RotX(0.7), Eigen::Vector3d(-0.4, 0.3, 1.2))};
+  std::vector<sva::PTransform<float>> poseListFloat;
+  for(size_t i = 0; i < contactList.size(); i++)
+  {
+    contactList[i]->updateGlobalVertices(poseList[i]);
+    poseListFloat.push_back(poseList[i].cast<float>());
+  }
+  contactGeom.updateGlobalVertices(poseListFloat);
+
+  Eigen::VectorXd wrenchRatio = Eigen::VectorXd::LinSpaced(contactGeom.ridgeNum(), 1.0, 100.0);
+  Eigen::Vector3d momentOrigin(0.1, -0.2, 0.5);
+  sva::ForceVecd totalWrench = ForceColl::calcTotalWrench(contactList, wrenchRatio, momentOrigin);
+  Eigen::Matrix<float, 6, 1> totalWrenchFloat =
+      contactGeom.calcTotalWrench(wrenchRatio.cast<float>(), momentOrigin.cast<float>());
+  EXPECT_LT((totalWrenchFloat.cast<double>() - totalWrench.vector()).norm(), 1e-5 * totalWrench.vector().norm());
+
+  auto wrenchList = ForceColl::calcWrenchList(contactList, wrenchRatio, momentOrigin);
+  auto wrenchListFloat = contactGeom.calcWrenchList(wrenchRatio.cast<float>(), momentOrigin.cast<float>());
+  ASSERT_EQ(wrenchListFloat.size(), wrenchList.size());
+  for(size_t i = 0; i < wrenchList.size(); i++)
+  {
+    EXPECT_LT((wrenchListFloat[i].cast<double>() - wrenchList[i].vector()).norm(),
+              1e-5 * wrenchList[i].vector().norm());
+  }
+
+  // The moment origin can be shifted in the grasp matrix
+  Eigen::Matrix<float, 6, Eigen::Dynamic> shiftedGraspMat = contactGeom.graspMat_;
+  ForceColl::ContactGeometry<float>::shiftMomentOrigin(shiftedGraspMat, momentOrigin.cast<float>());
+  EXPECT_LT(((shiftedGraspMat * wrenchRatio.cast<float>()).cast<double>() - totalWrench.vector()).norm(),
+            1e-5 * totalWrench.vector().norm());
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+
+#include <ForceColl/ContactLibrary.h>
+
+#include <cstdio>
+#include <fstream>
+
+namespace
+{
+const std::string libraryYamlStr = R"(
+surfaceVerticesMap:
+  - name: verticesSquare
+    vertices:
+      - [-0.1, -0.1, 0]
+      - [0.1, -0.1, 0]
+      - [0.1, 0.1, 0]
+      - [-0.1, 0.1, 0]
+      - [0.0, 0.0, 0]
+  - name: verticesPoint
+    vertices:
+      - [0, 0, 0]
+graspVerticesMap:
+  - name: verticesGrasp
+    vertices:
+      - translation: [0.0, 0.1, 0.0]
+        rotation: [1.5707963267948966, 0, 0]
+      - translation: [0.0, -0.1, 0.0]
+        rotation: [-1.5707963267948966, 0, 0]
+contactList:
+  - type: Empty
+    name: ContactEmpty
+  - type: Surface
+    name: ContactSurface
+    fricCoeff: 0.5
+    verticesName: verticesSquare
+    vertexPruningTolerance: 0.0
+    pose:
+      translation: [1.0, 2.0, 3.0]
+      rotation: [0.1, 0.2, 0.3]
+  - type: Grasp
+    name: ContactGrasp
+    fricCoeff: 0.8
+    verticesName: verticesGrasp
+    pose:
+      translation: [0.0, 0.5, 1.0]
+      rotation: [0.0, 0.0, 1.0]
+    maxWrench:
+      couple: [10, 20, 30]
+      force: [100, 200, 300]
+)";
+} // namespace
+
+TEST(TestContactLibrary, ConvertAndLoad)
+{
+  auto libraryConfig = mc_rtc::Configuration::fromYAMLData(libraryYamlStr);
+  const std::string path = "/tmp/TestContactLibrary.bin";
+  ForceColl::ContactLibrary::convertFromConfig(libraryConfig, path);
+  ForceColl::ContactLibrary contactLibrary(path);
+
+  ASSERT_EQ(contactLibrary.surfaceVerticesNum(), 2);
+  ASSERT_EQ(contactLibrary.graspVerticesNum(), 1);
+  ASSERT_EQ(contactLibrary.contactNum(), 3);
+
+  // Vertices are sorted by name and can be found by binary search
+  EXPECT_EQ(contactLibrary.surfaceVerticesName(0), "verticesPoint");
+  EXPECT_EQ(contactLibrary.surfaceVerticesName(1), "verticesSquare");
+  EXPECT_EQ(contactLibrary.findSurfaceVertices("verticesSquare"), 1);
+  EXPECT_EQ(contactLibrary.findSurfaceVertices("verticesUnknown"), -1);
+  EXPECT_EQ(contactLibrary.findGraspVertices("verticesGrasp"), 0);
+  auto squareVertices = contactLibrary.surfaceVertices(1);
+  ASSERT_EQ(squareVertices.cols(), 5);
+  EXPECT_LT((squareVertices.col(2) - Eigen::Vector3d(0.1, 0.1, 0)).norm(), 1e-12);
+
+  // Contacts are same as those from the configuration
+  ForceColl::SurfaceContact::loadVerticesMap(libraryConfig("surfaceVerticesMap"));
+  ForceColl::GraspContact::loadVerticesMap(libraryConfig("graspVerticesMap"));
+  auto contactList = contactLibrary.makeSharedContactList();
+  size_t contactIdx = 0;
+  for(const auto & contactConfig : libraryConfig("contactList"))
+  {
+    auto contactFromConfig = ForceColl::Contact::makeSharedFromConfig(contactConfig);
+    const auto & contact = contactList[contactIdx];
+    EXPECT_EQ(contact->type(), contactFromConfig->type());
+    EXPECT_EQ(contact->name_, contactFromConfig->name_);
+    EXPECT_EQ(std::string(contactLibrary.contactName(contactIdx)), contactFromConfig->name_);
+    ASSERT_EQ(contact->graspMat_.cols(), contactFromConfig->graspMat_.cols());
+    EXPECT_LT((contact->graspMat_ - contactFromConfig->graspMat_).norm(), 1e-10);
+    EXPECT_TRUE(contact->maxWrench_ == contactFromConfig->maxWrench_);
+    contactIdx++;
+  }
+
+  // The interior vertex is pruned
+  EXPECT_EQ(std::dynamic_pointer_cast<ForceColl::SurfaceContact>(contactList[1])->localVertices_.size(), 4);
+
+  ForceColl::SurfaceContact::verticesMap.clear();
+  contactLibrary.loadVerticesMaps();
+  EXPECT_EQ(ForceColl::SurfaceContact::verticesMap.at("verticesSquare").size(), 5);
+  EXPECT_EQ(ForceColl::GraspContact::verticesMap.at("verticesGrasp").size(), 2);
+
+  std::remove(path.c_str());
+}
+
+TEST(TestContactLibrary, InvalidFile)
+{
+  const std::string path = "/tmp/TestContactLibraryInvalid.bin";
+  {
+    std::ofstream ofs(path, std::ios::binary);
+    ofs << std::string(256, 'x');
+  }
+  EXPECT_THROW(ForceColl::ContactLibrary contactLibrary(path), std::runtime_error);
+  EXPECT_THROW(ForceColl::ContactLibrary contactLibrary("/tmp/TestContactLibraryNotExist.bin"), std::runtime_error);
+
+  auto libraryConfig = mc_rtc::Configuration::fromYAMLData(R"(
+contactList:
+  - type: Surface
+    name: ContactSurface
+    fricCoeff: 0.5
+    verticesName: verticesUnknown
+    pose:
+      translation: [0, 0, 0]
+      rotation: [0, 0, 0]
+)");
+  EXPECT_THROW(ForceColl::ContactLibrary::convertFromConfig(libraryConfig, path), std::runtime_error);
+
+  std::remove(path.c_str());
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include <ForceColl/ContactSet.h>
+#include <ForceColl/WrenchDistribution.h>
+
+TEST(TestContactSet, UpdateAndEvaluate)
+{
+  std::vector<std::shared_ptr<ForceColl::Contact>> contactList = {
+      std::make_shared<ForceColl::SurfaceContact>(
+          "Surface", 0.5,
+          std::vector<Eigen::Vector3d>{Eigen::Vector3d(-0.1, -0.05, 0.0), Eigen::Vector3d(-0.1, 0.05, 0.0),
+                                       Eigen::Vector3d(0.1, -0.05, 0.0), Eigen::Vector3d(0.1, 0.05, 0.0)},
+          sva::PTransformd(Eigen::Vector3d(0.0, 0.1, 0.0))),
+      std::make_shared<ForceColl::EmptyContact>(std::string("Empty")),
+      std::make_shared<ForceColl::GraspContact>(
+          "Grasp", 0.8,
+          std::vector<sva::PTransformd>{sva::PTransformd(sva::RotY(0.3), Eigen::Vector3d(0.0, 0.02, 0.0)),
+                                        sva::PTransformd(sva::RotZ(-0.4), Eigen::Vector3d(0.0, -0.02, 0.0))},
+          sva::PTransformd(Eigen::Vector3d(0.3, -0.2, 1.0)))};
+
+  ForceColl::ContactSet contactSet(contactList);
+  ASSERT_EQ(contactSet.size(), contactList.size());
+  EXPECT_EQ(contactSet.type(0), ForceColl::ContactSet::Type::Surface);
+  EXPECT_EQ(contactSet.type(1), ForceColl::ContactSet::Type::Empty);
+  EXPECT_EQ(contactSet.type(2), ForceColl::ContactSet::Type::Grasp);
+  EXPECT_EQ(contactSet.contact(2).name_, "Grasp");
+
+  // Update the copies in the set and the original contacts with the same poses
+  std::vector<sva::PTransformd> poseList = {sva::PTransformd(sva::RotX(0.2), Eigen::Vector3d(0.5, 0.2, 0.1)),
+                                            sva::PTransformd::Identity(),
+                                            sva::PTransformd(sva::RotZ(1.0), Eigen::Vector3d(-0.4, 0.3, 1.2))};
+  contactSet.updateGlobalVertices(poseList);
+  for(size_t i = 0; i < contactList.size(); i++)
+  {
+    contactList[i]->updateGlobalVertices(poseList[i]);
+    EXPECT_LT((contactSet.contact(i).graspMat_ - contactList[i]->graspMat_).norm(), 1e-12);
+  }
+  EXPECT_THROW(contactSet.updateGlobalVertices({}), std::runtime_error);
+
+  int ridgeNum = contactSet.ridgeNum();
+  EXPECT_EQ(ridgeNum, contactList[0]->ridgeNum() + contactList[2]->ridgeNum());
+  Eigen::VectorXd wrenchRatio = Eigen::VectorXd::LinSpaced(ridgeNum, 1.0, 50.0);
+  Eigen::Vector3d momentOrigin(0.1, -0.2, 0.5);
+  sva::ForceVecd totalWrench = ForceColl::calcTotalWrench(contactList, wrenchRatio, momentOrigin);
+  EXPECT_LT((contactSet.calcTotalWrench(wrenchRatio, momentOrigin) - totalWrench).vector().norm(), 1e-10);
+  EXPECT_LT((contactSet.calcTotalGraspMat(momentOrigin) * wrenchRatio - totalWrench.vector()).norm(), 1e-10);
+  auto wrenchList = ForceColl::calcWrenchList(contactList, wrenchRatio, momentOrigin);
+  auto setWrenchList = contactSet.calcWrenchList(wrenchRatio, momentOrigin);
+  ASSERT_EQ(setWrenchList.size(), wrenchList.size());
+  for(size_t i = 0; i < wrenchList.size(); i++)
+  {
+    EXPECT_LT((setWrenchList[i] - wrenchList[i]).vector().norm(), 1e-10);
+  }
+}
+
+TEST(TestContactSet, SharedPointerFacade)
+{
+  std::vector<ForceColl::ContactVariant> contactVariantList;
+  contactVariantList.emplace_back(ForceColl::SurfaceContact(
+      "Surface", 0.5,
+      std::vector<Eigen::Vector3d>{Eigen::Vector3d(-0.1, -0.1, 0.0), Eigen::Vector3d(-0.1, 0.1, 0.0),
+                                   Eigen::Vector3d(0.1, -0.1, 0.0), Eigen::Vector3d(0.1, 0.1, 0.0)},
+      sva::PTransformd::Identity()));
+  auto contactSet = std::make_shared<ForceColl::ContactSet>(std::move(contactVariantList));
+
+  // The pointers refer to the contacts in the set and keep them alive
+  auto contactPtrList = contactSet->contactPtrList();
+  EXPECT_EQ(contactPtrList[0].get(), &contactSet->contact(0));
+  contactSet.reset();
+  auto wrenchDist = std::make_shared<ForceColl::WrenchDistribution>(contactPtrList);
+  sva::ForceVecd desiredTotalWrench(Eigen::Vector3d::Zero(), Eigen::Vector3d(0.0, 0.0, 100.0));
+  sva::ForceVecd resultTotalWrench = wrenchDist->run(desiredTotalWrench);
+  EXPECT_LT((resultTotalWrench - desiredTotalWrench).vector().norm(), 1e-3);
+}
+
+TEST(TestContactSet, Copy)
+{
+  std::vector<ForceColl::ContactVariant> contactVariantList;
+  contactVariantList.emplace_back(ForceColl::SurfaceContact(
+      "Surface", 0.5,
+      std::vector<Eigen::Vector3d>{Eigen::Vector3d(-0.1, -0.1, 0.0), Eigen::Vector3d(-0.1, 0.1, 0.0),
+                                   Eigen::Vector3d(0.1, -0.1, 0.0), Eigen::Vector3d(0.1, 0.1, 0.0)},
+      sva::PTransformd::Identity()));
+  ForceColl::ContactSet contactSet(std::move(contactVariantList));
+  Eigen::Matrix<double, 6, Eigen::Dynamic> graspMat = contactSet.contact(0).graspMat_;
+  std::vector<sva::PTransformd> poseList = {sva::PTransformd(sva::RotZ(0.5), Eigen::Vector3d(1.0, 0.0, 0.0))};
+
+  // Mutating the copy does not affect the original
+  ForceColl::ContactSet copiedContactSet(contactSet);
+  EXPECT_NE(copiedContactSet.contactPtrList()[0].get(), contactSet.contactPtrList()[0].get());
+  EXPECT_EQ(copiedContactSet.contactPtrList()[0].get(), &copiedContactSet.contact(0));
+  copiedContactSet.updateGlobalVertices(poseList);
+  EXPECT_GT((copiedContactSet.contact(0).graspMat_ - graspMat).norm(), 1e-3);
+  EXPECT_LT((contactSet.contact(0).graspMat_ - graspMat).norm(), 1e-12);
+
+  // Same for the copy assignment
+  ForceColl::ContactSet assignedContactSet(std::vector<ForceColl::ContactVariant>{});
+  assignedContactSet = contactSet;
+  ASSERT_EQ(assignedContactSet.size(), 1);
+  EXPECT_EQ(assignedContactSet.contactPtrList()[0].get(), &assignedContactSet.contact(0));
+  assignedContactSet.updateGlobalVertices(poseList);
+  EXPECT_LT((assignedContactSet.contact(0).graspMat_ - copiedContactSet.contact(0).graspMat_).norm(), 1e-12);
+  EXPECT_LT((contactSet.contact(0).graspMat_ - graspMat).norm(), 1e-12);
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,53 @@
+#include <gtest/gtest.h>
+
+#include <ForceColl/CriticalRegion.h>
+
+TEST(TestCriticalRegion, BoxConstrainedQp)
+{
+  // min 1/2 |x|^2 - theta^T x s.t. 0 <= x <= 1, whose solution is clamp(theta, 0, 1)
+  QpSolverCollection::QpCoeff qpCoeff;
+  qpCoeff.setup(2, 0, 0);
+  qpCoeff.obj_mat_.setIdentity();
+  qpCoeff.x_min_.setZero();
+  qpCoeff.x_max_.setOnes();
+  Eigen::MatrixXd objParamMat = -1 * Eigen::MatrixXd::Identity(2, 2);
+  auto clamp = [](const Eigen::Vector2d & param) -> Eigen::VectorXd { return param.cwiseMax(0.0).cwiseMin(1.0); };
+
+  {
+    Eigen::Vector2d param(0.5, 0.2);
+    auto region = ForceColl::CriticalRegion::makeFromSolution(qpCoeff, objParamMat, clamp(param), param);
+    ASSERT_TRUE(region);
+    EXPECT_TRUE(region->activeIdxs_.empty());
+    EXPECT_TRUE(region->contains(Eigen::Vector2d(0.9, 0.1)));
+    EXPECT_FALSE(region->contains(Eigen::Vector2d(1.1, 0.1)));
+    EXPECT_FALSE(region->contains(Eigen::Vector2d(0.5, -0.1)));
+    Eigen::Vector2d otherParam(0.3, 0.7);
+    EXPECT_LT((region->calcSolution(otherParam) - clamp(otherParam)).norm(), 1e-10);
+  }
+
+  {
+    Eigen::Vector2d param(2.0, -1.0);
+    auto region = ForceColl::CriticalRegion::makeFromSolution(qpCoeff, objParamMat, clamp(param), param);
+    ASSERT_TRUE(region);
+    EXPECT_EQ(region->activeIdxs_.size(), 2);
+    EXPECT_TRUE(region->contains(Eigen::Vector2d(1.5, -3.0)));
+    EXPECT_FALSE(region->contains(Eigen::Vector2d(0.5, -1.0)));
+    Eigen::Vector2d otherParam(3.0, -0.5);
+    EXPECT_LT((region->calcSolution(otherParam) - clamp(otherParam)).norm(), 1e-10);
+  }
+
+  // Inaccurate solution with wrong active set is corrected
+  {
+    Eigen::Vector2d param(0.5, 0.2);
+    auto region = ForceColl::CriticalRegion::makeFromSolution(qpCoeff, objParamMat, Eigen::Vector2d(1.0, 0.0), param);
+    ASSERT_TRUE(region);
+    EXPECT_TRUE(region->activeIdxs_.empty());
+    EXPECT_LT((region->calcSolution(param) - clamp(param)).norm(), 1e-10);
+  }
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,78 @@
+#include <gtest/gtest.h>
+
+#include <ForceColl/MultiBodyWrenchDistribution.h>
+
+namespace
+{
+std::vector<std::shared_ptr<ForceColl::Contact>> makeContactList(const Eigen::Vector3d & pos)
+{
+  std::vector<std::shared_ptr<ForceColl::Contact>> contactList;
+  for(double y : {-0.1, 0.1})
+  {
+    contactList.push_back(std::make_shared<ForceColl::SurfaceContact>(
+        "Foot" + std::to_string(contactList.size()), 0.5,
+        std::vector<Eigen::Vector3d>{Eigen::Vector3d(-0.1, -0.05, 0.0), Eigen::Vector3d(-0.1, 0.05, 0.0),
+                                     Eigen::Vector3d(0.1, -0.05, 0.0), Eigen::Vector3d(0.1, 0.05, 0.0)},
+        sva::PTransformd(Eigen::Vector3d(pos + Eigen::Vector3d(0.0, y, 0.0)))));
+  }
+  return contactList;
+}
+} // namespace
+
+TEST(TestMultiBodyWrenchDistribution, CompareWithSingleBody)
+{
+  std::vector<Eigen::Vector3d> posList = {Eigen::Vector3d(0.0, 0.0, 0.0), Eigen::Vector3d(1.0, 0.0, 0.0),
+                                          Eigen::Vector3d(0.0, 2.0, 0.5)};
+  std::vector<std::vector<std::shared_ptr<ForceColl::Contact>>> contactListList;
+  for(const auto & pos : posList)
+  {
+    contactListList.push_back(makeContactList(pos));
+  }
+  ForceColl::MultiBodyWrenchDistribution multiBodyWrenchDist(contactListList,
+                                                             mc_rtc::Configuration::fromYAMLData("threadNum: 2"));
+  ASSERT_EQ(multiBodyWrenchDist.bodyNum(), posList.size());
+
+  std::vector<sva::ForceVecd> desiredTotalWrenchList;
+  for(size_t i = 0; i < posList.size(); i++)
+  {
+    desiredTotalWrenchList.push_back(
+        sva::ForceVecd(Eigen::Vector3d(0.0, 10.0 * i, 0.0), Eigen::Vector3d(5.0 * i, 0.0, 500.0 + 100.0 * i)));
+  }
+  const auto & result = multiBodyWrenchDist.run(desiredTotalWrenchList, posList);
+
+  for(size_t i = 0; i < posList.size(); i++)
+  {
+    ForceColl::WrenchDistribution wrenchDist(contactListList[i]);
+    sva::ForceVecd resultTotalWrench = wrenchDist.run(desiredTotalWrenchList[i], posList[i]);
+    EXPECT_LT((result.resultTotalWrenchList[i] - resultTotalWrench).vector().norm(), 1e-6);
+    EXPECT_LT((result.resultWrenchRatioList[i] - wrenchDist.resultWrenchRatio_).norm(), 1e-6);
+    ASSERT_EQ(result.resultWrenchListList[i].size(), contactListList[i].size());
+    sva::ForceVecd totalWrench = sva::ForceVecd::Zero();
+    for(const auto & wrench : result.resultWrenchListList[i])
+    {
+      totalWrench += wrench;
+    }
+    EXPECT_LT((totalWrench - resultTotalWrench).vector().norm(), 1e-6);
+  }
+
+  // The worker threads are reused in the repeated runs and recreated if the number of threads is changed
+  std::vector<sva::ForceVecd> resultTotalWrenchList = result.resultTotalWrenchList;
+  for(int threadNum : {2, 2, 3, 1})
+  {
+    multiBodyWrenchDist.threadNum_ = threadNum;
+    multiBodyWrenchDist.run(desiredTotalWrenchList, posList);
+    for(size_t i = 0; i < posList.size(); i++)
+    {
+      EXPECT_LT((multiBodyWrenchDist.result().resultTotalWrenchList[i] - resultTotalWrenchList[i]).vector().norm(),
+                1e-6);
+    }
+  }
+
+  EXPECT_THROW(multiBodyWrenchDist.run({sva::ForceVecd::Zero()}), std::runtime_error);
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
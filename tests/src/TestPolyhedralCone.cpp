@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include <Eigen/Dense>
+
+#include <ForceColl/Contact.h>
+#include <ForceColl/PolyhedralCone.h>
+
+/** \brief Check that the cone contains the nonnegative combinations of the generators and nothing else. */
+void checkConeMembership(const ForceColl::PolyhedralCone & cone, const Eigen::MatrixXd & spanMat)
+{
+  for(int i = 0; i < 1000; i++)
+  {
+    Eigen::VectorXd ratio = Eigen::VectorXd::Random(spanMat.cols()).cwiseAbs();
+    EXPECT_TRUE(cone.contains(spanMat * ratio)) << "margin: " << cone.calcMargin(spanMat * ratio);
+  }
+  for(int i = 0; i < spanMat.cols(); i++)
+  {
+    EXPECT_TRUE(cone.contains(spanMat.col(i)));
+  }
+}
+
+TEST(TestPolyhedralCone, Pyramid)
+{
+  Eigen::MatrixXd spanMat(3, 4);
+  spanMat << 1, 0, -1, 0, 0, 1, 0, -1, 1, 1, 1, 1;
+  auto cone = ForceColl::PolyhedralCone::makeFromSpan(spanMat);
+
+  EXPECT_EQ(cone.ineqMat_.rows(), 4);
+  EXPECT_EQ(cone.eqMat_.rows(), 0);
+  checkConeMembership(cone, spanMat);
+  EXPECT_FALSE(cone.contains(Eigen::Vector3d(0, 0, -1)));
+  EXPECT_FALSE(cone.contains(Eigen::Vector3d(2, 0, 1)));
+  EXPECT_NEAR(cone.calcMargin(Eigen::Vector3d(0, 0, 1)), 1.0 / std::sqrt(3.0), 1e-10);
+}
+
+TEST(TestPolyhedralCone, HalfSpace)
+{
+  Eigen::MatrixXd spanMat(2, 3);
+  spanMat << 1, -1, 0, 0, 0, 1;
+  auto cone = ForceColl::PolyhedralCone::makeFromSpan(spanMat);
+
+  EXPECT_EQ(cone.ineqMat_.rows(), 1);
+  EXPECT_EQ(cone.eqMat_.rows(), 0);
+  checkConeMembership(cone, spanMat);
+  EXPECT_TRUE(cone.contains(Eigen::Vector2d(-100, 1)));
+  EXPECT_FALSE(cone.contains(Eigen::Vector2d(0, -1)));
+}
+
+TEST(TestPolyhedralCone, LowerDimension)
+{
+  Eigen::MatrixXd spanMat(3, 2);
+  spanMat << 1, 0, 0, 1, 0, 0;
+  auto cone = ForceColl::PolyhedralCone::makeFromSpan(spanMat);
+
+  EXPECT_EQ(cone.ineqMat_.rows(), 2);
+  EXPECT_EQ(cone.eqMat_.rows(), 1);
+  checkConeMembership(cone, spanMat);
+  EXPECT_FALSE(cone.contains(Eigen::Vector3d(1, 1, 1)));
+  EXPECT_FALSE(cone.contains(Eigen::Vector3d(-1, 1, 0)));
+
+  auto emptyCone = ForceColl::PolyhedralCone::makeFromSpan(Eigen::MatrixXd::Zero(3, 0));
+  EXPECT_EQ(emptyCone.ineqMat_.rows(), 0);
+  EXPECT_EQ(emptyCone.eqMat_.rows(), 3);
+  EXPECT_TRUE(emptyCone.contains(Eigen::Vector3d::Zero()));
+  EXPECT_FALSE(emptyCone.contains(Eigen::Vector3d::UnitX()));
+}
+
+TEST(TestPolyhedralCone, SurfaceWrenchCone)
+{
+  double fricCoeff = 0.5;
+  auto contact = std::make_shared<ForceColl::SurfaceContact>(
+      "SurfaceContact", fricCoeff,
+      std::vector<Eigen::Vector3d>{Eigen::Vector3d(-0.1, -0.05, 0.0), Eigen::Vector3d(-0.1, 0.05, 0.0),
+                                   Eigen::Vector3d(0.1, 0.05, 0.0), Eigen::Vector3d(0.1, -0.05, 0.0)},
+      sva::PTransformd::Identity());
+  const auto & cone = contact->localWrenchCone();
+
+  EXPECT_EQ(cone.eqMat_.rows(), 0);
+  checkConeMembership(cone, contact->localGraspMat_);
+
+  // Each face is supported by five linearly independent generators
+  for(int i = 0; i < cone.ineqMat_.rows(); i++)
+  {
+    Eigen::VectorXd faceValues = contact->localGraspMat_.transpose() * cone.ineqMat_.row(i).transpose();
+    std::vector<Eigen::VectorXd> supportList;
+    for(int j = 0; j < faceValues.size(); j++)
+    {
+      if(std::abs(faceValues(j)) < 1e-8)
+      {
+        supportList.push_back(contact->localGraspMat_.col(j));
+      }
+    }
+    Eigen::MatrixXd supportMat(6, supportList.size());
+    for(size_t j = 0; j < supportList.size(); j++)
+    {
+      supportMat.col(static_cast<Eigen::DenseIndex>(j)) = supportList[j];
+    }
+    EXPECT_EQ(supportMat.fullPivLu().rank(), 5);
+  }
+
+  // Center of pressure outside of the surface
+  EXPECT_FALSE(cone.contains(sva::ForceVecd(Eigen::Vector3d(0.2, 0, 0), Eigen::Vector3d(0, 0, 1)).vector()));
+  // Tangential force outside of the friction pyramid
+  EXPECT_FALSE(cone.contains(sva::ForceVecd(Eigen::Vector3d::Zero(), Eigen::Vector3d(1, 0, 1)).vector()));
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,77 @@
+#include <gtest/gtest.h>
+
+#include <ForceColl/QpFile.h>
+#include <ForceColl/WrenchDistribution.h>
+
+#include <cstdio>
+#include <filesystem>
+
+TEST(TestQpFile, WriteAndRead)
+{
+  QpSolverCollection::QpCoeff qpCoeff;
+  qpCoeff.setup(3, 1, 2);
+  qpCoeff.obj_mat_ << 2.0, 0.5, 0.0, 0.5, 1.0, 0.0, 0.0, 0.0, 1e-8;
+  qpCoeff.obj_vec_ << -1.0, 0.0, 0.1234567890123456789;
+  qpCoeff.eq_mat_ << 1.0, 1.0, 1.0;
+  qpCoeff.eq_vec_ << 1.0;
+  qpCoeff.ineq_mat_ << 1.0, -1.0, 0.0, 0.0, 0.0, 1.0;
+  qpCoeff.ineq_vec_ << 0.5, 0.0;
+  qpCoeff.x_min_ << 0.0, -1e30, -1.0;
+  qpCoeff.x_max_ << 1e30, 2.0, 1.0;
+
+  const std::string path = "/tmp/TestQpFile.qps";
+  ForceColl::writeQps(qpCoeff, path);
+  QpSolverCollection::QpCoeff readQpCoeff = ForceColl::readQps(path);
+
+  ASSERT_EQ(readQpCoeff.dim_var_, qpCoeff.dim_var_);
+  ASSERT_EQ(readQpCoeff.dim_eq_, qpCoeff.dim_eq_);
+  ASSERT_EQ(readQpCoeff.dim_ineq_, qpCoeff.dim_ineq_);
+  EXPECT_EQ(readQpCoeff.obj_mat_, qpCoeff.obj_mat_);
+  EXPECT_EQ(readQpCoeff.obj_vec_, qpCoeff.obj_vec_);
+  EXPECT_EQ(readQpCoeff.eq_mat_, qpCoeff.eq_mat_);
+  EXPECT_EQ(readQpCoeff.eq_vec_, qpCoeff.eq_vec_);
+  EXPECT_EQ(readQpCoeff.ineq_mat_, qpCoeff.ineq_mat_);
+  EXPECT_EQ(readQpCoeff.ineq_vec_, qpCoeff.ineq_vec_);
+  EXPECT_EQ(readQpCoeff.x_min_(0), 0.0);
+  EXPECT_LE(readQpCoeff.x_min_(1), -1e20);
+  EXPECT_EQ(readQpCoeff.x_min_(2), -1.0);
+  EXPECT_GE(readQpCoeff.x_max_(0), 1e20);
+  EXPECT_EQ(readQpCoeff.x_max_(1), 2.0);
+
+  std::remove(path.c_str());
+}
+
+TEST(TestQpFile, ExportFromWrenchDistribution)
+{
+  auto contact = std::make_shared<ForceColl::SurfaceContact>(
+      "Contact", 0.5,
+      std::vector<Eigen::Vector3d>{Eigen::Vector3d(-0.1, -0.1, 0.0), Eigen::Vector3d(-0.1, 0.1, 0.0),
+                                   Eigen::Vector3d(0.1, 0.0, 0.0)},
+      sva::PTransformd::Identity());
+
+  const std::filesystem::path exportDir = "/tmp/TestQpFileExport";
+  std::filesystem::remove_all(exportDir);
+  std::filesystem::create_directories(exportDir);
+  auto wrenchDist = std::make_shared<ForceColl::WrenchDistribution>(
+      std::vector<std::shared_ptr<ForceColl::Contact>>{contact},
+      mc_rtc::Configuration::fromYAMLData("qpExportDir: " + exportDir.string()));
+  wrenchDist->run(sva::ForceVecd(Eigen::Vector3d::Zero(), Eigen::Vector3d(0, 0, 100)));
+  wrenchDist->run(sva::ForceVecd(Eigen::Vector3d::Zero(), Eigen::Vector3d(0, 0, 200)));
+
+  // The exported QP gives the same solution
+  std::string path = (exportDir / "wrench_distribution_000001.qps").string();
+  ASSERT_TRUE(std::filesystem::exists(path));
+  QpSolverCollection::QpCoeff qpCoeff = ForceColl::readQps(path);
+  EXPECT_EQ(qpCoeff.dim_var_, contact->ridgeNum());
+  auto qpSolver = QpSolverCollection::allocateQpSolver(QpSolverCollection::QpSolverType::Any);
+  Eigen::VectorXd solution = qpSolver->solve(qpCoeff);
+  EXPECT_LT((solution - wrenchDist->resultWrenchRatio_).norm(), 1e-6);
+
+  std::filesystem::remove_all(exportDir);
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,111 @@
+#include <gtest/gtest.h>
+
+#include <ForceColl/QpSolverSelector.h>
+#include <ForceColl/WrenchDistribution.h>
+
+#include <algorithm>
+
+TEST(TestQpSolverSelector, Select)
+{
+  ForceColl::QpSolverSelector::clearCache();
+
+  QpSolverCollection::QpCoeff qpCoeff;
+  qpCoeff.setup(2, 0, 1);
+  qpCoeff.obj_mat_.setIdentity();
+  qpCoeff.obj_vec_ << -1.0, -1.0;
+  qpCoeff.ineq_mat_ << 1.0, 1.0;
+  qpCoeff.ineq_vec_ << 1.0;
+  qpCoeff.x_min_.setZero();
+  qpCoeff.x_max_.setConstant(10.0);
+
+  auto shapeKey = ForceColl::QpSolverSelector::makeShapeKey(0, qpCoeff);
+  QpSolverCollection::QpSolverType qpSolverType = ForceColl::QpSolverSelector::select(shapeKey, qpCoeff);
+  auto qpSolverTypeList = ForceColl::QpSolverSelector::availableQpSolverTypes();
+  ASSERT_FALSE(qpSolverTypeList.empty());
+  EXPECT_NE(std::find(qpSolverTypeList.begin(), qpSolverTypeList.end(), qpSolverType), qpSolverTypeList.end());
+
+  // The selected solver is accurate
+  auto qpSolver = QpSolverCollection::allocateQpSolver(qpSolverType);
+  Eigen::VectorXd x = qpSolver->solve(qpCoeff);
+  EXPECT_LT((x - Eigen::Vector2d(0.5, 0.5)).norm(), 1e-4);
+  EXPECT_LE(ForceColl::QpSolverSelector::calcViolation(qpCoeff, x), ForceColl::QpSolverSelector::violationThre);
+
+  // The selection is cached per shape
+  QpSolverCollection::QpCoeff otherQpCoeff = qpCoeff;
+  otherQpCoeff.obj_vec_ << 1.0, 1.0;
+  EXPECT_EQ(ForceColl::QpSolverSelector::select(shapeKey, otherQpCoeff), qpSolverType);
+
+  // The failure of all solvers is not cached
+  QpSolverCollection::QpCoeff infeasibleQpCoeff;
+  infeasibleQpCoeff.setup(2, 0, 0);
+  infeasibleQpCoeff.obj_mat_.setIdentity();
+  infeasibleQpCoeff.obj_vec_.setZero();
+  infeasibleQpCoeff.x_min_.setConstant(1.0);
+  infeasibleQpCoeff.x_max_.setConstant(-1.0);
+  auto infeasibleShapeKey = ForceColl::QpSolverSelector::makeShapeKey(1, infeasibleQpCoeff);
+  EXPECT_EQ(ForceColl::QpSolverSelector::select(infeasibleShapeKey, infeasibleQpCoeff),
+            QpSolverCollection::QpSolverType::Any);
+  EXPECT_FALSE(ForceColl::QpSolverSelector::findCached(infeasibleShapeKey));
+}
+
+TEST(TestQpSolverSelector, WrenchDistribution)
+{
+  auto contact = std::make_shared<ForceColl::SurfaceContact>(
+      "Contact", 0.5,
+      std::vector<Eigen::Vector3d>{Eigen::Vector3d(-0.1, -0.1, 0.0), Eigen::Vector3d(-0.1, 0.1, 0.0),
+                                   Eigen::Vector3d(0.1, -0.1, 0.0), Eigen::Vector3d(0.1, 0.1, 0.0)},
+      sva::PTransformd::Identity());
+  std::vector<std::shared_ptr<ForceColl::Contact>> contactList = {contact};
+
+  auto wrenchDistAny = std::make_shared<ForceColl::WrenchDistribution>(contactList);
+  auto wrenchDistAuto = std::make_shared<ForceColl::WrenchDistribution>(
+      contactList, mc_rtc::Configuration::fromYAMLData("qpSolverType: Auto"));
+
+  sva::ForceVecd desiredTotalWrench(Eigen::Vector3d(1.0, -2.0, 0.0), Eigen::Vector3d(10.0, 0.0, 500.0));
+  wrenchDistAny->run(desiredTotalWrench);
+
+  // run() does not benchmark the unseen QP shape
+  ForceColl::QpSolverSelector::clearCache();
+  wrenchDistAuto->run(desiredTotalWrench);
+  EXPECT_LT((wrenchDistAuto->resultTotalWrench_ - wrenchDistAny->resultTotalWrench_).vector().norm(), 1e-3);
+  EXPECT_EQ(wrenchDistAuto->qpSolverType(), wrenchDistAny->qpSolverType());
+  auto shapeKey = wrenchDistAuto->qpSolverShapeKey();
+  EXPECT_EQ(shapeKey, ForceColl::QpSolverSelector::makeShapeKey(static_cast<int>(wrenchDistAuto->config().formulation),
+                                                                 wrenchDistAuto->qpCoeff_));
+  EXPECT_FALSE(ForceColl::QpSolverSelector::findCached(shapeKey));
+
+  // The selection is made in warm-up
+  wrenchDistAuto->warmUpQpSolverSelection(desiredTotalWrench);
+  EXPECT_LT((wrenchDistAuto->resultTotalWrench_ - wrenchDistAny->resultTotalWrench_).vector().norm(), 1e-3);
+  ASSERT_TRUE(ForceColl::QpSolverSelector::findCached(shapeKey));
+  EXPECT_EQ(wrenchDistAuto->qpSolverType(), *ForceColl::QpSolverSelector::findCached(shapeKey));
+
+  // The selection made by another instance is used by run()
+  auto otherWrenchDistAuto = std::make_shared<ForceColl::WrenchDistribution>(
+      contactList, mc_rtc::Configuration::fromYAMLData("qpSolverType: Auto"));
+  otherWrenchDistAuto->run(desiredTotalWrench);
+  EXPECT_EQ(otherWrenchDistAuto->qpSolverType(), wrenchDistAuto->qpSolverType());
+  EXPECT_LT((otherWrenchDistAuto->resultTotalWrench_ - wrenchDistAny->resultTotalWrench_).vector().norm(), 1e-3);
+
+  // The shape is made from the full problem, so it is not changed by the cutting planes of the Cone formulation
+  auto coneWrenchDistAuto = std::make_shared<ForceColl::WrenchDistribution>(
+      contactList, mc_rtc::Configuration::fromYAMLData("{qpSolverType: Auto, formulation: Cone}"));
+  auto coneShapeKey = coneWrenchDistAuto->qpSolverShapeKey();
+  EXPECT_EQ(coneShapeKey[1], 3 * 4);
+  EXPECT_EQ(coneShapeKey[3], coneWrenchDistAuto->config().coneCutNumMax * 4);
+  sva::ForceVecd diagonalTotalWrench(Eigen::Vector3d::Zero(), Eigen::Vector3d(130.0, 130.0, 500.0));
+  coneWrenchDistAuto->warmUpQpSolverSelection(diagonalTotalWrench);
+  int coneTag = static_cast<int>(coneWrenchDistAuto->config().formulation);
+  EXPECT_NE(coneShapeKey, ForceColl::QpSolverSelector::makeShapeKey(coneTag, coneWrenchDistAuto->qpCoeff_));
+  ASSERT_TRUE(ForceColl::QpSolverSelector::findCached(coneShapeKey));
+  EXPECT_EQ(coneWrenchDistAuto->qpSolverType(), *ForceColl::QpSolverSelector::findCached(coneShapeKey));
+  coneWrenchDistAuto->run(diagonalTotalWrench);
+  EXPECT_EQ(coneWrenchDistAuto->qpSolverShapeKey(), coneShapeKey);
+  EXPECT_EQ(coneWrenchDistAuto->qpSolverType(), *ForceColl::QpSolverSelector::findCached(coneShapeKey));
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
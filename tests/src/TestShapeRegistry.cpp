@@ -0,0 +1,108 @@
+#include <gtest/gtest.h>
+
+#include <ForceColl/ShapeRegistry.h>
+
+#include <thread>
+
+TEST(TestShapeRegistry, MakeContact)
+{
+  const std::string surfaceVerticesYamlStr = R"(
+- name: verticesSquare
+  vertices:
+    - [-0.1, -0.1, 0]
+    - [0.1, -0.1, 0]
+    - [0.1, 0.1, 0]
+    - [-0.1, 0.1, 0]
+)";
+  const std::string graspVerticesYamlStr = R"(
+- name: verticesGrasp
+  vertices:
+    - translation: [0.0, -0.05, 0.0]
+      rotation: [-1.5707963267948966, 0, 0]
+    - translation: [0.0, 0.05, 0.0]
+      rotation: [1.5707963267948966, 0, 0]
+)";
+
+  auto registry = ForceColl::ShapeRegistry::Builder()
+                      .loadSurfaceVerticesMap(mc_rtc::Configuration::fromYAMLData(surfaceVerticesYamlStr))
+                      .loadGraspVerticesMap(mc_rtc::Configuration::fromYAMLData(graspVerticesYamlStr))
+                      .addFricCoeff(0.5)
+                      .addFricCoeff(0.8, 8)
+                      .build();
+  EXPECT_TRUE(registry->hasSurfaceVertices("verticesSquare"));
+  EXPECT_FALSE(registry->hasSurfaceVertices("verticesGrasp"));
+  EXPECT_TRUE(registry->hasGraspVertices("verticesGrasp"));
+
+  sva::PTransformd pose(sva::RotZ(0.5) * sva::RotX(0.2), Eigen::Vector3d(0.1, 0.2, 0.3));
+  std::optional<sva::ForceVecd> maxWrench = sva::ForceVecd(Eigen::Vector3d(10, 20, 30), Eigen::Vector3d(1, 2, 3));
+
+  // Contacts from shapes are same as those from vertices
+  {
+    auto shape = registry->surfaceShape("verticesSquare", 0.5);
+    auto contactShape = std::make_shared<ForceColl::SurfaceContact>("ContactShape", shape, pose, maxWrench);
+    auto contactDirect =
+        std::make_shared<ForceColl::SurfaceContact>("ContactDirect", 0.5, shape->localVertices, pose, maxWrench);
+    EXPECT_EQ(contactShape->fricPyramid_, contactDirect->fricPyramid_);
+    EXPECT_LT((contactShape->localGraspMat_ - contactDirect->localGraspMat_).norm(), 1e-12);
+    EXPECT_LT((contactShape->graspMat_ - contactDirect->graspMat_).norm(), 1e-12);
+    EXPECT_EQ(contactShape->vertexWithRidgeList_.size(), contactDirect->vertexWithRidgeList_.size());
+    EXPECT_TRUE(contactShape->maxWrench_ == contactDirect->maxWrench_);
+  }
+  {
+    auto shape = registry->graspShape("verticesGrasp", 0.8, 8);
+    auto contactShape = std::make_shared<ForceColl::GraspContact>("ContactShape", shape, pose);
+    auto contactDirect = std::make_shared<ForceColl::GraspContact>("ContactDirect", 0.8, shape->localVertices, pose);
+    contactDirect->updateFricPyramid(ForceColl::FrictionPyramid::makeShared(0.8, 8));
+    EXPECT_EQ(contactShape->ridgeNum(), 2 * 8);
+    EXPECT_LT((contactShape->localGraspMat_ - contactDirect->localGraspMat_).norm(), 1e-12);
+    EXPECT_LT((contactShape->graspMat_ - contactDirect->graspMat_).norm(), 1e-12);
+  }
+
+  EXPECT_THROW(registry->surfaceShape("verticesUnknown", 0.5), std::runtime_error);
+  EXPECT_THROW(registry->surfaceShape("verticesSquare", 0.5, 8), std::runtime_error);
+
+  // Friction coefficient is matched within tolerance
+  EXPECT_EQ(registry->surfaceShape("verticesSquare", 0.7 - 0.2), registry->surfaceShape("verticesSquare", 0.5));
+  EXPECT_EQ(registry->surfaceShape("verticesSquare", 0.5 + 0.1 * ForceColl::ShapeRegistry::fricCoeffTolerance),
+            registry->surfaceShape("verticesSquare", 0.5));
+  EXPECT_THROW(registry->surfaceShape("verticesSquare", 0.5 + 10 * ForceColl::ShapeRegistry::fricCoeffTolerance),
+               std::runtime_error);
+}
+
+TEST(TestShapeRegistry, ConcurrentConstruction)
+{
+  auto registry = ForceColl::ShapeRegistry::Builder()
+                      .addSurfaceVertices("verticesTriangle", {Eigen::Vector3d(0.1, 0, 0), Eigen::Vector3d(0, 0.1, 0),
+                                                               Eigen::Vector3d(-0.1, -0.1, 0)})
+                      .addFricCoeff(0.6)
+                      .build();
+  auto shape = registry->surfaceShape("verticesTriangle", 0.6);
+
+  std::vector<Eigen::MatrixXd> graspMatList(4);
+  std::vector<std::thread> threadList;
+  for(size_t i = 0; i < graspMatList.size(); i++)
+  {
+    threadList.emplace_back([&, i]() {
+      for(int j = 0; j < 100; j++)
+      {
+        auto contact = std::make_shared<ForceColl::SurfaceContact>(
+            "Contact", registry->surfaceShape("verticesTriangle", 0.6), sva::PTransformd::Identity());
+        graspMatList[i] = contact->graspMat_;
+      }
+    });
+  }
+  for(auto & thread : threadList)
+  {
+    thread.join();
+  }
+  for(const auto & graspMat : graspMatList)
+  {
+    EXPECT_LT((graspMat - shape->localGraspMat).norm(), 1e-12);
+  }
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
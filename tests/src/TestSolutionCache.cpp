@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include <ForceColl/SolutionCache.h>
+#include <ForceColl/WrenchDistribution.h>
+
+TEST(TestSolutionCache, LeastRecentlyUsed)
+{
+  ForceColl::SolutionCache cache(2);
+  cache.insert({1, 2}, Eigen::VectorXd::Constant(1, 1.0));
+  cache.insert({3}, Eigen::VectorXd::Constant(1, 3.0));
+  ASSERT_NE(cache.find({1, 2}), nullptr);
+  EXPECT_EQ((*cache.find({1, 2}))(0), 1.0);
+
+  // {3} is evicted because {1, 2} is used more recently
+  cache.insert({4}, Eigen::VectorXd::Constant(1, 4.0));
+  EXPECT_EQ(cache.size(), 2);
+  EXPECT_EQ(cache.find({3}), nullptr);
+  EXPECT_NE(cache.find({4}), nullptr);
+  EXPECT_NE(cache.find({1, 2}), nullptr);
+  EXPECT_EQ(cache.hitNum(), 4);
+  EXPECT_EQ(cache.missNum(), 1);
+  EXPECT_DOUBLE_EQ(cache.hitRate(), 0.8);
+
+  // Overwrite
+  cache.insert({4}, Eigen::VectorXd::Constant(1, 5.0));
+  EXPECT_EQ((*cache.find({4}))(0), 5.0);
+
+  cache.clear();
+  cache.resetStats();
+  EXPECT_EQ(cache.size(), 0);
+  EXPECT_EQ(cache.find({4}), nullptr);
+  EXPECT_DOUBLE_EQ(cache.hitRate(), 0.0);
+
+  // Nothing is cached with zero capacity
+  ForceColl::SolutionCache emptyCache;
+  emptyCache.insert({1}, Eigen::VectorXd::Zero(1));
+  EXPECT_EQ(emptyCache.size(), 0);
+}
+
+TEST(TestSolutionCache, WrenchDistribution)
+{
+  auto contact = std::make_shared<ForceColl::SurfaceContact>(
+      "Contact", 0.5,
+      std::vector<Eigen::Vector3d>{Eigen::Vector3d(-0.1, -0.1, 0.0), Eigen::Vector3d(-0.1, 0.1, 0.0),
+                                   Eigen::Vector3d(0.1, -0.1, 0.0), Eigen::Vector3d(0.1, 0.1, 0.0)},
+      sva::PTransformd::Identity());
+  std::vector<std::shared_ptr<ForceColl::Contact>> contactList = {contact};
+  auto wrenchDist = std::make_shared<ForceColl::WrenchDistribution>(
+      contactList, mc_rtc::Configuration::fromYAMLData("{solutionCacheSize: 2, solutionCacheWrenchResolution: 1.0}"));
+
+  sva::ForceVecd desiredTotalWrench(Eigen::Vector3d(0.0, 1.0, 0.0), Eigen::Vector3d(10.0, 0.0, 500.0));
+  sva::ForceVecd resultTotalWrench = wrenchDist->run(desiredTotalWrench);
+  Eigen::VectorXd wrenchRatio = wrenchDist->resultWrenchRatio_;
+  EXPECT_FALSE(wrenchDist->solutionCacheHit_);
+
+  // The close desired wrench hits the cache
+  wrenchDist->run(desiredTotalWrench + sva::ForceVecd(Eigen::Vector3d::Zero(), Eigen::Vector3d(0.0, 0.0, 0.1)));
+  EXPECT_TRUE(wrenchDist->solutionCacheHit_);
+  EXPECT_EQ(wrenchDist->resultWrenchRatio_, wrenchRatio);
+  EXPECT_LT((wrenchDist->resultTotalWrench_ - resultTotalWrench).vector().norm(), 1e-10);
+
+  // The moved contact misses the cache
+  contact->updateGlobalVertices(sva::PTransformd(Eigen::Vector3d(0.0, 0.0, 0.1)));
+  wrenchDist->run(desiredTotalWrench);
+  EXPECT_FALSE(wrenchDist->solutionCacheHit_);
+  EXPECT_EQ(wrenchDist->solutionCache().size(), 2);
+  EXPECT_DOUBLE_EQ(wrenchDist->solutionCache().hitRate(), 1.0 / 3.0);
+
+  wrenchDist->clearSolutionCache();
+  wrenchDist->run(desiredTotalWrench);
+  EXPECT_FALSE(wrenchDist->solutionCacheHit_);
+  wrenchDist->run(desiredTotalWrench);
+  EXPECT_TRUE(wrenchDist->solutionCacheHit_);
+
+  // The changed local vertices miss the cache
+  contact->updateLocalVertices({Eigen::Vector3d(-0.05, -0.05, 0.0), Eigen::Vector3d(-0.05, 0.05, 0.0),
+                                Eigen::Vector3d(0.05, -0.05, 0.0), Eigen::Vector3d(0.05, 0.05, 0.0)});
+  contact->updateGlobalVertices(contact->pose_);
+  wrenchDist->run(desiredTotalWrench);
+  EXPECT_FALSE(wrenchDist->solutionCacheHit_);
+  EXPECT_NE(wrenchDist->resultWrenchRatio_, wrenchRatio);
+  wrenchDist->run(desiredTotalWrench);
+  EXPECT_TRUE(wrenchDist->solutionCacheHit_);
+
+  // The changed maximum wrench misses the cache
+  contact->maxWrench_ = sva::ForceVecd(Eigen::Vector3d::Constant(100.0), Eigen::Vector3d::Constant(1000.0));
+  wrenchDist->run(desiredTotalWrench);
+  EXPECT_FALSE(wrenchDist->solutionCacheHit_);
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
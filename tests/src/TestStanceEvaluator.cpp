@@ -0,0 +1,124 @@
+#include <gtest/gtest.h>
+
+#include <ForceColl/StanceEvaluator.h>
+
+#include <stdexcept>
+
+namespace
+{
+/** \brief Contact throwing an exception when it is placed far from the origin. */
+class ThrowingContact : public ForceColl::EmptyContact
+{
+public:
+  ThrowingContact() : ForceColl::EmptyContact(std::string("ThrowingContact")) {}
+
+  std::shared_ptr<ForceColl::Contact> clone() const override
+  {
+    return std::make_shared<ThrowingContact>(*this);
+  }
+
+  void updateGlobalVertices(const sva::PTransformd & pose) override
+  {
+    if(pose.translation().norm() > 100.0)
+    {
+      throw std::runtime_error("Contact pose is out of range");
+    }
+    ForceColl::EmptyContact::updateGlobalVertices(pose);
+  }
+};
+} // namespace
+
+TEST(TestStanceEvaluator, CompareWithWrenchDistribution)
+{
+  double fricCoeff = 0.5;
+  std::vector<Eigen::Vector3d> footVertices = {Eigen::Vector3d(-0.1, -0.05, 0.0), Eigen::Vector3d(-0.1, 0.05, 0.0),
+                                               Eigen::Vector3d(0.1, 0.05, 0.0), Eigen::Vector3d(0.1, -0.05, 0.0)};
+  auto leftFootContact = std::make_shared<ForceColl::SurfaceContact>("LeftFootContact", fricCoeff, footVertices,
+                                                                     sva::PTransformd::Identity());
+  auto rightFootContact = std::make_shared<ForceColl::SurfaceContact>("RightFootContact", fricCoeff, footVertices,
+                                                                      sva::PTransformd::Identity());
+  auto leftHandContact = std::make_shared<ForceColl::EmptyContact>(std::string("LeftHandContact"));
+  std::vector<std::shared_ptr<ForceColl::Contact>> contactList = {leftFootContact, rightFootContact, leftHandContact};
+  Eigen::MatrixXd originalGraspMat = leftFootContact->graspMat_;
+
+  std::vector<std::vector<sva::PTransformd>> poseSetList;
+  for(int i = 0; i < 20; i++)
+  {
+    Eigen::Vector3d leftFootPos = Eigen::Vector3d::Random() * 0.3 + Eigen::Vector3d(0, 0.1, 0);
+    Eigen::Vector3d rightFootPos = Eigen::Vector3d::Random() * 0.3 + Eigen::Vector3d(0, -0.1, 0);
+    poseSetList.push_back({sva::PTransformd(sva::RotZ(0.1 * i), leftFootPos),
+                           sva::PTransformd(sva::RotX(0.05 * i), rightFootPos), sva::PTransformd::Identity()});
+  }
+
+  sva::ForceVecd desiredTotalWrench = sva::ForceVecd(Eigen::Vector3d(10.0, 0.0, 0.0), Eigen::Vector3d(0.0, 0.0, 500.0));
+  Eigen::Vector3d momentOrigin(0.0, 0.0, 0.8);
+  ForceColl::StanceEvaluator stanceEval(contactList, mc_rtc::Configuration::fromYAMLData("threadNum: 4"));
+  auto resultList = stanceEval.run(poseSetList, desiredTotalWrench, momentOrigin);
+
+  ASSERT_EQ(resultList.size(), poseSetList.size());
+  EXPECT_LT((leftFootContact->graspMat_ - originalGraspMat).norm(), 1e-10);
+
+  auto wrenchDist = std::make_shared<ForceColl::WrenchDistribution>(contactList);
+  int feasibleNum = 0;
+  for(size_t i = 0; i < poseSetList.size(); i++)
+  {
+    for(size_t j = 0; j < contactList.size(); j++)
+    {
+      contactList[j]->updateGlobalVertices(poseSetList[i][j]);
+    }
+    sva::ForceVecd resultTotalWrench = wrenchDist->run(desiredTotalWrench, momentOrigin);
+    EXPECT_LT((resultTotalWrench - resultList[i].resultTotalWrench).vector().norm(), 1e-6);
+    EXPECT_LT((wrenchDist->resultWrenchRatio_ - resultList[i].wrenchRatio).norm(), 1e-6);
+    EXPECT_EQ(resultList[i].feasible, (resultTotalWrench - desiredTotalWrench).vector().norm() < 1e-2);
+    if(resultList[i].feasible)
+    {
+      feasibleNum++;
+    }
+  }
+  EXPECT_GT(feasibleNum, 0);
+
+  // The copies of the contacts are reused in the next run and made again after the contacts are changed
+  auto repeatedResultList = stanceEval.run(poseSetList, desiredTotalWrench, momentOrigin);
+  for(size_t i = 0; i < poseSetList.size(); i++)
+  {
+    EXPECT_LT((repeatedResultList[i].resultTotalWrench - resultList[i].resultTotalWrench).vector().norm(), 1e-6);
+  }
+  stanceEval.contactList_[1] = std::make_shared<ForceColl::SurfaceContact>(
+      "RightFootContact", fricCoeff, std::vector<Eigen::Vector3d>(footVertices.begin(), footVertices.begin() + 3),
+      sva::PTransformd::Identity());
+  auto changedResultList = stanceEval.run(poseSetList, desiredTotalWrench, momentOrigin);
+  EXPECT_EQ(changedResultList[0].wrenchRatio.size(), resultList[0].wrenchRatio.size() - 4);
+}
+
+TEST(TestStanceEvaluator, Exception)
+{
+  auto leftFootContact = std::make_shared<ForceColl::SurfaceContact>(
+      "LeftFootContact", 0.5,
+      std::vector<Eigen::Vector3d>{Eigen::Vector3d(-0.1, -0.05, 0.0), Eigen::Vector3d(-0.1, 0.05, 0.0),
+                                   Eigen::Vector3d(0.1, 0.05, 0.0), Eigen::Vector3d(0.1, -0.05, 0.0)},
+      sva::PTransformd::Identity());
+  std::vector<std::shared_ptr<ForceColl::Contact>> contactList = {leftFootContact,
+                                                                  std::make_shared<ThrowingContact>()};
+  ForceColl::StanceEvaluator stanceEval(contactList, mc_rtc::Configuration::fromYAMLData("threadNum: 4"));
+
+  std::vector<std::vector<sva::PTransformd>> poseSetList(
+      8, {sva::PTransformd::Identity(), sva::PTransformd::Identity()});
+  poseSetList[5][1] = sva::PTransformd(Eigen::Vector3d(1000.0, 0.0, 0.0));
+  sva::ForceVecd desiredTotalWrench = sva::ForceVecd(Eigen::Vector3d::Zero(), Eigen::Vector3d(0.0, 0.0, 500.0));
+
+  // The exception in the threads is rethrown instead of terminating the program, and the threads are still usable
+  EXPECT_THROW(stanceEval.run(poseSetList, desiredTotalWrench), std::runtime_error);
+  poseSetList[5][1] = sva::PTransformd::Identity();
+  auto resultList = stanceEval.run(poseSetList, desiredTotalWrench);
+  ASSERT_EQ(resultList.size(), poseSetList.size());
+  for(const auto & result : resultList)
+  {
+    EXPECT_TRUE(result.feasible);
+  }
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,61 @@
+#include <gtest/gtest.h>
+
+#include <ForceColl/StaticEquilibriumRegion.h>
+
+TEST(TestStaticEquilibriumRegion, TwoSurfaceContact)
+{
+  double fricCoeff = 0.5;
+  std::vector<Eigen::Vector3d> localVertices = {Eigen::Vector3d(-0.1, -0.05, 0.0), Eigen::Vector3d(-0.1, 0.05, 0.0),
+                                                Eigen::Vector3d(0.1, 0.05, 0.0), Eigen::Vector3d(0.1, -0.05, 0.0)};
+  auto leftFootContact = std::make_shared<ForceColl::SurfaceContact>("LeftFootContact", fricCoeff, localVertices,
+                                                                     sva::PTransformd(Eigen::Vector3d(0, 0.1, 0)));
+  auto rightFootContact = std::make_shared<ForceColl::SurfaceContact>("RightFootContact", fricCoeff, localVertices,
+                                                                      sva::PTransformd(Eigen::Vector3d(0, -0.1, 0)));
+  std::vector<std::shared_ptr<ForceColl::Contact>> contactList = {leftFootContact, rightFootContact};
+
+  ForceColl::StaticEquilibriumRegion region(contactList, 50.0,
+                                            mc_rtc::Configuration::fromYAMLData("ridgeForceMinMax: [0.0, 1e6]"));
+
+  // On flat ground, the region is the convex hull of the feet
+  EXPECT_GE(region.vertexList_.size(), 4);
+  for(const auto & vertex : region.vertexList_)
+  {
+    EXPECT_LT(std::abs(vertex.x()), 0.1 + 1e-3) << "vertex: " << vertex.transpose();
+    EXPECT_LT(std::abs(vertex.y()), 0.15 + 1e-3) << "vertex: " << vertex.transpose();
+  }
+  EXPECT_TRUE(region.contains(Eigen::Vector2d::Zero()));
+  EXPECT_TRUE(region.contains(Eigen::Vector2d(0.09, 0.14)));
+  EXPECT_FALSE(region.contains(Eigen::Vector2d(0.12, 0.0)));
+  EXPECT_FALSE(region.contains(Eigen::Vector2d(0.0, -0.17)));
+
+  // Move one foot forward and compare with the region computed from scratch
+  rightFootContact->updateGlobalVertices(sva::PTransformd(sva::RotZ(0.3), Eigen::Vector3d(0.2, -0.1, 0)));
+  region.update();
+  EXPECT_TRUE(region.contains(Eigen::Vector2d(0.15, -0.1)));
+  EXPECT_FALSE(region.contains(Eigen::Vector2d(-0.05, -0.14)));
+  std::vector<Eigen::Vector2d> warmVertexList = region.vertexList_;
+  region.update(false);
+  for(const auto & vertex : warmVertexList)
+  {
+    EXPECT_TRUE(region.contains(vertex, 2e-3)) << "vertex: " << vertex.transpose();
+  }
+}
+
+TEST(TestStaticEquilibriumRegion, Infeasible)
+{
+  // Vertical wall contact alone cannot support the gravity
+  auto contact = std::make_shared<ForceColl::SurfaceContact>(
+      "WallContact", 0.5,
+      std::vector<Eigen::Vector3d>{Eigen::Vector3d(-0.1, -0.1, 0.0), Eigen::Vector3d(-0.1, 0.1, 0.0),
+                                   Eigen::Vector3d(0.1, 0.1, 0.0), Eigen::Vector3d(0.1, -0.1, 0.0)},
+      sva::PTransformd(sva::RotY(M_PI / 2)));
+  ForceColl::StaticEquilibriumRegion region({contact}, 50.0);
+  EXPECT_TRUE(region.vertexList_.empty());
+  EXPECT_FALSE(region.contains(Eigen::Vector2d::Zero()));
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
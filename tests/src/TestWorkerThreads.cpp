@@ -0,0 +1,68 @@
+#include <gtest/gtest.h>
+
+#include <ForceColl/WorkerThreads.h>
+
+#include <atomic>
+#include <stdexcept>
+
+TEST(TestWorkerThreads, Run)
+{
+  for(int threadNum : {1, 4})
+  {
+    ForceColl::WorkerThreads workerThreads(threadNum);
+    EXPECT_EQ(workerThreads.threadNum(), threadNum);
+
+    // Each thread is called once with its own index in every run
+    for(int iter = 0; iter < 100; iter++)
+    {
+      std::vector<int> callNumList(static_cast<size_t>(threadNum), 0);
+      workerThreads.run([&](int threadIdx) { callNumList[static_cast<size_t>(threadIdx)]++; });
+      for(int callNum : callNumList)
+      {
+        EXPECT_EQ(callNum, 1);
+      }
+    }
+
+    // The items are shared by the threads in the same way as the parallel evaluations
+    std::atomic<size_t> itemIdx(0);
+    std::vector<int> itemList(1000, 0);
+    workerThreads.run([&](int) {
+      for(size_t i = itemIdx++; i < itemList.size(); i = itemIdx++)
+      {
+        itemList[i]++;
+      }
+    });
+    for(int item : itemList)
+    {
+      EXPECT_EQ(item, 1);
+    }
+  }
+}
+
+TEST(TestWorkerThreads, Exception)
+{
+  ForceColl::WorkerThreads workerThreads(3);
+
+  // The exception of a worker thread is rethrown after all threads finish
+  std::atomic<int> finishedNum(0);
+  EXPECT_THROW(workerThreads.run([&](int threadIdx) {
+    if(threadIdx == 2)
+    {
+      throw std::runtime_error("Error in worker thread");
+    }
+    finishedNum++;
+  }),
+               std::runtime_error);
+  EXPECT_EQ(finishedNum, 2);
+
+  // The threads are still usable after the exception
+  finishedNum = 0;
+  EXPECT_NO_THROW(workerThreads.run([&](int) { finishedNum++; }));
+  EXPECT_EQ(finishedNum, 3);
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
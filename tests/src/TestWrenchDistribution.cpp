@@ -138,6 +138,547 @@ TEST(TestWrenchDistribution, ContainsGraspContactWithMaxWrench)
   do_TestWrenchDistribution_ContainsGraspContact<true>();
 }
 
+TEST(TestWrenchDistribution, WrenchFormulation)
+{
+  double fricCoeff = 0.5;
+  auto leftFootContact = std::make_shared<ForceColl::SurfaceContact>(
+      "LeftFootContact", fricCoeff,
+      std::vector<Eigen::Vector3d>{Eigen::Vector3d(-0.1, -0.1, 0.0), Eigen::Vector3d(-0.1, 0.1, 0.0),
+                                   Eigen::Vector3d(0.1, 0.1, 0.0), Eigen::Vector3d(0.1, -0.1, 0.0)},
+      sva::PTransformd::Identity());
+  auto rightFootContact = std::make_shared<ForceColl::SurfaceContact>(
+      "RightFootContact", fricCoeff, std::vector<Eigen::Vector3d>{Eigen::Vector3d::Zero()},
+      sva::PTransformd(Eigen::Vector3d(0, -0.5, 0.5)));
+  auto leftHandContact = std::make_shared<ForceColl::GraspContact>(
+      "LeftHandContact", fricCoeff,
+      std::vector<sva::PTransformd>{sva::PTransformd(Eigen::Vector3d(0.0, 0.0, -0.01)),
+                                    sva::PTransformd(sva::RotX(M_PI), Eigen::Vector3d(0.0, 0.0, 0.01))},
+      sva::PTransformd(sva::RotY(M_PI / 2), Eigen::Vector3d(0.5, 0.5, 1.0)));
+  auto emptyContact = std::make_shared<ForceColl::EmptyContact>(std::string("EmptyContact"));
+  std::vector<std::shared_ptr<ForceColl::Contact>> contactList = {leftFootContact, rightFootContact, leftHandContact,
+                                                                  emptyContact};
+
+  sva::ForceVecd desiredTotalWrench = sva::ForceVecd(Eigen::Vector3d(10.0, 0.0, 0.0), Eigen::Vector3d(0.0, 0.0, 500.0));
+  Eigen::Vector3d momentOrigin(0.1, -0.2, 0.3);
+  auto wrenchDist = std::make_shared<ForceColl::WrenchDistribution>(
+      contactList, mc_rtc::Configuration::fromYAMLData("formulation: Wrench"));
+  sva::ForceVecd resultTotalWrench = wrenchDist->run(desiredTotalWrench, momentOrigin);
+
+  EXPECT_EQ(wrenchDist->qpCoeff_.dim_var_, 18);
+  EXPECT_LT((desiredTotalWrench - resultTotalWrench).vector().norm(), 1e-2)
+      << "desiredTotalWrench: " << desiredTotalWrench << std::endl
+      << "resultTotalWrench: " << resultTotalWrench << std::endl;
+  EXPECT_TRUE((wrenchDist->resultWrenchRatio_.array() > wrenchDist->config().ridgeForceMinMax.first - 1e-6).all());
+  EXPECT_LT((resultTotalWrench - ForceColl::calcTotalWrench(contactList, wrenchDist->resultWrenchRatio_, momentOrigin))
+                .vector()
+                .norm(),
+            1e-6);
+}
+
+TEST(TestWrenchDistribution, LiftedFormulation)
+{
+  double fricCoeff = 0.5;
+  auto leftFootContact = std::make_shared<ForceColl::SurfaceContact>(
+      "LeftFootContact", fricCoeff,
+      std::vector<Eigen::Vector3d>{Eigen::Vector3d(-0.1, -0.1, 0.0), Eigen::Vector3d(-0.1, 0.1, 0.0),
+                                   Eigen::Vector3d(0.1, 0.1, 0.0), Eigen::Vector3d(0.1, -0.1, 0.0)},
+      sva::PTransformd::Identity());
+  auto rightFootContact = std::make_shared<ForceColl::SurfaceContact>(
+      "RightFootContact", fricCoeff, std::vector<Eigen::Vector3d>{Eigen::Vector3d::Zero()},
+      sva::PTransformd(Eigen::Vector3d(0, -0.5, 0.5)));
+  auto leftHandContact = std::make_shared<ForceColl::GraspContact>(
+      "LeftHandContact", fricCoeff,
+      std::vector<sva::PTransformd>{sva::PTransformd(Eigen::Vector3d(0.0, 0.0, -0.01)),
+                                    sva::PTransformd(sva::RotX(M_PI), Eigen::Vector3d(0.0, 0.0, 0.01))},
+      sva::PTransformd(sva::RotY(M_PI / 2), Eigen::Vector3d(0.5, 0.5, 1.0)));
+  sva::ForceVecd maxWrench = sva::ForceVecd(Eigen::Vector3d(1.0, 1.0, 1.0), Eigen::Vector3d(1.0, 1.0, 10.0));
+  leftHandContact->maxWrench_ = maxWrench;
+  auto emptyContact = std::make_shared<ForceColl::EmptyContact>(std::string("EmptyContact"));
+  std::vector<std::shared_ptr<ForceColl::Contact>> contactList = {leftFootContact, rightFootContact, leftHandContact,
+                                                                  emptyContact};
+
+  sva::ForceVecd desiredTotalWrench = sva::ForceVecd(Eigen::Vector3d(10.0, 0.0, 0.0), Eigen::Vector3d(0.0, 0.0, 500.0));
+  Eigen::Vector3d momentOrigin(0.1, -0.2, 0.3);
+  auto ridgeWrenchDist = std::make_shared<ForceColl::WrenchDistribution>(contactList);
+  sva::ForceVecd ridgeResultTotalWrench = ridgeWrenchDist->run(desiredTotalWrench, momentOrigin);
+  auto liftedWrenchDist = std::make_shared<ForceColl::WrenchDistribution>(
+      contactList, mc_rtc::Configuration::fromYAMLData("formulation: Lifted"));
+  sva::ForceVecd liftedResultTotalWrench = liftedWrenchDist->run(desiredTotalWrench, momentOrigin);
+
+  int ridgeNum = static_cast<int>(liftedWrenchDist->resultWrenchRatio_.size());
+  EXPECT_EQ(liftedWrenchDist->qpCoeff_.dim_var_, ridgeNum + 18 + 6);
+  EXPECT_EQ(liftedWrenchDist->qpCoeff_.dim_eq_, 18 + 6);
+  EXPECT_EQ(liftedWrenchDist->qpCoeff_.dim_ineq_, 0);
+  // The Hessian is diagonal because the wrench weight is applied only to the total wrench variable
+  const Eigen::MatrixXd & liftedObjMat = liftedWrenchDist->qpCoeff_.obj_mat_;
+  EXPECT_EQ((liftedObjMat - Eigen::MatrixXd(liftedObjMat.diagonal().asDiagonal())).norm(), 0.0);
+  // Only the total wrench is compared because the regularization of the local wrench variables changes the
+  // distribution among the redundant ridge forces, while its effect on the total wrench is of order regularWeight
+  EXPECT_LT((liftedResultTotalWrench - ridgeResultTotalWrench).vector().norm(), 1e-4)
+      << "ridgeResultTotalWrench: " << ridgeResultTotalWrench << std::endl
+      << "liftedResultTotalWrench: " << liftedResultTotalWrench << std::endl;
+  EXPECT_TRUE(
+      (liftedWrenchDist->resultWrenchRatio_.array() > liftedWrenchDist->config().ridgeForceMinMax.first - 1e-6).all());
+  EXPECT_LT((liftedResultTotalWrench
+             - ForceColl::calcTotalWrench(contactList, liftedWrenchDist->resultWrenchRatio_, momentOrigin))
+                .vector()
+                .norm(),
+            1e-6);
+  sva::ForceVecd localWrench = leftHandContact->calcLocalWrench(liftedWrenchDist->resultWrenchRatio_.segment(
+      ridgeNum - leftHandContact->ridgeNum(), leftHandContact->ridgeNum()));
+  EXPECT_TRUE(((localWrench.vector().cwiseAbs() - maxWrench.vector()).array() < 1e-6).all());
+}
+
+TEST(TestWrenchDistribution, CriticalRegion)
+{
+  double fricCoeff = 0.5;
+  auto leftFootContact = std::make_shared<ForceColl::SurfaceContact>(
+      "LeftFootContact", fricCoeff,
+      std::vector<Eigen::Vector3d>{Eigen::Vector3d(-0.1, -0.1, 0.0), Eigen::Vector3d(-0.1, 0.1, 0.0),
+                                   Eigen::Vector3d(0.1, 0.1, 0.0), Eigen::Vector3d(0.1, -0.1, 0.0)},
+      sva::PTransformd::Identity());
+  auto rightFootContact = std::make_shared<ForceColl::SurfaceContact>(
+      "RightFootContact", fricCoeff, std::vector<Eigen::Vector3d>{Eigen::Vector3d::Zero()},
+      sva::PTransformd(Eigen::Vector3d(0, -0.5, 0.5)));
+  std::vector<std::shared_ptr<ForceColl::Contact>> contactList = {leftFootContact, rightFootContact};
+
+  auto wrenchDist = std::make_shared<ForceColl::WrenchDistribution>(contactList);
+  auto explicitWrenchDist = std::make_shared<ForceColl::WrenchDistribution>(
+      contactList, mc_rtc::Configuration::fromYAMLData("criticalRegionNumMax: 100"));
+
+  sva::ForceVecd nominalTotalWrench = sva::ForceVecd(Eigen::Vector3d(10.0, 0.0, 0.0), Eigen::Vector3d(0.0, 0.0, 500.0));
+  explicitWrenchDist->precomputeCriticalRegions({nominalTotalWrench});
+  EXPECT_EQ(explicitWrenchDist->criticalRegionList_.size(), 1);
+
+  int hitNum = 0;
+  for(int i = 0; i < 50; i++)
+  {
+    sva::ForceVecd desiredTotalWrench =
+        nominalTotalWrench + sva::ForceVecd(Eigen::Vector3d::Random() * 1.0, Eigen::Vector3d::Random() * 5.0);
+    sva::ForceVecd resultTotalWrench = wrenchDist->run(desiredTotalWrench);
+    sva::ForceVecd explicitResultTotalWrench = explicitWrenchDist->run(desiredTotalWrench);
+    if(explicitWrenchDist->criticalRegionHit_)
+    {
+      hitNum++;
+    }
+    EXPECT_LT((resultTotalWrench - explicitResultTotalWrench).vector().norm(), 1e-2)
+        << "resultTotalWrench: " << resultTotalWrench << std::endl
+        << "explicitResultTotalWrench: " << explicitResultTotalWrench << std::endl;
+    EXPECT_TRUE((explicitWrenchDist->resultWrenchRatio_.array()
+                 > explicitWrenchDist->config().ridgeForceMinMax.first - 1e-6)
+                    .all());
+  }
+  EXPECT_GT(hitNum, 0);
+
+  // Critical regions are cleared when the contact moves
+  rightFootContact->updateGlobalVertices(sva::PTransformd(Eigen::Vector3d(0, -0.4, 0.5)));
+  explicitWrenchDist->run(nominalTotalWrench);
+  EXPECT_FALSE(explicitWrenchDist->criticalRegionHit_);
+  EXPECT_EQ(explicitWrenchDist->criticalRegionList_.size(), 1);
+}
+
+TEST(TestWrenchDistribution, WrenchJacobian)
+{
+  double fricCoeff = 0.5;
+  auto leftFootContact = std::make_shared<ForceColl::SurfaceContact>(
+      "LeftFootContact", fricCoeff,
+      std::vector<Eigen::Vector3d>{Eigen::Vector3d(-0.1, -0.1, 0.0), Eigen::Vector3d(-0.1, 0.1, 0.0),
+                                   Eigen::Vector3d(0.1, 0.1, 0.0), Eigen::Vector3d(0.1, -0.1, 0.0)},
+      sva::PTransformd::Identity());
+  auto rightFootContact = std::make_shared<ForceColl::SurfaceContact>(
+      "RightFootContact", fricCoeff, std::vector<Eigen::Vector3d>{Eigen::Vector3d::Zero()},
+      sva::PTransformd(Eigen::Vector3d(0, -0.5, 0.5)));
+  std::vector<std::shared_ptr<ForceColl::Contact>> contactList = {leftFootContact, rightFootContact};
+
+  // The horizontal force exceeds the friction limit, so the result is not equal to the desired
+  sva::ForceVecd desiredTotalWrench =
+      sva::ForceVecd(Eigen::Vector3d(10.0, 0.0, 0.0), Eigen::Vector3d(400.0, 0.0, 500.0));
+  Eigen::Vector3d momentOrigin(0.0, 0.0, 0.8);
+
+  for(const std::string formulation : {"Ridge", "Wrench", "Lifted"})
+  {
+    auto wrenchDist = std::make_shared<ForceColl::WrenchDistribution>(
+        contactList, mc_rtc::Configuration::fromYAMLData("formulation: " + formulation));
+    wrenchDist->run(desiredTotalWrench, momentOrigin);
+    Eigen::MatrixXd wrenchRatioJacobian = wrenchDist->calcWrenchRatioJacobian();
+    std::vector<Eigen::Matrix6d> wrenchJacobianList = wrenchDist->calcWrenchJacobianList();
+    EXPECT_EQ(wrenchRatioJacobian.rows(), wrenchDist->resultWrenchRatio_.size());
+    EXPECT_EQ(wrenchJacobianList.size(), contactList.size());
+
+    Eigen::Matrix6d totalWrenchJacobian = wrenchDist->totalGraspMat_ * wrenchRatioJacobian;
+    EXPECT_GT((totalWrenchJacobian - Eigen::Matrix6d::Identity()).norm(), 1e-1) << "formulation: " << formulation;
+    EXPECT_LT((totalWrenchJacobian - (wrenchJacobianList[0] + wrenchJacobianList[1])).norm(), 1e-6)
+        << "formulation: " << formulation;
+
+    // Compare with finite difference of total wrench
+    double delta = 1e-2;
+    Eigen::Matrix6d numTotalWrenchJacobian;
+    for(int i = 0; i < 6; i++)
+    {
+      sva::ForceVecd deltaWrench = sva::ForceVecd(Eigen::Vector6d::Unit(i) * delta);
+      sva::ForceVecd plusWrench = wrenchDist->run(desiredTotalWrench + deltaWrench, momentOrigin);
+      sva::ForceVecd minusWrench = wrenchDist->run(desiredTotalWrench - deltaWrench, momentOrigin);
+      numTotalWrenchJacobian.col(i) = (plusWrench - minusWrench).vector() / (2 * delta);
+    }
+    EXPECT_LT((totalWrenchJacobian - numTotalWrenchJacobian).norm(), 1e-2)
+        << "formulation: " << formulation << std::endl
+        << "totalWrenchJacobian:" << std::endl
+        << totalWrenchJacobian << std::endl
+        << "numTotalWrenchJacobian:" << std::endl
+        << numTotalWrenchJacobian << std::endl;
+  }
+}
+
+TEST(TestWrenchDistribution, CoarseToFine)
+{
+  double fricCoeff = 0.5;
+  std::vector<Eigen::Vector3d> gridVertices;
+  for(int i = 0; i < 5; i++)
+  {
+    for(int j = 0; j < 5; j++)
+    {
+      gridVertices.push_back(Eigen::Vector3d(-0.1 + 0.05 * i, -0.05 + 0.025 * j, 0.0));
+    }
+  }
+  auto leftFootContact = std::make_shared<ForceColl::SurfaceContact>("LeftFootContact", fricCoeff, gridVertices,
+                                                                     sva::PTransformd(Eigen::Vector3d(0, 0.1, 0)));
+  auto rightFootContact = std::make_shared<ForceColl::SurfaceContact>(
+      "RightFootContact", fricCoeff, gridVertices, sva::PTransformd(sva::RotZ(0.2), Eigen::Vector3d(0.05, -0.1, 0)));
+  std::vector<std::shared_ptr<ForceColl::Contact>> contactList = {leftFootContact, rightFootContact};
+
+  auto wrenchDist = std::make_shared<ForceColl::WrenchDistribution>(contactList);
+  auto coarseToFineWrenchDist = std::make_shared<ForceColl::WrenchDistribution>(
+      contactList, mc_rtc::Configuration::fromYAMLData("coarseVertexNum: 4"));
+
+  // The first wrench is solved only in the coarse stage, and the second wrench has the moment near the limit
+  std::vector<sva::ForceVecd> desiredTotalWrenchList = {
+      sva::ForceVecd(Eigen::Vector3d(5.0, 0.0, 0.0), Eigen::Vector3d(0.0, 0.0, 1000.0)),
+      sva::ForceVecd(Eigen::Vector3d(90.0, -40.0, 0.0), Eigen::Vector3d(20.0, 0.0, 1000.0))};
+  for(const auto & desiredTotalWrench : desiredTotalWrenchList)
+  {
+    sva::ForceVecd resultTotalWrench = wrenchDist->run(desiredTotalWrench);
+    sva::ForceVecd coarseToFineResultTotalWrench = coarseToFineWrenchDist->run(desiredTotalWrench);
+    EXPECT_LT((resultTotalWrench - coarseToFineResultTotalWrench).vector().norm(), 1e-2)
+        << "resultTotalWrench: " << resultTotalWrench << std::endl
+        << "coarseToFineResultTotalWrench: " << coarseToFineResultTotalWrench << std::endl;
+    EXPECT_LT((coarseToFineResultTotalWrench
+               - ForceColl::calcTotalWrench(contactList, coarseToFineWrenchDist->resultWrenchRatio_))
+                  .vector()
+                  .norm(),
+              1e-6);
+    EXPECT_TRUE((coarseToFineWrenchDist->resultWrenchRatio_.array()
+                 > coarseToFineWrenchDist->config().ridgeForceMinMax.first - 1e-6)
+                    .all());
+  }
+
+  coarseToFineWrenchDist->run(desiredTotalWrenchList[0]);
+  EXPECT_EQ(coarseToFineWrenchDist->qpCoeff_.dim_var_, 2 * 4 * leftFootContact->fricPyramid_->ridgeNum());
+}
+
+TEST(TestWrenchDistribution, AdaptiveFrictionPyramid)
+{
+  double fricCoeff = 0.5;
+  auto contact = std::make_shared<ForceColl::SurfaceContact>(
+      "Contact", fricCoeff,
+      std::vector<Eigen::Vector3d>{Eigen::Vector3d(-0.1, -0.1, 0.0), Eigen::Vector3d(-0.1, 0.1, 0.0),
+                                   Eigen::Vector3d(0.1, 0.1, 0.0), Eigen::Vector3d(0.1, -0.1, 0.0)},
+      sva::PTransformd::Identity());
+  auto wrenchDist = std::make_shared<ForceColl::WrenchDistribution>(
+      std::vector<std::shared_ptr<ForceColl::Contact>>{contact},
+      mc_rtc::Configuration::fromYAMLData("adaptiveRidgeNum: [4, 8]"));
+
+  // The diagonal tangential force is outside the coarse pyramid but inside the fine pyramid
+  sva::ForceVecd desiredTotalWrench = sva::ForceVecd(Eigen::Vector3d::Zero(), Eigen::Vector3d(130.0, 130.0, 500.0));
+  sva::ForceVecd resultTotalWrench = wrenchDist->run(desiredTotalWrench);
+  const auto & solverContactList = wrenchDist->solverContactList();
+  EXPECT_EQ(solverContactList[0]->fricPyramid_->ridgeNum(), 8);
+  EXPECT_EQ(wrenchDist->resultWrenchRatio_.size(), solverContactList[0]->ridgeNum());
+  EXPECT_LT((desiredTotalWrench - resultTotalWrench).vector().norm(), 1e-2)
+      << "desiredTotalWrench: " << desiredTotalWrench << std::endl
+      << "resultTotalWrench: " << resultTotalWrench << std::endl;
+  EXPECT_GT(solverContactList[0]->calcFricUsage(wrenchDist->resultWrenchRatio_), 0.7);
+
+  // The contact passed by the caller is not modified
+  EXPECT_EQ(contact->fricPyramid_->ridgeNum(), 4);
+  EXPECT_EQ(wrenchDist->contactList_[0], contact);
+
+  // The fine pyramid is kept while the friction usage is between the thresholds
+  desiredTotalWrench = sva::ForceVecd(Eigen::Vector3d::Zero(), Eigen::Vector3d(100.0, 100.0, 500.0));
+  wrenchDist->run(desiredTotalWrench);
+  EXPECT_EQ(solverContactList[0]->fricPyramid_->ridgeNum(), 8);
+
+  // The fine pyramid follows the pose of the contact
+  contact->updateGlobalVertices(sva::PTransformd(Eigen::Vector3d(0.0, 0.0, 0.5)));
+  resultTotalWrench = wrenchDist->run(desiredTotalWrench, contact->pose_.translation());
+  EXPECT_EQ(solverContactList[0]->fricPyramid_->ridgeNum(), 8);
+  EXPECT_LT((desiredTotalWrench - resultTotalWrench).vector().norm(), 1e-2);
+  EXPECT_TRUE(solverContactList[0]->pose_.translation().isApprox(contact->pose_.translation()));
+
+  // The own pyramid of the contact is used at the next run after the friction usage gets small
+  desiredTotalWrench = sva::ForceVecd(Eigen::Vector3d::Zero(), Eigen::Vector3d(10.0, 0.0, 500.0));
+  wrenchDist->run(desiredTotalWrench);
+  EXPECT_EQ(solverContactList[0]->fricPyramid_->ridgeNum(), 8);
+  resultTotalWrench = wrenchDist->run(desiredTotalWrench);
+  EXPECT_EQ(solverContactList[0], contact);
+  EXPECT_EQ(wrenchDist->resultWrenchRatio_.size(), contact->ridgeNum());
+  EXPECT_LT((desiredTotalWrench - resultTotalWrench).vector().norm(), 1e-2);
+
+  // The original pyramid is restored even if it is finer than the coarse one in the configuration
+  contact->updateFricPyramid(ForceColl::FrictionPyramid::makeShared(fricCoeff, 6));
+  desiredTotalWrench = sva::ForceVecd(Eigen::Vector3d::Zero(), Eigen::Vector3d(130.0, 130.0, 500.0));
+  wrenchDist->run(desiredTotalWrench);
+  EXPECT_EQ(solverContactList[0]->fricPyramid_->ridgeNum(), 8);
+  EXPECT_EQ(contact->fricPyramid_->ridgeNum(), 6);
+  desiredTotalWrench = sva::ForceVecd(Eigen::Vector3d::Zero(), Eigen::Vector3d(10.0, 0.0, 500.0));
+  wrenchDist->run(desiredTotalWrench);
+  wrenchDist->run(desiredTotalWrench);
+  EXPECT_EQ(solverContactList[0], contact);
+  EXPECT_EQ(solverContactList[0]->fricPyramid_->ridgeNum(), 6);
+
+  // Any number of ridges made by the trigonometric functions is accepted
+  EXPECT_NO_THROW(ForceColl::WrenchDistribution(std::vector<std::shared_ptr<ForceColl::Contact>>{contact},
+                                                mc_rtc::Configuration::fromYAMLData("adaptiveRidgeNum: [4, 5]")));
+
+  // Invalid numbers of ridges are rejected
+  for(const std::string adaptiveRidgeNum : {"[0, 8]", "[-4, 8]", "[8, 4]", "[2, 8]"})
+  {
+    auto mcRtcConfig = mc_rtc::Configuration::fromYAMLData("adaptiveRidgeNum: " + adaptiveRidgeNum);
+    EXPECT_THROW(ForceColl::WrenchDistribution(std::vector<std::shared_ptr<ForceColl::Contact>>{contact}, mcRtcConfig),
+                 std::runtime_error)
+        << "adaptiveRidgeNum: " << adaptiveRidgeNum;
+  }
+}
+
+TEST(TestWrenchDistribution, ConeFormulation)
+{
+  double fricCoeff = 0.5;
+  auto leftFootContact = std::make_shared<ForceColl::SurfaceContact>(
+      "LeftFootContact", fricCoeff,
+      std::vector<Eigen::Vector3d>{Eigen::Vector3d(-0.1, -0.1, 0.0), Eigen::Vector3d(-0.1, 0.1, 0.0),
+                                   Eigen::Vector3d(0.1, 0.1, 0.0), Eigen::Vector3d(0.1, -0.1, 0.0)},
+      sva::PTransformd::Identity());
+  auto leftHandContact = std::make_shared<ForceColl::GraspContact>(
+      "LeftHandContact", fricCoeff,
+      std::vector<sva::PTransformd>{sva::PTransformd(Eigen::Vector3d(0.0, 0.0, -0.01)),
+                                    sva::PTransformd(sva::RotX(M_PI), Eigen::Vector3d(0.0, 0.0, 0.01))},
+      sva::PTransformd(sva::RotY(M_PI / 2), Eigen::Vector3d(0.5, 0.5, 1.0)),
+      sva::ForceVecd(Eigen::Vector3d(1.0, 1.0, 1.0), Eigen::Vector3d(1.0, 1.0, 10.0)));
+  std::vector<std::shared_ptr<ForceColl::Contact>> contactList = {leftFootContact, leftHandContact};
+
+  // The diagonal tangential force is outside the friction pyramid but inside the friction cone
+  sva::ForceVecd desiredTotalWrench = sva::ForceVecd(Eigen::Vector3d::Zero(), Eigen::Vector3d(130.0, 130.0, 500.0));
+  Eigen::Vector3d momentOrigin(0.0, 0.0, 0.1);
+  auto ridgeWrenchDist = std::make_shared<ForceColl::WrenchDistribution>(contactList);
+  auto coneWrenchDist = std::make_shared<ForceColl::WrenchDistribution>(
+      contactList, mc_rtc::Configuration::fromYAMLData("formulation: Cone"));
+  sva::ForceVecd ridgeResultTotalWrench = ridgeWrenchDist->run(desiredTotalWrench, momentOrigin);
+  sva::ForceVecd coneResultTotalWrench = coneWrenchDist->run(desiredTotalWrench, momentOrigin);
+
+  EXPECT_EQ(coneWrenchDist->qpCoeff_.dim_var_, 3 * 6);
+  EXPECT_GT((desiredTotalWrench - ridgeResultTotalWrench).vector().norm(), 1.0);
+  EXPECT_LT((desiredTotalWrench - coneResultTotalWrench).vector().norm(), 1e-1)
+      << "desiredTotalWrench: " << desiredTotalWrench << std::endl
+      << "coneResultTotalWrench: " << coneResultTotalWrench << std::endl;
+
+  // Check friction cone and maximum wrench
+  const Eigen::VectorXd & vertexForces = coneWrenchDist->qpSolution_;
+  for(Eigen::DenseIndex i = 0; i < vertexForces.size(); i += 3)
+  {
+    EXPECT_LE(vertexForces.segment<2>(i).norm(), (1 + 2e-3) * fricCoeff * vertexForces(i + 2));
+  }
+  ASSERT_EQ(coneWrenchDist->resultWrenchList_.size(), 2);
+  sva::ForceVecd localHandWrench = leftHandContact->pose_.dualMul(coneWrenchDist->resultWrenchList_[1]);
+  EXPECT_TRUE(((localHandWrench.vector().cwiseAbs() - leftHandContact->maxWrench_->vector()).array() < 1e-6).all());
+  EXPECT_TRUE(coneWrenchDist->coneConverged_);
+
+  // The result is given only by the contact wrenches, which are consistent with the total wrench
+  EXPECT_EQ(coneWrenchDist->resultWrenchRatio_.size(), 0);
+  sva::ForceVecd coneSumWrench = sva::ForceVecd::Zero();
+  for(const auto & wrench : coneWrenchDist->resultWrenchList_)
+  {
+    coneSumWrench += sva::ForceVecd(wrench.couple() - momentOrigin.cross(wrench.force()), wrench.force());
+  }
+  EXPECT_LT((coneSumWrench - coneResultTotalWrench).vector().norm(), 1e-8);
+
+  // Non-convergence is signaled if the number of QP solves is not enough
+  auto unconvergedWrenchDist = std::make_shared<ForceColl::WrenchDistribution>(
+      contactList, mc_rtc::Configuration::fromYAMLData("{formulation: Cone, coneIterMax: 1}"));
+  unconvergedWrenchDist->run(sva::ForceVecd(Eigen::Vector3d::Zero(), Eigen::Vector3d(240.0, 0.0, 500.0)), momentOrigin);
+  EXPECT_FALSE(unconvergedWrenchDist->coneConverged_);
+  EXPECT_THROW(
+      ForceColl::WrenchDistribution(contactList, mc_rtc::Configuration::fromYAMLData("{coneCutNumMax: 4}")),
+      std::runtime_error);
+}
+
+TEST(TestWrenchDistribution, QpDecimation)
+{
+  double fricCoeff = 0.5;
+  auto leftFootContact = std::make_shared<ForceColl::SurfaceContact>(
+      "LeftFootContact", fricCoeff,
+      std::vector<Eigen::Vector3d>{Eigen::Vector3d(-0.1, -0.1, 0.0), Eigen::Vector3d(-0.1, 0.1, 0.0),
+                                   Eigen::Vector3d(0.1, 0.1, 0.0), Eigen::Vector3d(0.1, -0.1, 0.0)},
+      sva::PTransformd(Eigen::Vector3d(0.0, 0.1, 0.0)));
+  auto rightFootContact = std::make_shared<ForceColl::SurfaceContact>(
+      "RightFootContact", fricCoeff,
+      std::vector<Eigen::Vector3d>{Eigen::Vector3d(-0.1, -0.1, 0.0), Eigen::Vector3d(-0.1, 0.1, 0.0),
+                                   Eigen::Vector3d(0.1, 0.1, 0.0), Eigen::Vector3d(0.1, -0.1, 0.0)},
+      sva::PTransformd(Eigen::Vector3d(0.0, -0.1, 0.0)));
+  std::vector<std::shared_ptr<ForceColl::Contact>> contactList = {leftFootContact, rightFootContact};
+  Eigen::Vector3d momentOrigin(0.0, 0.0, 0.8);
+
+  for(const std::string formulation : {"Ridge", "Wrench", "Lifted"})
+  {
+    auto wrenchDist = std::make_shared<ForceColl::WrenchDistribution>(
+        contactList, mc_rtc::Configuration::fromYAMLData("{formulation: " + formulation + ", qpDecimation: 5}"));
+    auto refWrenchDist = std::make_shared<ForceColl::WrenchDistribution>(
+        contactList, mc_rtc::Configuration::fromYAMLData("formulation: " + formulation));
+
+    // QP is solved once in five calls, and the projection is close to the QP solution for small changes
+    for(int i = 0; i < 10; i++)
+    {
+      sva::ForceVecd desiredTotalWrench(Eigen::Vector3d(0.0, 0.5 * i, 0.0),
+                                        Eigen::Vector3d(1.0 * i, 0.0, 500.0 + 2.0 * i));
+      sva::ForceVecd resultTotalWrench = wrenchDist->run(desiredTotalWrench, momentOrigin);
+      sva::ForceVecd refResultTotalWrench = refWrenchDist->run(desiredTotalWrench, momentOrigin);
+      EXPECT_EQ(wrenchDist->projectionUsed_, i % 5 != 0) << "formulation: " << formulation << ", i: " << i;
+      EXPECT_LT((resultTotalWrench - refResultTotalWrench).vector().norm(), 1e-3)
+          << "formulation: " << formulation << ", i: " << i;
+      EXPECT_GE(wrenchDist->resultWrenchRatio_.minCoeff(), 3.0 - 1e-8);
+    }
+
+    // QP is solved if the moment origin is changed
+    wrenchDist->run(sva::ForceVecd(Eigen::Vector3d::Zero(), Eigen::Vector3d(0.0, 0.0, 500.0)));
+    EXPECT_FALSE(wrenchDist->projectionUsed_);
+  }
+}
+
+TEST(TestWrenchDistribution, Snapshot)
+{
+  double fricCoeff = 0.5;
+  sva::PTransformd rightFootPose(Eigen::Vector3d(0, -0.5, 0.5));
+  auto leftFootContact = std::make_shared<ForceColl::SurfaceContact>(
+      "LeftFootContact", fricCoeff,
+      std::vector<Eigen::Vector3d>{Eigen::Vector3d(-0.1, -0.1, 0.0), Eigen::Vector3d(-0.1, 0.1, 0.0),
+                                   Eigen::Vector3d(0.1, 0.1, 0.0), Eigen::Vector3d(0.1, -0.1, 0.0)},
+      sva::PTransformd::Identity());
+  auto rightFootContact = std::make_shared<ForceColl::SurfaceContact>(
+      "RightFootContact", fricCoeff, std::vector<Eigen::Vector3d>{Eigen::Vector3d::Zero()}, rightFootPose);
+  std::vector<std::shared_ptr<ForceColl::Contact>> contactList = {leftFootContact, rightFootContact};
+
+  sva::ForceVecd desiredTotalWrench = sva::ForceVecd(Eigen::Vector3d(10.0, 0.0, 0.0), Eigen::Vector3d(0.0, 0.0, 500.0));
+  auto wrenchDist = std::make_shared<ForceColl::WrenchDistribution>(contactList);
+  sva::ForceVecd resultTotalWrench = wrenchDist->run(desiredTotalWrench);
+  Eigen::VectorXd resultWrenchRatio = wrenchDist->resultWrenchRatio_;
+  auto snapshot = wrenchDist->snapshot();
+
+  // The copies of unchanged contacts are shared
+  auto unchangedSnapshot = wrenchDist->snapshot();
+  EXPECT_EQ(unchangedSnapshot->contactList[0], snapshot->contactList[0]);
+  EXPECT_EQ(unchangedSnapshot->contactList[1], snapshot->contactList[1]);
+
+  // The QP data are shared if run() is not called
+  EXPECT_EQ(unchangedSnapshot->qpCoeff, snapshot->qpCoeff);
+  EXPECT_EQ(unchangedSnapshot->objParamMat, snapshot->objParamMat);
+  EXPECT_EQ(unchangedSnapshot->lastCriticalRegion, snapshot->lastCriticalRegion);
+  EXPECT_EQ(snapshot->qpCoeff->dim_var_, resultWrenchRatio.size());
+
+  // Rollout
+  rightFootContact->updateGlobalVertices(sva::PTransformd(Eigen::Vector3d(0.2, -0.3, 0.4)));
+  wrenchDist->contactList_.push_back(std::make_shared<ForceColl::EmptyContact>(std::string("EmptyContact")));
+  wrenchDist->run(sva::ForceVecd(Eigen::Vector3d(0.0, 20.0, 0.0), Eigen::Vector3d(50.0, 0.0, 400.0)));
+  auto rolloutSnapshot = wrenchDist->snapshot();
+  EXPECT_EQ(rolloutSnapshot->contactList[0], snapshot->contactList[0]);
+  EXPECT_NE(rolloutSnapshot->contactList[1], snapshot->contactList[1]);
+  EXPECT_NE(rolloutSnapshot->qpCoeff, snapshot->qpCoeff);
+  EXPECT_GT((rolloutSnapshot->qpCoeff->obj_vec_ - snapshot->qpCoeff->obj_vec_).norm(), 1e-3);
+  EXPECT_GT((wrenchDist->resultWrenchRatio_ - resultWrenchRatio).norm(), 1e-3);
+
+  // Restore
+  const auto * qpSolver = wrenchDist->qpSolver_.get();
+  wrenchDist->restore(snapshot);
+  EXPECT_EQ(wrenchDist->qpSolver_.get(), qpSolver);
+  EXPECT_EQ(wrenchDist->contactList_, contactList);
+  EXPECT_LT((rightFootContact->pose_.translation() - rightFootPose.translation()).norm(), 1e-10);
+  EXPECT_LT((rightFootContact->graspMat_ - snapshot->contactList[1]->graspMat_).norm(), 1e-10);
+  EXPECT_LT((wrenchDist->resultWrenchRatio_ - resultWrenchRatio).norm(), 1e-10);
+  EXPECT_LT((wrenchDist->resultTotalWrench_ - resultTotalWrench).vector().norm(), 1e-10);
+  EXPECT_LT((wrenchDist->run(desiredTotalWrench) - resultTotalWrench).vector().norm(), 1e-6);
+  EXPECT_LT((wrenchDist->resultWrenchRatio_ - resultWrenchRatio).norm(), 1e-6);
+
+  // The snapshot can be restored again
+  rightFootContact->updateGlobalVertices(sva::PTransformd(Eigen::Vector3d(0.2, -0.3, 0.4)));
+  wrenchDist->restore(snapshot);
+  EXPECT_LT((rightFootContact->pose_.translation() - rightFootPose.translation()).norm(), 1e-10);
+  auto restoredSnapshot = wrenchDist->snapshot();
+  EXPECT_EQ(restoredSnapshot->contactList[1], snapshot->contactList[1]);
+  EXPECT_EQ(restoredSnapshot->qpCoeff, snapshot->qpCoeff);
+  EXPECT_LT((wrenchDist->qpCoeff_.obj_vec_ - snapshot->qpCoeff->obj_vec_).norm(), 1e-10);
+
+  // Invalid snapshots are rejected
+  EXPECT_THROW(wrenchDist->restore(nullptr), std::runtime_error);
+  auto otherWrenchDist = std::make_shared<ForceColl::WrenchDistribution>(contactList);
+  EXPECT_THROW(otherWrenchDist->restore(snapshot), std::runtime_error);
+  {
+    // The instance constructed at the address of a destroyed one is also another instance
+    std::optional<ForceColl::WrenchDistribution> reusedWrenchDist;
+    reusedWrenchDist.emplace(contactList);
+    auto reusedSnapshot = reusedWrenchDist->snapshot();
+    const auto * address = &*reusedWrenchDist;
+    reusedWrenchDist.emplace(contactList);
+    EXPECT_EQ(&*reusedWrenchDist, address);
+    EXPECT_THROW(reusedWrenchDist->restore(reusedSnapshot), std::runtime_error);
+  }
+  auto mismatchedSnapshot = std::make_shared<ForceColl::WrenchDistribution::Snapshot>(*snapshot);
+  std::swap(mismatchedSnapshot->contactPtrList[0], mismatchedSnapshot->contactPtrList[1]);
+  EXPECT_THROW(wrenchDist->restore(mismatchedSnapshot), std::runtime_error);
+  mismatchedSnapshot->contactPtrList.pop_back();
+  EXPECT_THROW(wrenchDist->restore(mismatchedSnapshot), std::runtime_error);
+  EXPECT_LT((rightFootContact->pose_.translation() - rightFootPose.translation()).norm(), 1e-10);
+}
+
+TEST(TestWrenchDistribution, UpdateLocalVerticesInPlace)
+{
+  double fricCoeff = 0.5;
+  std::vector<Eigen::Vector3d> localVertices = {Eigen::Vector3d(-0.1, -0.1, 0.0), Eigen::Vector3d(-0.1, 0.1, 0.0),
+                                                Eigen::Vector3d(0.1, 0.1, 0.0), Eigen::Vector3d(0.1, -0.1, 0.0)};
+  sva::ForceVecd maxWrench = sva::ForceVecd(Eigen::Vector3d(20.0, 20.0, 20.0), Eigen::Vector3d(50.0, 50.0, 400.0));
+  auto leftFootContact = std::make_shared<ForceColl::SurfaceContact>("LeftFootContact", fricCoeff, localVertices,
+                                                                     sva::PTransformd::Identity(), maxWrench);
+  auto rightFootContact = std::make_shared<ForceColl::SurfaceContact>(
+      "RightFootContact", fricCoeff, localVertices, sva::PTransformd(Eigen::Vector3d(0, -0.3, 0.0)), maxWrench);
+  std::vector<std::shared_ptr<ForceColl::Contact>> contactList = {leftFootContact, rightFootContact};
+
+  sva::ForceVecd desiredTotalWrench =
+      sva::ForceVecd(Eigen::Vector3d(10.0, -20.0, 0.0), Eigen::Vector3d(0.0, 0.0, 500.0));
+  auto wrenchDist = std::make_shared<ForceColl::WrenchDistribution>(
+      contactList, mc_rtc::Configuration::fromYAMLData("solutionCacheSize: 10"));
+  wrenchDist->run(desiredTotalWrench);
+  wrenchDist->run(desiredTotalWrench);
+  EXPECT_TRUE(wrenchDist->solutionCacheHit_);
+
+  // Shrink the contact region of the left foot
+  for(auto & localVertex : localVertices)
+  {
+    localVertex *= 0.5;
+  }
+  leftFootContact->updateLocalVerticesInPlace(localVertices);
+  leftFootContact->updateGlobalVertices(leftFootContact->pose_);
+  sva::ForceVecd resultTotalWrench = wrenchDist->run(desiredTotalWrench);
+  EXPECT_FALSE(wrenchDist->solutionCacheHit_);
+
+  // The result is the same as the distribution constructed with the updated contacts
+  auto newLeftFootContact = std::make_shared<ForceColl::SurfaceContact>("LeftFootContact", fricCoeff, localVertices,
+                                                                        sva::PTransformd::Identity(), maxWrench);
+  auto newWrenchDist = std::make_shared<ForceColl::WrenchDistribution>(
+      std::vector<std::shared_ptr<ForceColl::Contact>>{newLeftFootContact, rightFootContact});
+  sva::ForceVecd newResultTotalWrench = newWrenchDist->run(desiredTotalWrench);
+  EXPECT_LT((wrenchDist->qpCoeff_.ineq_mat_ - newWrenchDist->qpCoeff_.ineq_mat_).norm(), 1e-10);
+  EXPECT_LT((resultTotalWrench - newResultTotalWrench).vector().norm(), 1e-6)
+      << "resultTotalWrench: " << resultTotalWrench << std::endl
+      << "newResultTotalWrench: " << newResultTotalWrench << std::endl;
+  EXPECT_LT((wrenchDist->resultWrenchRatio_ - newWrenchDist->resultWrenchRatio_).norm(), 1e-6);
+}
+
 int main(int argc, char ** argv)
 {
   testing::InitGoogleTest(&argc, argv);
@@ -0,0 +1,66 @@
+#include <gtest/gtest.h>
+
+#include <ForceColl/WrenchDistributionGUI.h>
+
+/** \brief Class to access the markers. */
+class WrenchDistributionGUIAccessor : public ForceColl::WrenchDistributionGUI
+{
+public:
+  using ForceColl::WrenchDistributionGUI::WrenchDistributionGUI;
+
+  inline const Eigen::Vector3d & arrowEnd(size_t contactIdx, size_t vertexIdx) const
+  {
+    return contactMarkerList_[contactIdx].vertexMarkerList[vertexIdx].arrowEnd;
+  }
+};
+
+TEST(TestWrenchDistributionGUI, DecimatedUpdate)
+{
+  double fricCoeff = 0.5;
+  auto leftFootContact = std::make_shared<ForceColl::SurfaceContact>(
+      "LeftFootContact", fricCoeff,
+      std::vector<Eigen::Vector3d>{Eigen::Vector3d(-0.1, -0.1, 0.0), Eigen::Vector3d(-0.1, 0.1, 0.0),
+                                   Eigen::Vector3d(0.1, 0.0, 0.0)},
+      sva::PTransformd::Identity());
+  auto rightFootContact = std::make_shared<ForceColl::SurfaceContact>(
+      "RightFootContact", fricCoeff, std::vector<Eigen::Vector3d>{Eigen::Vector3d::Zero()},
+      sva::PTransformd(Eigen::Vector3d(0, -0.5, 0.0)));
+  std::vector<std::shared_ptr<ForceColl::Contact>> contactList = {leftFootContact, rightFootContact};
+  auto wrenchDist = std::make_shared<ForceColl::WrenchDistribution>(contactList);
+
+  mc_rtc::gui::StateBuilder gui;
+  const std::vector<std::string> category = {"WrenchDistribution"};
+  auto guiConfig = mc_rtc::Configuration::fromYAMLData("updateDecimation: 3");
+  {
+    WrenchDistributionGUIAccessor wrenchDistGui(wrenchDist, gui, category, guiConfig);
+    EXPECT_TRUE(gui.hasElement(category, "LeftFootContact_Force2"));
+    EXPECT_TRUE(gui.hasElement(category, "LeftFootContact_FricPyramid0"));
+    EXPECT_TRUE(gui.hasElement(category, "RightFootContact_SurfaceRegion"));
+
+    wrenchDist->run(sva::ForceVecd(Eigen::Vector3d::Zero(), Eigen::Vector3d(0.0, 0.0, 500.0)));
+    Eigen::Vector3d arrowEnd = wrenchDistGui.arrowEnd(1, 0);
+
+    // The markers are refreshed once in three calls
+    wrenchDistGui.update();
+    wrenchDistGui.update();
+    EXPECT_LT((wrenchDistGui.arrowEnd(1, 0) - arrowEnd).norm(), 1e-10);
+    wrenchDistGui.update();
+    EXPECT_GT(wrenchDistGui.arrowEnd(1, 0).z(), arrowEnd.z() + 1e-3);
+    gui.update();
+
+    // The elements are registered again when the contacts are changed
+    wrenchDist->contactList_.pop_back();
+    wrenchDist->run(sva::ForceVecd(Eigen::Vector3d::Zero(), Eigen::Vector3d(0.0, 0.0, 500.0)));
+    wrenchDistGui.refresh();
+    EXPECT_TRUE(gui.hasElement(category, "LeftFootContact_Force0"));
+    EXPECT_FALSE(gui.hasElement(category, "RightFootContact_Force0"));
+    gui.update();
+  }
+  EXPECT_FALSE(gui.hasElement(category, "LeftFootContact_Force0"));
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+
+#include <ForceColl/WrenchDistributionLog.h>
+
+#include <cstdio>
+
+TEST(TestWrenchDistributionLog, RecordAndReplay)
+{
+  double fricCoeff = 0.5;
+  auto leftFootContact = std::make_shared<ForceColl::SurfaceContact>(
+      "LeftFootContact", fricCoeff,
+      std::vector<Eigen::Vector3d>{Eigen::Vector3d(-0.1, -0.1, 0.0), Eigen::Vector3d(-0.1, 0.1, 0.0),
+                                   Eigen::Vector3d(0.1, 0.0, 0.0)},
+      sva::PTransformd::Identity());
+  auto rightFootContact = std::make_shared<ForceColl::SurfaceContact>(
+      "RightFootContact", fricCoeff, std::vector<Eigen::Vector3d>{Eigen::Vector3d::Zero()},
+      sva::PTransformd(Eigen::Vector3d(0, -0.5, 0.0)));
+  auto handContact = std::make_shared<ForceColl::GraspContact>(
+      "HandContact", 0.8,
+      std::vector<sva::PTransformd>{sva::PTransformd(sva::RotX(M_PI / 2), Eigen::Vector3d(0, 0.05, 0)),
+                                    sva::PTransformd(sva::RotX(-M_PI / 2), Eigen::Vector3d(0, -0.05, 0))},
+      sva::PTransformd(Eigen::Vector3d(0.3, 0, 1.0)),
+      sva::ForceVecd(Eigen::Vector3d::Constant(100), Eigen::Vector3d::Constant(500)));
+  std::vector<std::shared_ptr<ForceColl::Contact>> contactList = {leftFootContact, rightFootContact};
+
+  const std::string path = "/tmp/TestWrenchDistributionLog.log";
+  auto wrenchDistConfig = mc_rtc::Configuration::fromYAMLData("regularWeight: 1e-6");
+  auto wrenchDist = std::make_shared<ForceColl::WrenchDistribution>(contactList, wrenchDistConfig);
+  std::vector<sva::ForceVecd> desiredTotalWrenchList;
+  std::vector<Eigen::VectorXd> resultWrenchRatioList;
+  {
+    ForceColl::WrenchDistributionRecorder recorder(path);
+    for(int i = 0; i < 10; i++)
+    {
+      if(i == 5)
+      {
+        wrenchDist = std::make_shared<ForceColl::WrenchDistribution>(
+            std::vector<std::shared_ptr<ForceColl::Contact>>{leftFootContact, rightFootContact, handContact},
+            wrenchDistConfig);
+      }
+      else if(i == 8)
+      {
+        handContact->maxWrench_ = sva::ForceVecd(Eigen::Vector3d::Constant(50), Eigen::Vector3d::Constant(200));
+      }
+      leftFootContact->updateGlobalVertices(sva::PTransformd(Eigen::Vector3d(0.01 * i, 0, 0)));
+      desiredTotalWrenchList.emplace_back(Eigen::Vector3d(0, 5.0 * i, 0), Eigen::Vector3d(0, 0, 500 + 10 * i));
+      recorder.runAndRecord(*wrenchDist, desiredTotalWrenchList.back(), Eigen::Vector3d(0, 0, 0.1 * i));
+      resultWrenchRatioList.push_back(wrenchDist->resultWrenchRatio_);
+    }
+    EXPECT_EQ(recorder.runNum(), 10);
+  }
+
+  ForceColl::WrenchDistributionLogReader logReader(path);
+  std::shared_ptr<ForceColl::WrenchDistribution> replayWrenchDist;
+  size_t frameIdx = 0;
+  while(auto frame = logReader.next())
+  {
+    EXPECT_EQ(frame->setupIdx, frameIdx < 5 ? 0 : (frameIdx < 8 ? 1 : 2));
+    ASSERT_EQ(frame->contactList->size(), frameIdx < 5 ? 2 : 3);
+    EXPECT_LT((frame->desiredTotalWrench - desiredTotalWrenchList[frameIdx]).vector().norm(), 1e-12);
+    EXPECT_LT((frame->momentOrigin - Eigen::Vector3d(0, 0, 0.1 * static_cast<double>(frameIdx))).norm(), 1e-12);
+    EXPECT_LT((frame->resultWrenchRatio - resultWrenchRatioList[frameIdx]).norm(), 1e-12);
+    EXPECT_GT(frame->computationTime, 0);
+
+    // The configuration of the wrench distribution is recorded
+    EXPECT_EQ(static_cast<double>((*frame->config)("regularWeight")), 1e-6);
+    EXPECT_EQ(static_cast<std::string>((*frame->config)("formulation")), "Ridge");
+    EXPECT_EQ(static_cast<std::string>((*frame->config)("qpSolverType")), std::to_string(wrenchDist->qpSolverType()));
+
+    // Replaying the frame reproduces the recorded result
+    replayWrenchDist = std::make_shared<ForceColl::WrenchDistribution>(frame->makeContactList(), *frame->config);
+    replayWrenchDist->run(frame->desiredTotalWrench, frame->momentOrigin);
+    EXPECT_LT((replayWrenchDist->resultWrenchRatio_ - frame->resultWrenchRatio).norm(), 1e-6);
+    frameIdx++;
+  }
+  EXPECT_EQ(frameIdx, 10);
+  ASSERT_TRUE(replayWrenchDist->contactList_[2]->maxWrench_.has_value());
+  EXPECT_LT(
+      (replayWrenchDist->contactList_[2]->maxWrench_->vector() - handContact->maxWrench_->vector()).norm(), 1e-12);
+  EXPECT_EQ(replayWrenchDist->config().regularWeight, 1e-6);
+
+  std::remove(path.c_str());
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
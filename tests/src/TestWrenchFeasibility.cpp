@@ -0,0 +1,70 @@
+#include <gtest/gtest.h>
+
+#include <ForceColl/WrenchDistribution.h>
+#include <ForceColl/WrenchFeasibility.h>
+
+TEST(TestWrenchFeasibility, TwoSurfaceContact)
+{
+  double fricCoeff = 0.5;
+  auto leftFootContact = std::make_shared<ForceColl::SurfaceContact>(
+      "LeftFootContact", fricCoeff,
+      std::vector<Eigen::Vector3d>{Eigen::Vector3d(-0.1, -0.05, 0.0), Eigen::Vector3d(-0.1, 0.05, 0.0),
+                                   Eigen::Vector3d(0.1, 0.05, 0.0), Eigen::Vector3d(0.1, -0.05, 0.0)},
+      sva::PTransformd(Eigen::Vector3d(0, 0.1, 0)));
+  auto rightFootContact = std::make_shared<ForceColl::SurfaceContact>(
+      "RightFootContact", fricCoeff,
+      std::vector<Eigen::Vector3d>{Eigen::Vector3d(-0.1, -0.05, 0.0), Eigen::Vector3d(-0.1, 0.05, 0.0),
+                                   Eigen::Vector3d(0.1, 0.05, 0.0), Eigen::Vector3d(0.1, -0.05, 0.0)},
+      sva::PTransformd(sva::RotZ(0.3), Eigen::Vector3d(0.1, -0.1, 0)));
+  std::vector<std::shared_ptr<ForceColl::Contact>> contactList = {leftFootContact, rightFootContact};
+
+  ForceColl::WrenchFeasibility wrenchFeas(contactList);
+  auto wrenchDist = std::make_shared<ForceColl::WrenchDistribution>(
+      contactList, mc_rtc::Configuration::fromYAMLData("ridgeForceMinMax: [0.0, 1e6]"));
+
+  Eigen::Vector3d momentOrigin(0.0, 0.0, 0.8);
+  sva::ForceVecd gravityWrench(Eigen::Vector3d::Zero(), Eigen::Vector3d(0, 0, 500));
+  EXPECT_TRUE(wrenchFeas.isFeasible(gravityWrench, momentOrigin));
+  EXPECT_FALSE(wrenchFeas.isFeasible(-1 * gravityWrench, momentOrigin));
+  EXPECT_FALSE(
+      wrenchFeas.isFeasible(sva::ForceVecd(Eigen::Vector3d::Zero(), Eigen::Vector3d(400, 0, 500)), momentOrigin));
+
+  // Compare with wrench distribution
+  int feasibleNum = 0;
+  for(int i = 0; i < 100; i++)
+  {
+    sva::ForceVecd desiredTotalWrench(Eigen::Vector3d::Random() * 100.0,
+                                      Eigen::Vector3d::Random() * 200.0 + Eigen::Vector3d(0, 0, 500));
+    double margin = wrenchFeas.calcMargin(desiredTotalWrench, momentOrigin);
+    double error = (desiredTotalWrench - wrenchDist->run(desiredTotalWrench, momentOrigin)).vector().norm();
+    if(margin > 1e-2)
+    {
+      feasibleNum++;
+      EXPECT_LT(error, 1e-2) << "margin: " << margin;
+    }
+    else if(margin < -1e-2)
+    {
+      EXPECT_GT(error, 1e-4) << "margin: " << margin;
+    }
+  }
+  EXPECT_GT(feasibleNum, 0);
+}
+
+TEST(TestWrenchFeasibility, RidgeForceMin)
+{
+  auto contact = std::make_shared<ForceColl::SurfaceContact>(
+      "Contact", 0.5, std::vector<Eigen::Vector3d>{Eigen::Vector3d::Zero()}, sva::PTransformd::Identity());
+  ForceColl::WrenchFeasibility wrenchFeas({contact}, 10.0);
+
+  // Four ridges with the minimum force generate the normal force of 40 / sqrt(1.25)
+  double minNormalForce = 40.0 / std::sqrt(1.25);
+  EXPECT_TRUE(wrenchFeas.isFeasible(sva::ForceVecd(Eigen::Vector3d::Zero(), Eigen::Vector3d(0, 0, minNormalForce))));
+  EXPECT_FALSE(
+      wrenchFeas.isFeasible(sva::ForceVecd(Eigen::Vector3d::Zero(), Eigen::Vector3d(0, 0, minNormalForce - 1.0))));
+}
+
+int main(int argc, char ** argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}